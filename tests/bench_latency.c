@@ -0,0 +1,298 @@
+/*
+ * xtrxdsp per call latency benchmark
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+
+#include <xtrxdsp.h>
+#include <xtrxdsp_filters.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_TSC 1
+#else
+#define HAS_TSC 0
+#endif
+
+/*
+ * Times every single call of the public entry points on small blocks and
+ * reports latency percentiles. Warm runs call back to back on the same
+ * buffers, cold runs evict the caches by writing a large buffer before
+ * each call. Sizes are in complex samples.
+ */
+
+#define MAX_SAMPLES 1024
+#define HIST_BUCKETS 32
+
+typedef void (*lat_call_t)(uint8_t* in, uint8_t* out, uint8_t* out2, size_t n);
+
+typedef struct lat_kernel {
+	const char* name;
+	lat_call_t call;
+} lat_kernel_t;
+
+static xtrxdsp_filter_state_t s_filter;
+static xtrxdsp_filter_state_t s_filteri;
+
+#define CALL(name, expr) \
+	static void call_##name(uint8_t* in, uint8_t* out, uint8_t* out2, size_t n) \
+	{ (void)out2; expr; }
+
+CALL(filter_work,  xtrxdsp_filter_work(&s_filter, (float*)in, (float*)out, 2 * n))
+CALL(filter_worki, xtrxdsp_filter_worki(&s_filteri, (int16_t*)in, (int16_t*)out, 2 * n))
+CALL(iq16_sc32,    xtrxdsp_iq16_sc32((int16_t*)in, (float*)out, 1.0f/32768, 4 * n))
+CALL(iq12_sc32,    xtrxdsp_iq12_sc32(in, (float*)out, 3 * n, 0))
+CALL(iq8_sc32,     xtrxdsp_iq8_sc32((int8_t*)in, (float*)out, 2 * n))
+CALL(iq16_sc32i,   xtrxdsp_iq16_sc32i((int16_t*)in, (float*)out, (float*)out2, 1.0f/32768, 4 * n))
+CALL(sc32_iq16,    xtrxdsp_sc32_iq16((float*)in, (int16_t*)out, 32767, 4 * n))
+CALL(sc32i_iq16,   xtrxdsp_sc32i_iq16((float*)in, (float*)in + n, (int16_t*)out, 32767, 4 * n))
+
+#define K(name) { #name, call_##name }
+
+static const lat_kernel_t s_kernels[] = {
+	K(filter_work),
+	K(filter_worki),
+	K(iq16_sc32),
+	K(iq12_sc32),
+	K(iq8_sc32),
+	K(iq16_sc32i),
+	K(sc32_iq16),
+	K(sc32i_iq16),
+};
+
+static const size_t s_sizes[] = { 64, 128, 256, 512, 1024 };
+
+static double get_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ticks per nanosecond of get_ticks() */
+static double s_tick_ns = 1.0;
+
+static inline uint64_t get_ticks(void)
+{
+#if HAS_TSC
+	unsigned aux;
+	uint64_t t = __rdtscp(&aux);
+
+	/* rdtscp waits for the kernel to retire, the fence keeps later
+	 * instructions from starting before the read */
+	_mm_lfence();
+	return t;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static void calibrate_ticks(void)
+{
+#if HAS_TSC
+	double t0 = get_time(), t;
+	uint64_t c0 = get_ticks();
+
+	while ((t = get_time()) - t0 < 0.05)
+		;
+	s_tick_ns = (get_ticks() - c0) / ((t - t0) * 1e9);
+#endif
+}
+
+/* writes the whole buffer so nothing of the kernel data stays cached */
+static void evict(uint8_t* buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i += 64)
+		buf[i]++;
+}
+
+static int cmp_u64(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static double pct(const uint64_t* sorted, unsigned cnt, double p)
+{
+	unsigned idx = (unsigned)(p * (cnt - 1) + 0.5);
+	return sorted[idx] / s_tick_ns;
+}
+
+static void print_hist(const uint64_t* sorted, unsigned cnt)
+{
+	unsigned hist[HIST_BUCKETS] = { 0 };
+	unsigned i, b, lo = HIST_BUCKETS, hi = 0;
+	double ns;
+
+	/* power of two buckets in nanoseconds */
+	for (i = 0; i < cnt; i++) {
+		ns = sorted[i] / s_tick_ns;
+		for (b = 0; b < HIST_BUCKETS - 1 && ns >= (double)(2U << b); b++)
+			;
+		hist[b]++;
+		if (b < lo) lo = b;
+		if (b > hi) hi = b;
+	}
+
+	for (b = lo; b <= hi; b++) {
+		printf("    < %10u ns %8u ", 2U << b, hist[b]);
+		for (i = 0; i < (hist[b] * 60 + cnt - 1) / cnt; i++)
+			putchar('#');
+		putchar('\n');
+	}
+}
+
+static void bench(const lat_kernel_t* k, size_t n, int cold, unsigned iters, int hist,
+				  uint8_t* in, uint8_t* out, uint8_t* out2,
+				  uint8_t* ebuf, size_t esize, uint64_t* lat)
+{
+	unsigned i;
+	uint64_t c0;
+
+	/* page in buffers and bind lazy symbols */
+	k->call(in, out, out2, n);
+
+	for (i = 0; i < iters; i++) {
+		if (cold)
+			evict(ebuf, esize);
+
+		c0 = get_ticks();
+		k->call(in, out, out2, n);
+		lat[i] = get_ticks() - c0;
+	}
+
+	qsort(lat, iters, sizeof(lat[0]), cmp_u64);
+	printf("%-14s %-4s %7u %9.0f %9.0f %9.0f %9.0f %9.0f\n",
+		   k->name, cold ? "cold" : "warm", (unsigned)n,
+		   pct(lat, iters, 0), pct(lat, iters, 0.5), pct(lat, iters, 0.99),
+		   pct(lat, iters, 0.999), pct(lat, iters, 1));
+
+	if (hist)
+		print_hist(lat, iters);
+}
+
+static void usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [-c cpu] [-n warm_iters] [-N cold_iters] [-e evict_mb] [-H] [kernel_substring ...]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned warm_iters = 100000;
+	unsigned cold_iters = 1000;
+	size_t esize = 32 << 20;
+	int cpu = -1, hist = 0;
+	unsigned k, s, i, c;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "c:n:N:e:Hh")) != -1) {
+		switch (opt) {
+		case 'c': cpu = atoi(optarg); break;
+		case 'n': warm_iters = strtoul(optarg, NULL, 10); break;
+		case 'N': cold_iters = strtoul(optarg, NULL, 10); break;
+		case 'e': esize = strtoul(optarg, NULL, 10) << 20; break;
+		case 'H': hist = 1; break;
+		default: usage(argv[0]); return 1;
+		}
+	}
+
+	/* percentiles index the sorted latencies, at least one is needed */
+	if (warm_iters == 0 || cold_iters == 0) {
+		fprintf(stderr, "Iteration counts must be non-zero\n");
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (cpu >= 0) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+			perror("Unable to pin to the CPU");
+			return 2;
+		}
+	}
+
+	unsigned max_iters = (warm_iters > cold_iters) ? warm_iters : cold_iters;
+	uint8_t* in = (uint8_t*)xtrxdsp_aligned_alloc(16 * MAX_SAMPLES);
+	uint8_t* out = (uint8_t*)xtrxdsp_aligned_alloc(16 * MAX_SAMPLES);
+	uint8_t* out2 = (uint8_t*)xtrxdsp_aligned_alloc(16 * MAX_SAMPLES);
+	uint8_t* ebuf = (uint8_t*)xtrxdsp_aligned_alloc(esize);
+	uint64_t* lat = (uint64_t*)malloc(sizeof(uint64_t) * max_iters);
+	if (!in || !out || !out2 || !ebuf || !lat) {
+		fprintf(stderr, "Unable to allocate buffers\n");
+		return 2;
+	}
+
+	/* valid floats for float inputs, any bit pattern is fine for integer ones */
+	for (i = 0; i < 4 * MAX_SAMPLES; i++)
+		((float*)in)[i] = 0.9f * (i % 1000) / 1000.0f;
+	memset(out, 0, 16 * MAX_SAMPLES);
+	memset(out2, 0, 16 * MAX_SAMPLES);
+	memset(ebuf, 0, esize);
+
+	if (xtrxdsp_filter_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, 0, MAX_SAMPLES * 2, &s_filter) ||
+			xtrxdsp_filter_initi(g_filter_int16_taps_64_2x, FILTER_TAPS_64, 1, 0, MAX_SAMPLES * 2, &s_filteri)) {
+		fprintf(stderr, "Unable to initialize filters\n");
+		return 2;
+	}
+
+	calibrate_ticks();
+	printf("CPU %d, %.3f ticks/ns, %u warm / %u cold calls, %u MB evicted\n",
+		   cpu, s_tick_ns, warm_iters, cold_iters, (unsigned)(esize >> 20));
+	printf("%-14s %-4s %7s %9s %9s %9s %9s %9s\n",
+		   "kernel", "run", "samples", "min ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+	for (k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++) {
+		const lat_kernel_t* kern = &s_kernels[k];
+		if (optind < argc) {
+			int match = 0;
+			for (i = optind; i < (unsigned)argc; i++)
+				match |= (strstr(kern->name, argv[i]) != NULL);
+			if (!match)
+				continue;
+		}
+
+		for (s = 0; s < sizeof(s_sizes) / sizeof(s_sizes[0]); s++) {
+			for (c = 0; c < 2; c++) {
+				bench(kern, s_sizes[s], c, c ? cold_iters : warm_iters,
+					  hist, in, out, out2, ebuf, esize, lat);
+			}
+		}
+	}
+
+	xtrxdsp_filter_free(&s_filter);
+	xtrxdsp_filter_free(&s_filteri);
+	xtrxdsp_aligned_free(in);
+	xtrxdsp_aligned_free(out);
+	xtrxdsp_aligned_free(out2);
+	xtrxdsp_aligned_free(ebuf);
+	free(lat);
+	return 0;
+}
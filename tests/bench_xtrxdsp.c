@@ -0,0 +1,381 @@
+/*
+ * xtrxdsp per kernel benchmark
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+
+#include <xtrxdsp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define HAS_TSC 1
+#else
+#define HAS_TSC 0
+#endif
+
+/*
+ * Every variant of every kernel is called directly, bypassing the dispatcher.
+ * Sizes are in complex samples, the call wrappers below translate them into
+ * the byte / sample counts each kernel expects.
+ */
+
+enum variant {
+	V_NO,
+	V_SSE2,
+	V_AVX,
+	V_AVX_FMA,
+	V_AVX_F16C,
+	V_COUNT
+};
+
+static const char* s_variant_names[V_COUNT] = { "no", "sse2", "avx", "avx_fma", "avx_f16c" };
+
+typedef void (*bench_call_t)(void* fn, uint8_t* in, uint8_t* out, uint8_t* out2, size_t n);
+
+typedef struct bench_kernel {
+	const char* name;
+	bench_call_t call;
+	unsigned in_bytes;  // Bytes per complex sample read
+	unsigned out_bytes; // Bytes per complex sample written
+	void* fn[V_COUNT];
+} bench_kernel_t;
+
+#define NWAY_CHANS 4
+
+static xtrxdsp_iqcorr_t s_corr = { 1.0f/32768, 0, 0, 1.0f/32768, 0, 0, 0, 1, 1 };
+static xtrxdsp_iqcorr_t s_swap = { 1, 0, 0, 1, 0, 0, XTRXDSP_IQCORR_SWAP_IQ, 1, 1 };
+static xtrxdsp_iqcorr_stat_t s_stat;
+static xtrxdsp_meter_t s_meter;
+
+#define CALL(name, expr) \
+	static void call_##name(void* fn, uint8_t* in, uint8_t* out, uint8_t* out2, size_t n) \
+	{ __typeof__(&xtrxdsp_##name##_no) f = (__typeof__(f))fn; (void)out2; expr; }
+
+CALL(iq16_sc32,       f((int16_t*)in, (float*)out, 1.0f/32768, 4 * n))
+CALL(iq12_sc32,       f(in, (float*)out, 3 * n, 0))
+CALL(iq8_sc32,        f((int8_t*)in, (float*)out, 2 * n))
+CALL(iq8_ic16,        f((int8_t*)in, (int16_t*)out, 2 * n))
+CALL(iq16_sc32i,      f((int16_t*)in, (float*)out, (float*)out2, 1.0f/32768, 4 * n))
+CALL(iq16_ic16i,      f((int16_t*)in, (int16_t*)out, (int16_t*)out2, 4 * n))
+CALL(iq12_sc32i,      f(in, (float*)out, (float*)out2, 3 * n, 0))
+CALL(iq8_sc32i,       f((int8_t*)in, (float*)out, (float*)out2, 2 * n))
+CALL(iq8_ic16i,       f((int8_t*)in, (int16_t*)out, (int16_t*)out2, 2 * n))
+CALL(iq8_ic8i,        f((int8_t*)in, (int8_t*)out, (int8_t*)out2, 2 * n))
+CALL(sc32_iq16,       f((float*)in, (int16_t*)out, 32767, 4 * n))
+CALL(sc32i_iq16,      f((float*)in, (float*)in + n, (int16_t*)out, 32767, 4 * n))
+CALL(ic16i_iq16,      f((int16_t*)in, (int16_t*)in + n, (int16_t*)out, 4 * n))
+CALL(iq16_sc32_corr,  f((int16_t*)in, (float*)out, &s_corr, &s_stat, 4 * n))
+CALL(iq12_sc32_corr,  f(in, (float*)out, &s_corr, &s_stat, 3 * n, 0))
+CALL(iq16_sc32i_corr, f((int16_t*)in, (float*)out, (float*)out2, &s_corr, &s_stat, 4 * n))
+CALL(sc32_fixup,      f((float*)out, &s_swap, 8 * n))
+CALL(ic16_fixup,      f((int16_t*)out, &s_swap, 4 * n))
+CALL(iq16_sc32_meter, f((int16_t*)in, (float*)out, 1.0f/32768, &s_meter, 4 * n))
+CALL(iq12_sc32_meter, f(in, (float*)out, &s_meter, 3 * n, 0))
+CALL(iq8_sc32_meter,  f((int8_t*)in, (float*)out, &s_meter, 2 * n))
+CALL(iq8_ic16_meter,  f((int8_t*)in, (int16_t*)out, &s_meter, 2 * n))
+CALL(iq16_sc32i_meter, f((int16_t*)in, (float*)out, (float*)out2, 1.0f/32768, &s_meter, 4 * n))
+CALL(iq16_ic16i_meter, f((int16_t*)in, (int16_t*)out, (int16_t*)out2, &s_meter, 4 * n))
+CALL(iq12_sc32i_meter, f(in, (float*)out, (float*)out2, &s_meter, 3 * n, 0))
+CALL(iq8_sc32i_meter, f((int8_t*)in, (float*)out, (float*)out2, &s_meter, 2 * n))
+CALL(iq8_ic16i_meter, f((int8_t*)in, (int16_t*)out, (int16_t*)out2, &s_meter, 2 * n))
+CALL(iq16_hc16,       f((int16_t*)in, (uint16_t*)out, 1.0f/32768, 4 * n))
+CALL(iq16_bf16,       f((int16_t*)in, (uint16_t*)out, 1.0f/32768, 4 * n))
+CALL(hc16_iq16,       f((uint16_t*)in, (int16_t*)out, 32767, 4 * n))
+CALL(bf16_iq16,       f((uint16_t*)in, (int16_t*)out, 32767, 4 * n))
+CALL(iq16_sc64,       f((int16_t*)in, (double*)out, 1.0/32768, 4 * n))
+CALL(iq12_sc64,       f(in, (double*)out, 3 * n, 0))
+CALL(sc64_iq16,       f((double*)in, (int16_t*)out, 32767, 4 * n))
+CALL(iq16_sc32_nt,    f((int16_t*)in, (float*)out, 1.0f/32768, 4 * n))
+CALL(iq16_sc32i_nt,   f((int16_t*)in, (float*)out, (float*)out2, 1.0f/32768, 4 * n))
+CALL(sc32_iq16_nt,    f((float*)in, (int16_t*)out, 32767, 4 * n))
+CALL(iq12_sc32_nt,    f(in, (float*)out, 3 * n, 0))
+CALL(iq8_sc32_nt,     f((int8_t*)in, (float*)out, 2 * n))
+/* in-place kernels run over their own output, data isn't meaningful */
+CALL(iq16_ic16i_ip,   f((int16_t*)out, (int16_t*)out2, 4 * n))
+CALL(iq8_ic8i_ip,     f((int8_t*)out, (int8_t*)out2, 2 * n))
+CALL(ic16i_iq16_ip,   f((int16_t*)out, (int16_t*)in, 4 * n))
+CALL(sc32_iq16_ip,    f(out, 32767, 4 * n))
+CALL(iq16_sc32_ip,    f(out, 1.0f/32768, 4 * n))
+CALL(iq8_sc32_ip,     f(out, 2 * n))
+CALL(iq8_ic16_ip,     f(out, 2 * n))
+CALL(iq16_sc32n, {
+	float* o[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) o[c] = (float*)out + 2 * c * (n / NWAY_CHANS);
+	f((int16_t*)in, o, NWAY_CHANS, 1.0f/32768, 4 * n); })
+CALL(iq16_ic16n, {
+	int16_t* o[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) o[c] = (int16_t*)out + 2 * c * (n / NWAY_CHANS);
+	f((int16_t*)in, o, NWAY_CHANS, 4 * n); })
+CALL(iq12_sc32n, {
+	float* o[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) o[c] = (float*)out + 2 * c * (n / NWAY_CHANS);
+	f(in, o, NWAY_CHANS, 3 * n); })
+CALL(iq8_sc32n, {
+	float* o[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) o[c] = (float*)out + 2 * c * (n / NWAY_CHANS);
+	f((int8_t*)in, o, NWAY_CHANS, 2 * n); })
+CALL(iq8_ic16n, {
+	int16_t* o[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) o[c] = (int16_t*)out + 2 * c * (n / NWAY_CHANS);
+	f((int8_t*)in, o, NWAY_CHANS, 2 * n); })
+CALL(sc32n_iq16, {
+	const float* i[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) i[c] = (float*)in + 2 * c * (n / NWAY_CHANS);
+	f(i, NWAY_CHANS, (int16_t*)out, 32767, 4 * n); })
+CALL(ic16n_iq16, {
+	const int16_t* i[NWAY_CHANS];
+	for (unsigned c = 0; c < NWAY_CHANS; c++) i[c] = (int16_t*)in + 2 * c * (n / NWAY_CHANS);
+	f(i, NWAY_CHANS, (int16_t*)out, 4 * n); })
+
+/* filter kernels, taps live in out2 which is aligned as conv64 requires */
+#define CALL_FILTER(name, expr) \
+	static void call_##name(void* fn, uint8_t* in, uint8_t* out, uint8_t* out2, size_t n) \
+	{ __typeof__(&xtrxdsp_##name##_no) f = (__typeof__(f))fn; expr; }
+
+CALL_FILTER(sc32_conv64,  f((float*)in, (float*)out2, (float*)out, 2 * n, 0))
+CALL_FILTER(iq16_conv64,  f((int16_t*)in, (int16_t*)out2, (int16_t*)out, 2 * n, 0))
+CALL_FILTER(sc32_nco,     f((float*)in, (float*)out, n, 0, 0x1234567))
+CALL_FILTER(ic16_nco,     f((int16_t*)in, (int16_t*)out, n, 0, 0x1234567))
+CALL_FILTER(sc32_nco_iq16, f((float*)in, (int16_t*)out, n, 32767, 0, 0x1234567))
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VARIANTS(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx }
+#ifdef XTRXDSP_HAS__F16C__
+#define VARIANTS_F16C(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx, NULL, (void*)xtrxdsp_##name##_avx_f16c }
+#else
+#define VARIANTS_F16C(name) VARIANTS(name)
+#endif
+#ifdef XTRXDSP_HAS__FMA__
+#define VARIANTS_FMA(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx, (void*)xtrxdsp_##name##_avx_fma }
+#else
+#define VARIANTS_FMA(name) VARIANTS(name)
+#endif
+#else
+#define VARIANTS(name) { (void*)xtrxdsp_##name##_no }
+#define VARIANTS_F16C(name) VARIANTS(name)
+#define VARIANTS_FMA(name) VARIANTS(name)
+#endif
+
+#define K(name, ib, ob)      { #name, call_##name, ib, ob, VARIANTS(name) }
+#define K_F16C(name, ib, ob) { #name, call_##name, ib, ob, VARIANTS_F16C(name) }
+#define K_FMA(name, ib, ob)  { #name, call_##name, ib, ob, VARIANTS_FMA(name) }
+
+static const bench_kernel_t s_kernels[] = {
+	K(iq16_sc32, 4, 8),
+	K(iq12_sc32, 3, 8),
+	K(iq8_sc32, 2, 8),
+	K(iq8_ic16, 2, 4),
+	K(iq16_sc32i, 4, 8),
+	K(iq16_ic16i, 4, 4),
+	K(iq12_sc32i, 3, 8),
+	K(iq8_sc32i, 2, 8),
+	K(iq8_ic16i, 2, 4),
+	K(iq8_ic8i, 2, 2),
+	K(sc32_iq16, 8, 4),
+	K(sc32i_iq16, 8, 4),
+	K(ic16i_iq16, 4, 4),
+	K(iq16_sc32_corr, 4, 8),
+	K(iq12_sc32_corr, 3, 8),
+	K(iq16_sc32i_corr, 4, 8),
+	K(sc32_fixup, 8, 8),
+	K(ic16_fixup, 4, 4),
+	K(iq16_sc32_meter, 4, 8),
+	K(iq12_sc32_meter, 3, 8),
+	K(iq8_sc32_meter, 2, 8),
+	K(iq8_ic16_meter, 2, 4),
+	K(iq16_sc32i_meter, 4, 8),
+	K(iq16_ic16i_meter, 4, 4),
+	K(iq12_sc32i_meter, 3, 8),
+	K(iq8_sc32i_meter, 2, 8),
+	K(iq8_ic16i_meter, 2, 4),
+	K_F16C(iq16_hc16, 4, 4),
+	K(iq16_bf16, 4, 4),
+	K_F16C(hc16_iq16, 4, 4),
+	K(bf16_iq16, 4, 4),
+	K(iq16_sc64, 4, 16),
+	K(iq12_sc64, 3, 16),
+	K(sc64_iq16, 16, 4),
+	K(iq16_sc32_nt, 4, 8),
+	K(iq16_sc32i_nt, 4, 8),
+	K(sc32_iq16_nt, 8, 4),
+	K(iq12_sc32_nt, 3, 8),
+	K(iq8_sc32_nt, 2, 8),
+	K(iq16_ic16i_ip, 4, 4),
+	K(iq8_ic8i_ip, 2, 2),
+	K(ic16i_iq16_ip, 4, 4),
+	K(sc32_iq16_ip, 8, 4),
+	K(iq16_sc32_ip, 4, 8),
+	K(iq8_sc32_ip, 2, 8),
+	K(iq8_ic16_ip, 2, 4),
+	K(iq16_sc32n, 4, 8),
+	K(iq16_ic16n, 4, 4),
+	K(iq12_sc32n, 3, 8),
+	K(iq8_sc32n, 2, 8),
+	K(iq8_ic16n, 2, 4),
+	K(sc32n_iq16, 8, 4),
+	K(ic16n_iq16, 4, 4),
+	K_FMA(sc32_conv64, 8, 8),
+	K(iq16_conv64, 4, 4),
+	K(sc32_nco, 8, 8),
+	K(ic16_nco, 4, 4),
+	K(sc32_nco_iq16, 8, 4),
+};
+
+/* from L1 resident to DRAM bound for any kernel */
+static const size_t s_sizes[] = { 256, 4096, 65536, 1048576, 4194304 };
+
+static double get_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t get_tsc(void)
+{
+#if HAS_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int variant_supported(unsigned v)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	switch (v) {
+	case V_SSE2: return __builtin_cpu_supports("sse2");
+	case V_AVX: return __builtin_cpu_supports("avx");
+	case V_AVX_FMA: return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+	case V_AVX_F16C: {
+		unsigned a, b, c, d;
+		return __builtin_cpu_supports("avx") && __get_cpuid(1, &a, &b, &c, &d) && (c & bit_F16C);
+	}
+	}
+#endif
+	return v == V_NO;
+}
+
+static void bench(const bench_kernel_t* k, unsigned v, size_t n, double min_time,
+				  uint8_t* in, uint8_t* out, uint8_t* out2)
+{
+	unsigned iters, i;
+	double t0, t;
+	uint64_t c0, c;
+
+	/* warm up caches and page in buffers */
+	k->call(k->fn[v], in, out, out2, n);
+
+	for (iters = 1; ; iters *= 2) {
+		t0 = get_time();
+		c0 = get_tsc();
+		for (i = 0; i < iters; i++)
+			k->call(k->fn[v], in, out, out2, n);
+		c = get_tsc() - c0;
+		t = get_time() - t0;
+
+		if (t >= min_time)
+			break;
+	}
+
+	double samples = (double)n * iters;
+	printf("%-18s %-9s %9u %10.1f %10.1f %8.3f\n",
+		   k->name, s_variant_names[v], (unsigned)n,
+		   samples / t * 1e-6,
+		   samples * (k->in_bytes + k->out_bytes) / t * 1e-6,
+		   (HAS_TSC) ? c / samples : NAN);
+}
+
+static void usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [-m max_samples] [-t min_ms] [-o out_offset] [kernel_substring ...]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	size_t max_samples = s_sizes[sizeof(s_sizes) / sizeof(s_sizes[0]) - 1];
+	double min_time = 0.05;
+	unsigned out_offset = 0;
+	unsigned k, v, s, i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "m:t:o:h")) != -1) {
+		switch (opt) {
+		case 'm': max_samples = strtoul(optarg, NULL, 10); break;
+		case 't': min_time = atof(optarg) / 1000; break;
+		/* in bytes, misaligns outputs to compare against aligned store paths */
+		case 'o': out_offset = (strtoul(optarg, NULL, 10) % XTRXDSP_ALIGN) & ~3u; break;
+		default: usage(argv[0]); return 1;
+		}
+	}
+
+	/* 16 bytes per sample covers the widest format (sc64) */
+	uint8_t* in = (uint8_t*)xtrxdsp_aligned_alloc(16 * max_samples);
+	uint8_t* out = (uint8_t*)xtrxdsp_aligned_alloc(16 * max_samples + XTRXDSP_ALIGN);
+	uint8_t* out2 = (uint8_t*)xtrxdsp_aligned_alloc(16 * max_samples);
+	if (!in || !out || !out2) {
+		fprintf(stderr, "Unable to allocate buffers for %u samples\n", (unsigned)max_samples);
+		return 2;
+	}
+
+	/* valid floats for float inputs, any bit pattern is fine for integer ones */
+	for (i = 0; i < 4 * max_samples; i++) {
+		((float*)in)[i] = 0.9f * sinf(i * 0.001f);
+		((float*)out)[i] = 0.5f;
+	}
+	memset(out2, 0, 16 * max_samples);
+	/* filter taps */
+	for (i = 0; i < 64; i++)
+		((float*)out2)[i] = 1.0f / 64;
+
+	printf("%-18s %-9s %9s %10s %10s %8s\n",
+		   "kernel", "variant", "samples", "MSps", "MB/s", "cyc/smp");
+
+	for (k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++) {
+		const bench_kernel_t* kern = &s_kernels[k];
+		if (optind < argc) {
+			int match = 0;
+			for (i = optind; i < (unsigned)argc; i++)
+				match |= (strstr(kern->name, argv[i]) != NULL);
+			if (!match)
+				continue;
+		}
+
+		for (s = 0; s < sizeof(s_sizes) / sizeof(s_sizes[0]) && s_sizes[s] <= max_samples; s++) {
+			for (v = 0; v < V_COUNT; v++) {
+				if (kern->fn[v] == NULL || !variant_supported(v))
+					continue;
+
+				bench(kern, v, s_sizes[s], min_time, in, out + out_offset, out2);
+			}
+		}
+	}
+
+	xtrxdsp_aligned_free(in);
+	xtrxdsp_aligned_free(out);
+	xtrxdsp_aligned_free(out2);
+	return 0;
+}
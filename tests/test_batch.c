@@ -0,0 +1,130 @@
+/*
+ * xtrxdsp batched conversion test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xtrxdsp_batch.h>
+
+#define BYTES  24000
+#define CHUNKS 512
+
+static int g_errors = 0;
+
+static uint8_t s_in[BYTES];
+static float s_fin[BYTES / sizeof(float)];
+static float s_ref[BYTES];
+static float s_out[2 * BYTES];
+
+/* chunk sizes are multiples of elem, every third chunk is moved to a gap in
+ * the output so both merged and separate runs are exercised
+ */
+static unsigned make_desc(xtrxdsp_batch_desc_t* desc, const void* in, size_t elem, size_t outnum, size_t outden, int iq12)
+{
+	size_t off = 0, outoff = 0, pending = 0;
+	unsigned n;
+
+	for (n = 0; n < CHUNKS && off < BYTES; n++) {
+		size_t l = elem * (1 + rand() % 200);
+		size_t outsz;
+		if (l > BYTES - off || n == CHUNKS - 1)
+			l = BYTES - off;
+
+		outsz = (iq12) ? 2 * sizeof(float) * ((pending + l) / 3) : l / outden * outnum;
+		pending = (pending + l) % 3;
+		if (n % 3 == 2)
+			outoff += 64;
+
+		desc[n].in = (const uint8_t*)in + off;
+		desc[n].inbytes = l;
+		desc[n].out = (char*)s_out + outoff;
+		off += l;
+		outoff += outsz;
+	}
+	return n;
+}
+
+static void check(const char* name, const xtrxdsp_batch_desc_t* desc, unsigned count, size_t outbytes_total,
+				  size_t outnum, size_t outden, int iq12)
+{
+	size_t pos = 0, pending = 0;
+	unsigned n;
+
+	for (n = 0; n < count; n++) {
+		size_t sz = (iq12) ? 2 * sizeof(float) * ((pending + desc[n].inbytes) / 3) : desc[n].inbytes / outden * outnum;
+		pending = (pending + desc[n].inbytes) % 3;
+
+		if (memcmp(desc[n].out, (char*)s_ref + pos, sz)) {
+			fprintf(stderr, "%s: mismatch in chunk %u!\n", name, n);
+			g_errors++;
+			return;
+		}
+		pos += sz;
+	}
+	if (pos != outbytes_total) {
+		fprintf(stderr, "%s: converted %u bytes, expected %u!\n", name, (unsigned)pos, (unsigned)outbytes_total);
+		g_errors++;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	xtrxdsp_batch_desc_t desc[CHUNKS];
+	unsigned i, count, iter;
+	uint64_t state, ref_state;
+
+	for (i = 0; i < BYTES; i++)
+		s_in[i] = (uint8_t)(i * 40503u >> 3);
+
+	for (i = 0; i < BYTES / sizeof(float); i++)
+		s_fin[i] = (int16_t)(i * 40503u) * (1.0f / 32768);
+
+	for (iter = 0; iter < 20; iter++) {
+		count = make_desc(desc, s_in, 2 * sizeof(int16_t), sizeof(float), sizeof(int16_t), 0);
+		xtrxdsp_iq16_sc32((const int16_t*)s_in, s_ref, 1.0f / 32768, BYTES);
+		xtrxdsp_iq16_sc32_batch(desc, count, 1.0f / 32768);
+		check("iq16_sc32_batch", desc, count, 2 * BYTES, sizeof(float), sizeof(int16_t), 0);
+
+		count = make_desc(desc, s_in, 2 * sizeof(int8_t), sizeof(float), sizeof(int8_t), 0);
+		xtrxdsp_iq8_sc32((const int8_t*)s_in, s_ref, BYTES);
+		xtrxdsp_iq8_sc32_batch(desc, count);
+		check("iq8_sc32_batch", desc, count, 4 * BYTES, sizeof(float), sizeof(int8_t), 0);
+
+		count = make_desc(desc, s_fin, 2 * sizeof(float), sizeof(int16_t), sizeof(float), 0);
+		xtrxdsp_sc32_iq16(s_fin, (int16_t*)s_ref, 32767, BYTES / 2);
+		xtrxdsp_sc32_iq16_batch(desc, count, 32767);
+		check("sc32_iq16_batch", desc, count, BYTES / 2, sizeof(int16_t), sizeof(float), 0);
+
+		/* byte granular chunks split iq12 samples all the time */
+		count = make_desc(desc, s_in, 1, 0, 1, 1);
+		ref_state = xtrxdsp_iq12_sc32(s_in, s_ref, BYTES, 0);
+		state = xtrxdsp_iq12_sc32_batch(desc, count, 0);
+		check("iq12_sc32_batch", desc, count, 2 * sizeof(float) * (BYTES / 3), 0, 1, 1);
+		if (state != ref_state) {
+			fprintf(stderr, "iq12_sc32_batch: state %llx expected %llx!\n",
+					(unsigned long long)state, (unsigned long long)ref_state);
+			g_errors++;
+		}
+	}
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,624 @@
+/*
+ * xtrxdsp cross variant conformance test
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <xtrxdsp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+/*
+ * Every variant of every dispatched kernel is run on the same random input as
+ * the generic one and has to produce the same output within per format
+ * tolerance. Outputs are surrounded by guard bytes to catch tail overruns,
+ * sizes cover all tails of the vector loops and pointers are misaligned by
+ * any multiple of the element size. iq12 kernels carrying state are also
+ * split at every byte position and stitched back.
+ */
+
+enum variant {
+	V_NO,
+	V_SSE2,
+	V_AVX,
+	V_AVX_FMA,
+	V_AVX_F16C,
+	V_COUNT
+};
+
+static const char* s_variant_names[V_COUNT] = { "no", "sse2", "avx", "avx_fma", "avx_f16c" };
+
+/* element formats of inputs and outputs */
+enum fmt {
+	F_I8,
+	F_I16,
+	F_U8,   // raw bytes, i.e. iq12 stream
+	F_H16,  // IEEE half
+	F_BF16,
+	F_F32,
+	F_F64,
+};
+
+static const unsigned s_fmt_size[] = { 1, 2, 1, 2, 2, 4, 8 };
+
+#define MAX_REGIONS  8
+#define GUARD        64
+#define GUARD_BYTE   0xa5
+#define MAX_SAMPLES  4200
+#define MAX_OFFSET   32
+
+/* kernel flags */
+#define K_STATE   1  // iq12 carry state, test split points
+#define K_ALIGNED 2  // no misalignment for inputs
+#define K_METER   4  // compare meter results
+#define K_SPARSE  8  // not all of the outputs are written
+
+struct conf_kernel;
+typedef uint64_t (*conf_call_t)(const struct conf_kernel* k, void* fn,
+								uint8_t* const* in, uint8_t* const* out,
+								size_t bytes, uint64_t state);
+
+typedef struct conf_kernel {
+	const char* name;
+	conf_call_t call;
+	unsigned flags;
+	unsigned chans;     // N-way channel count
+	unsigned ins;       // Number of input regions
+	unsigned in_fmt;
+	unsigned in_bytes;  // Bytes per complex sample per input region
+	unsigned outs;      // Number of output regions
+	unsigned out_fmt;
+	unsigned out_bytes; // Bytes per complex sample per output region
+	unsigned buf_bytes; // Allocated bytes per sample in output region 0, in-place kernels
+	double tol;
+	void* fn[V_COUNT];
+} conf_kernel_t;
+
+static int g_errors = 0;
+
+static xtrxdsp_iqcorr_t s_corr = { 0.9f/32768, 0.05f/32768, -0.03f/32768, 1.1f/32768, 0.01f, -0.02f, 0, 1, 1 };
+/* fixup passes use only flags and gains */
+static xtrxdsp_iqcorr_t s_fixup = { 1, 0, 0, 1, 0, 0, XTRXDSP_IQCORR_SWAP_IQ | XTRXDSP_IQCORR_NEG_Q, 0.5f, 2.0f };
+static xtrxdsp_iqcorr_stat_t s_stat;
+static xtrxdsp_meter_t s_meter;
+
+#define I16(p)  ((int16_t*)(p))
+#define U16(p)  ((uint16_t*)(p))
+#define I8(p)   ((int8_t*)(p))
+#define F32(p)  ((float*)(p))
+#define F64(p)  ((double*)(p))
+
+#define CALL(name, expr) \
+	static uint64_t call_##name(const conf_kernel_t* k, void* fn, uint8_t* const* in, \
+								uint8_t* const* out, size_t bytes, uint64_t state) \
+	{ __typeof__(&xtrxdsp_##name##_no) f = (__typeof__(f))fn; (void)k; (void)state; expr; return 0; }
+
+#define CALL_RET(name, expr) \
+	static uint64_t call_##name(const conf_kernel_t* k, void* fn, uint8_t* const* in, \
+								uint8_t* const* out, size_t bytes, uint64_t state) \
+	{ __typeof__(&xtrxdsp_##name##_no) f = (__typeof__(f))fn; (void)k; (void)state; return expr; }
+
+CALL(iq16_sc32,       f(I16(in[0]), F32(out[0]), 1.0f/32768, bytes))
+CALL_RET(iq12_sc32,   f(in[0], F32(out[0]), bytes, state))
+CALL(iq8_sc32,        f(I8(in[0]), F32(out[0]), bytes))
+CALL(iq8_ic16,        f(I8(in[0]), I16(out[0]), bytes))
+CALL(iq16_sc32i,      f(I16(in[0]), F32(out[0]), F32(out[1]), 1.0f/32768, bytes))
+CALL(iq16_ic16i,      f(I16(in[0]), I16(out[0]), I16(out[1]), bytes))
+CALL_RET(iq12_sc32i,  f(in[0], F32(out[0]), F32(out[1]), bytes, state))
+CALL(iq8_sc32i,       f(I8(in[0]), F32(out[0]), F32(out[1]), bytes))
+CALL(iq8_ic16i,       f(I8(in[0]), I16(out[0]), I16(out[1]), bytes))
+CALL(iq8_ic8i,        f(I8(in[0]), I8(out[0]), I8(out[1]), bytes))
+CALL(sc32_iq16,       f(F32(in[0]), I16(out[0]), 32767, bytes / 2))
+CALL(sc32i_iq16,      f(F32(in[0]), F32(in[1]), I16(out[0]), 32767, bytes))
+CALL(ic16i_iq16,      f(I16(in[0]), I16(in[1]), I16(out[0]), 2 * bytes))
+CALL(iq16_sc32_corr,  f(I16(in[0]), F32(out[0]), &s_corr, &s_stat, bytes))
+CALL_RET(iq12_sc32_corr, f(in[0], F32(out[0]), &s_corr, &s_stat, bytes, state))
+CALL(iq16_sc32i_corr, f(I16(in[0]), F32(out[0]), F32(out[1]), &s_corr, &s_stat, bytes))
+CALL(sc32_fixup,      memcpy(out[0], in[0], bytes); f(F32(out[0]), &s_fixup, bytes))
+CALL(ic16_fixup,      memcpy(out[0], in[0], bytes); f(I16(out[0]), &s_fixup, bytes))
+CALL(iq16_sc32_meter, f(I16(in[0]), F32(out[0]), 1.0f/32768, &s_meter, bytes))
+CALL_RET(iq12_sc32_meter, f(in[0], F32(out[0]), &s_meter, bytes, state))
+CALL(iq8_sc32_meter,  f(I8(in[0]), F32(out[0]), &s_meter, bytes))
+CALL(iq8_ic16_meter,  f(I8(in[0]), I16(out[0]), &s_meter, bytes))
+CALL(iq16_sc32i_meter, f(I16(in[0]), F32(out[0]), F32(out[1]), 1.0f/32768, &s_meter, bytes))
+CALL(iq16_ic16i_meter, f(I16(in[0]), I16(out[0]), I16(out[1]), &s_meter, bytes))
+CALL_RET(iq12_sc32i_meter, f(in[0], F32(out[0]), F32(out[1]), &s_meter, bytes, state))
+CALL(iq8_sc32i_meter, f(I8(in[0]), F32(out[0]), F32(out[1]), &s_meter, bytes))
+CALL(iq8_ic16i_meter, f(I8(in[0]), I16(out[0]), I16(out[1]), &s_meter, bytes))
+CALL(iq16_hc16,       f(I16(in[0]), U16(out[0]), 1.0f/32768, bytes))
+CALL(iq16_bf16,       f(I16(in[0]), U16(out[0]), 1.0f/32768, bytes))
+CALL(hc16_iq16,       f(U16(in[0]), I16(out[0]), 32767, bytes))
+CALL(bf16_iq16,       f(U16(in[0]), I16(out[0]), 32767, bytes))
+CALL(iq16_sc64,       f(I16(in[0]), F64(out[0]), 1.0/32768, bytes))
+CALL_RET(iq12_sc64,   f(in[0], F64(out[0]), bytes, state))
+CALL(sc64_iq16,       f(F64(in[0]), I16(out[0]), 32767, bytes / 4))
+CALL(iq16_sc32_nt,    f(I16(in[0]), F32(out[0]), 1.0f/32768, bytes))
+CALL(iq16_sc32i_nt,   f(I16(in[0]), F32(out[0]), F32(out[1]), 1.0f/32768, bytes))
+CALL(sc32_iq16_nt,    f(F32(in[0]), I16(out[0]), 32767, bytes / 2))
+CALL_RET(iq12_sc32_nt, f(in[0], F32(out[0]), bytes, state))
+CALL(iq8_sc32_nt,     f(I8(in[0]), F32(out[0]), bytes))
+/* in-place kernels get their input copied to the output region first */
+CALL(iq16_ic16i_ip,   memcpy(out[0], in[0], bytes); f(I16(out[0]), I16(out[1]), bytes))
+CALL(iq8_ic8i_ip,     memcpy(out[0], in[0], bytes); f(I8(out[0]), I8(out[1]), bytes))
+CALL(ic16i_iq16_ip,   memcpy(out[0], in[0], bytes); f(I16(out[0]), I16(in[1]), 2 * bytes))
+CALL(sc32_iq16_ip,    memcpy(out[0], in[0], bytes); f(out[0], 32767, bytes / 2))
+CALL(iq16_sc32_ip,    memcpy(out[0], in[0], bytes); f(out[0], 1.0f/32768, bytes))
+CALL(iq8_sc32_ip,     memcpy(out[0], in[0], bytes); f(out[0], bytes))
+CALL(iq8_ic16_ip,     memcpy(out[0], in[0], bytes); f(out[0], bytes))
+/* N-way kernels get a separate output region for every channel */
+CALL(iq16_sc32n,      f(I16(in[0]), (float* const*)out, k->chans, 1.0f/32768, bytes))
+CALL(iq16_ic16n,      f(I16(in[0]), (int16_t* const*)out, k->chans, bytes))
+CALL(iq12_sc32n,      f(in[0], (float* const*)out, k->chans, bytes))
+CALL(iq8_sc32n,       f(I8(in[0]), (float* const*)out, k->chans, bytes))
+CALL(iq8_ic16n,       f(I8(in[0]), (int16_t* const*)out, k->chans, bytes))
+CALL(sc32n_iq16,      f((const float* const*)in, k->chans, I16(out[0]), 32767, bytes / 2 * k->chans))
+CALL(ic16n_iq16,      f((const int16_t* const*)in, k->chans, I16(out[0]), bytes * k->chans))
+
+/* 64 taps filters need 64 samples of history, the rest of outputs isn't touched */
+static float s_taps_sc32[64] __attribute__((aligned(64)));
+static int16_t s_taps_iq16[64] __attribute__((aligned(64)));
+
+#define CALL_FILTER(name, expr) \
+	static uint64_t call_##name(const conf_kernel_t* k, void* fn, uint8_t* const* in, \
+								uint8_t* const* out, size_t bytes, uint64_t state) \
+	{ __typeof__(&xtrxdsp_##name##_no) f = (__typeof__(f))fn; (void)k; (void)state; expr; }
+
+CALL_FILTER(sc32_conv64,  if (bytes >= 64 * 8) f(F32(in[0]), s_taps_sc32, F32(out[0]), bytes / 4, 0); return 0)
+CALL_FILTER(iq16_conv64,  if (bytes >= 64 * 4) f(I16(in[0]), s_taps_iq16, I16(out[0]), bytes / 2, 0); return 0)
+CALL_FILTER(sc32_nco,     return f(F32(in[0]), F32(out[0]), bytes / 8, 0x12345678, 0x01234567))
+CALL_FILTER(ic16_nco,     return f(I16(in[0]), I16(out[0]), bytes / 4, 0x12345678, 0x01234567))
+CALL_FILTER(sc32_nco_iq16, return f(F32(in[0]), I16(out[0]), bytes / 8, 32767, 0x12345678, 0x01234567))
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VARIANTS(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx }
+#ifdef XTRXDSP_HAS__F16C__
+#define VARIANTS_F16C(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx, NULL, (void*)xtrxdsp_##name##_avx_f16c }
+#else
+#define VARIANTS_F16C(name) VARIANTS(name)
+#endif
+#ifdef XTRXDSP_HAS__FMA__
+#define VARIANTS_FMA(name) { (void*)xtrxdsp_##name##_no, (void*)xtrxdsp_##name##_sse2, (void*)xtrxdsp_##name##_avx, (void*)xtrxdsp_##name##_avx_fma }
+#else
+#define VARIANTS_FMA(name) VARIANTS(name)
+#endif
+#else
+#define VARIANTS(name) { (void*)xtrxdsp_##name##_no }
+#define VARIANTS_F16C(name) VARIANTS(name)
+#define VARIANTS_FMA(name) VARIANTS(name)
+#endif
+
+#define K(name, fl, ins, ifmt, ib, outs, ofmt, ob, tol) \
+	{ #name, call_##name, fl, 1, ins, ifmt, ib, outs, ofmt, ob, 0, tol, VARIANTS(name) }
+#define K_F16C(name, fl, ins, ifmt, ib, outs, ofmt, ob, tol) \
+	{ #name, call_##name, fl, 1, ins, ifmt, ib, outs, ofmt, ob, 0, tol, VARIANTS_F16C(name) }
+#define K_FMA(name, fl, ins, ifmt, ib, outs, ofmt, ob, tol) \
+	{ #name, call_##name, fl, 1, ins, ifmt, ib, outs, ofmt, ob, 0, tol, VARIANTS_FMA(name) }
+#define K_IP(name, ins, ifmt, ib, outs, ofmt, ob, bb, tol) \
+	{ #name, call_##name, 0, 1, ins, ifmt, ib, outs, ofmt, ob, bb, tol, VARIANTS(name) }
+#define K_N(name, ch, ins, ifmt, ib, outs, ofmt, ob, tol) \
+	{ #name, call_##name, 0, ch, ins, ifmt, ib, outs, ofmt, ob, 0, tol, VARIANTS(name) }
+
+/* float outputs are within [-1, 1], float to int conversions may round differently */
+#define TF  1e-6
+#define TI  1
+
+static const conf_kernel_t s_kernels[] = {
+	K(iq16_sc32,       0, 1, F_I16, 4, 1, F_F32, 8, TF),
+	K(iq12_sc32,       K_STATE, 1, F_U8, 3, 1, F_F32, 8, TF),
+	K(iq8_sc32,        0, 1, F_I8, 2, 1, F_F32, 8, TF),
+	K(iq8_ic16,        0, 1, F_I8, 2, 1, F_I16, 4, 0),
+	K(iq16_sc32i,      0, 1, F_I16, 4, 2, F_F32, 4, TF),
+	K(iq16_ic16i,      0, 1, F_I16, 4, 2, F_I16, 2, 0),
+	K(iq12_sc32i,      K_STATE, 1, F_U8, 3, 2, F_F32, 4, TF),
+	K(iq8_sc32i,       0, 1, F_I8, 2, 2, F_F32, 4, TF),
+	K(iq8_ic16i,       0, 1, F_I8, 2, 2, F_I16, 2, 0),
+	K(iq8_ic8i,        0, 1, F_I8, 2, 2, F_I8, 1, 0),
+	K(sc32_iq16,       0, 1, F_F32, 8, 1, F_I16, 4, TI),
+	K(sc32i_iq16,      0, 2, F_F32, 4, 1, F_I16, 4, TI),
+	K(ic16i_iq16,      0, 2, F_I16, 2, 1, F_I16, 4, 0),
+	K(iq16_sc32_corr,  0, 1, F_I16, 4, 1, F_F32, 8, TF),
+	K(iq12_sc32_corr,  K_STATE, 1, F_U8, 3, 1, F_F32, 8, TF),
+	K(iq16_sc32i_corr, 0, 1, F_I16, 4, 2, F_F32, 4, TF),
+	K_IP(sc32_fixup,   1, F_F32, 8, 1, F_F32, 8, 8, TF),
+	K_IP(ic16_fixup,   1, F_I16, 4, 1, F_I16, 4, 4, 0),
+	K(iq16_sc32_meter, K_METER, 1, F_I16, 4, 1, F_F32, 8, TF),
+	K(iq12_sc32_meter, K_METER | K_STATE, 1, F_U8, 3, 1, F_F32, 8, TF),
+	K(iq8_sc32_meter,  K_METER, 1, F_I8, 2, 1, F_F32, 8, TF),
+	K(iq8_ic16_meter,  K_METER, 1, F_I8, 2, 1, F_I16, 4, 0),
+	K(iq16_sc32i_meter, K_METER, 1, F_I16, 4, 2, F_F32, 4, TF),
+	K(iq16_ic16i_meter, K_METER, 1, F_I16, 4, 2, F_I16, 2, 0),
+	K(iq12_sc32i_meter, K_METER | K_STATE, 1, F_U8, 3, 2, F_F32, 4, TF),
+	K(iq8_sc32i_meter, K_METER, 1, F_I8, 2, 2, F_F32, 4, TF),
+	K(iq8_ic16i_meter, K_METER, 1, F_I8, 2, 2, F_I16, 2, 0),
+	K_F16C(iq16_hc16,  0, 1, F_I16, 4, 1, F_H16, 4, TI),
+	K(iq16_bf16,       0, 1, F_I16, 4, 1, F_BF16, 4, TI),
+	K_F16C(hc16_iq16,  0, 1, F_H16, 4, 1, F_I16, 4, TI),
+	K(bf16_iq16,       0, 1, F_BF16, 4, 1, F_I16, 4, TI),
+	K(iq16_sc64,       0, 1, F_I16, 4, 1, F_F64, 16, 1e-12),
+	K(iq12_sc64,       K_STATE, 1, F_U8, 3, 1, F_F64, 16, 1e-12),
+	K(sc64_iq16,       0, 1, F_F64, 16, 1, F_I16, 4, TI),
+	K(iq16_sc32_nt,    0, 1, F_I16, 4, 1, F_F32, 8, TF),
+	K(iq16_sc32i_nt,   0, 1, F_I16, 4, 2, F_F32, 4, TF),
+	K(sc32_iq16_nt,    0, 1, F_F32, 8, 1, F_I16, 4, TI),
+	K(iq12_sc32_nt,    K_STATE, 1, F_U8, 3, 1, F_F32, 8, TF),
+	K(iq8_sc32_nt,     0, 1, F_I8, 2, 1, F_F32, 8, TF),
+	K_IP(iq16_ic16i_ip, 1, F_I16, 4, 2, F_I16, 2, 4, 0),
+	K_IP(iq8_ic8i_ip,  1, F_I8, 2, 2, F_I8, 1, 2, 0),
+	K_IP(ic16i_iq16_ip, 2, F_I16, 2, 1, F_I16, 4, 4, 0),
+	K_IP(sc32_iq16_ip, 1, F_F32, 8, 1, F_I16, 4, 8, TI),
+	K_IP(iq16_sc32_ip, 1, F_I16, 4, 1, F_F32, 8, 8, TF),
+	K_IP(iq8_sc32_ip,  1, F_I8, 2, 1, F_F32, 8, 8, TF),
+	K_IP(iq8_ic16_ip,  1, F_I8, 2, 1, F_I16, 4, 4, 0),
+	K_N(iq16_sc32n, 3, 1, F_I16, 3 * 4, 3, F_F32, 8, TF),
+	K_N(iq16_sc32n, 4, 1, F_I16, 4 * 4, 4, F_F32, 8, TF),
+	K_N(iq16_sc32n, 8, 1, F_I16, 8 * 4, 8, F_F32, 8, TF),
+	K_N(iq16_ic16n, 3, 1, F_I16, 3 * 4, 3, F_I16, 4, 0),
+	K_N(iq16_ic16n, 4, 1, F_I16, 4 * 4, 4, F_I16, 4, 0),
+	K_N(iq16_ic16n, 8, 1, F_I16, 8 * 4, 8, F_I16, 4, 0),
+	K_N(iq12_sc32n, 4, 1, F_U8, 4 * 3, 4, F_F32, 8, TF),
+	K_N(iq8_sc32n,  4, 1, F_I8, 4 * 2, 4, F_F32, 8, TF),
+	K_N(iq8_ic16n,  4, 1, F_I8, 4 * 2, 4, F_I16, 4, 0),
+	K_N(sc32n_iq16, 3, 3, F_F32, 8, 1, F_I16, 3 * 4, TI),
+	K_N(sc32n_iq16, 4, 4, F_F32, 8, 1, F_I16, 4 * 4, TI),
+	K_N(sc32n_iq16, 8, 8, F_F32, 8, 1, F_I16, 8 * 4, TI),
+	K_N(ic16n_iq16, 3, 3, F_I16, 4, 1, F_I16, 3 * 4, 0),
+	K_N(ic16n_iq16, 4, 4, F_I16, 4, 1, F_I16, 4 * 4, 0),
+	K_N(ic16n_iq16, 8, 8, F_I16, 4, 1, F_I16, 8 * 4, 0),
+	K_FMA(sc32_conv64, K_SPARSE, 1, F_F32, 8, 1, F_F32, 8, 1e-5),
+	K(iq16_conv64,     K_SPARSE, 1, F_I16, 4, 1, F_I16, 4, TI),
+	K(sc32_nco,        0, 1, F_F32, 8, 1, F_F32, 8, 1e-5),
+	K(ic16_nco,        0, 1, F_I16, 4, 1, F_I16, 4, 2),
+	K(sc32_nco_iq16,   0, 1, F_F32, 8, 1, F_I16, 4, 2),
+};
+
+/* every tail of up to 4 AVX registers, then some random sizes */
+static const unsigned s_fixed_sizes[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+										  17, 23, 24, 31, 32, 33, 47, 63, 64, 65, 66, 67, 68, 69,
+										  70, 71, 72, 79, 95, 96, 127, 128, 129, 255, 256, 257 };
+#define RANDOM_SIZES 16
+
+static uint32_t s_rnd = 0x12345678;
+
+static uint32_t rnd(void)
+{
+	/* xorshift32, we need reproducible runs on all platforms */
+	s_rnd ^= s_rnd << 13;
+	s_rnd ^= s_rnd >> 17;
+	s_rnd ^= s_rnd << 5;
+	return s_rnd;
+}
+
+static float rnd_float(void)
+{
+	return (int32_t)rnd() * (1.0f / 2147483648.0f);
+}
+
+static int variant_supported(unsigned v)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	switch (v) {
+	case V_SSE2: return __builtin_cpu_supports("sse2");
+	case V_AVX: return __builtin_cpu_supports("avx");
+	case V_AVX_FMA: return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+	case V_AVX_F16C: {
+		unsigned a, b, c, d;
+		return __builtin_cpu_supports("avx") && __get_cpuid(1, &a, &b, &c, &d) && (c & bit_F16C);
+	}
+	}
+#endif
+	return v == V_NO;
+}
+
+typedef struct region {
+	uint8_t* base;
+	uint8_t* data;
+	size_t size;  // Bytes owned by the kernel, everything else is a guard
+	uint8_t fill;
+} region_t;
+
+static region_t s_in[MAX_REGIONS];
+static region_t s_out[MAX_REGIONS];
+static region_t s_ref[MAX_REGIONS];
+
+#define REGION_ALLOC (GUARD + MAX_OFFSET + 16 * MAX_SAMPLES + GUARD)
+
+static void fill_input(unsigned fmt, uint8_t* p, size_t bytes)
+{
+	size_t i;
+	switch (fmt) {
+	case F_F32:
+		for (i = 0; i < bytes / 4; i++)
+			F32(p)[i] = rnd_float();
+		break;
+	case F_F64:
+		for (i = 0; i < bytes / 8; i++)
+			F64(p)[i] = rnd_float();
+		break;
+	case F_H16:
+	case F_BF16: {
+		/* valid numbers in [-1, 1] from the reference converters */
+		int16_t tmp[64];
+		for (i = 0; i < bytes / 2; i += 64) {
+			size_t cnt = (bytes / 2 - i > 64) ? 64 : bytes / 2 - i;
+			for (unsigned j = 0; j < cnt; j++)
+				tmp[j] = rnd();
+			if (fmt == F_H16)
+				xtrxdsp_iq16_hc16_no(tmp, U16(p) + i, 1.0f/32768, 2 * cnt);
+			else
+				xtrxdsp_iq16_bf16_no(tmp, U16(p) + i, 1.0f/32768, 2 * cnt);
+		}
+		break;
+	}
+	default:
+		for (i = 0; i < bytes; i++)
+			p[i] = rnd();
+	}
+}
+
+/* place regions at the offsets and fill them with the guard pattern */
+static void setup_regions(region_t* r, unsigned cnt, size_t size, const unsigned* offs, uint8_t fill)
+{
+	for (unsigned i = 0; i < cnt; i++) {
+		r[i].data = r[i].base + GUARD + offs[i];
+		r[i].size = size;
+		r[i].fill = fill;
+		memset(r[i].base, fill, GUARD + offs[i] + size + GUARD);
+	}
+}
+
+/* returns offset of the first damaged guard byte relative to region data */
+static int check_guards(const region_t* r, unsigned cnt)
+{
+	const uint8_t* p;
+
+	for (unsigned i = 0; i < cnt; i++) {
+		for (p = r[i].base; p < r[i].data; p++) {
+			if (*p != r[i].fill)
+				return (int)(p - r[i].data);
+		}
+		for (p = r[i].data + r[i].size; p < r[i].data + r[i].size + GUARD; p++) {
+			if (*p != r[i].fill)
+				return (int)(p - r[i].data);
+		}
+	}
+	return 0;
+}
+
+static int compare(unsigned fmt, double tol, const uint8_t* ref, const uint8_t* res, size_t bytes, size_t* at)
+{
+	size_t i, cnt = bytes / s_fmt_size[fmt];
+	double a, b;
+
+	for (i = 0; i < cnt; i++) {
+		switch (fmt) {
+		case F_I8:  a = I8(ref)[i];  b = I8(res)[i]; break;
+		case F_I16: a = I16(ref)[i]; b = I16(res)[i]; break;
+		case F_H16:
+		case F_BF16: a = U16(ref)[i]; b = U16(res)[i]; break;
+		case F_F32: a = F32(ref)[i]; b = F32(res)[i]; break;
+		case F_F64: a = F64(ref)[i]; b = F64(res)[i]; break;
+		default:    a = ref[i]; b = res[i];
+		}
+
+		if (!(fabs(a - b) <= tol)) {
+			*at = i;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void report(const conf_kernel_t* k, unsigned v, size_t n, const unsigned* ioff,
+				   const unsigned* ooff, const char* what)
+{
+	if (g_errors++ > 100)
+		return;
+
+	fprintf(stderr, "%s/%u %s: n=%u in_off=%u out_off=%u: %s\n",
+			k->name, k->chans, s_variant_names[v], (unsigned)n, ioff[0], ooff[0], what);
+}
+
+static void check_outputs(const conf_kernel_t* k, unsigned v, size_t n,
+						  const unsigned* ioff, const unsigned* ooff,
+						  region_t* ref, region_t* res, const char* mode)
+{
+	size_t cmp = n * k->out_bytes;
+	char msg[128];
+	size_t at;
+	int off;
+
+	for (unsigned o = 0; o < k->outs; o++) {
+		if (compare(k->out_fmt, k->tol, ref[o].data, res[o].data, cmp, &at)) {
+			snprintf(msg, sizeof(msg), "%s output %u mismatch at element %u", mode, o, (unsigned)at);
+			report(k, v, n, ioff, ooff, msg);
+			return;
+		}
+	}
+	if ((off = check_guards(res, k->outs))) {
+		snprintf(msg, sizeof(msg), "%s output guard overwritten at %d", mode, off);
+		report(k, v, n, ioff, ooff, msg);
+	}
+}
+
+static void test_kernel(const conf_kernel_t* k, unsigned v)
+{
+	unsigned ioff[MAX_REGIONS], ooff[MAX_REGIONS], zoff[MAX_REGIONS] = { 0 };
+	unsigned s, c, i;
+	size_t n;
+	unsigned isz = s_fmt_size[k->in_fmt];
+	unsigned osz = s_fmt_size[k->out_fmt];
+	unsigned sizes = sizeof(s_fixed_sizes) / sizeof(s_fixed_sizes[0]) + RANDOM_SIZES;
+
+	for (s = 0; s < sizes; s++) {
+		n = (s < sizeof(s_fixed_sizes) / sizeof(s_fixed_sizes[0])) ?
+				s_fixed_sizes[s] : rnd() % (MAX_SAMPLES / k->chans);
+
+		/* 0: everything aligned, others: random misalignment */
+		for (c = 0; c < 4; c++) {
+			for (i = 0; i < MAX_REGIONS; i++) {
+				ioff[i] = (c == 0 || (k->flags & K_ALIGNED)) ? 0 : (rnd() % (MAX_OFFSET / isz)) * isz;
+				ooff[i] = (c == 0) ? 0 : (rnd() % (MAX_OFFSET / osz)) * osz;
+			}
+			if (c == 3) {
+				/* inputs and outputs equally misaligned */
+				for (i = 0; i < MAX_REGIONS; i++)
+					ooff[i] = ioff[0] % osz ? 0 : ioff[0];
+			}
+
+			size_t bytes = n * k->in_bytes;
+			size_t alloc = n * (k->buf_bytes > k->out_bytes ? k->buf_bytes : k->out_bytes);
+			uint8_t* inp[MAX_REGIONS];
+			uint8_t* refp[MAX_REGIONS];
+			uint8_t* resp[MAX_REGIONS];
+			xtrxdsp_meter_t ref_meter;
+			uint64_t ref_state, state;
+			int off;
+
+			setup_regions(s_in, k->ins, bytes, ioff, GUARD_BYTE);
+			for (i = 0; i < k->ins; i++) {
+				fill_input(k->in_fmt, s_in[i].data, bytes);
+				inp[i] = s_in[i].data;
+			}
+
+			setup_regions(s_ref, k->outs, alloc, zoff, GUARD_BYTE);
+			for (i = 0; i < k->outs; i++)
+				refp[i] = s_ref[i].data;
+			memset(&s_meter, 0, sizeof(s_meter));
+			ref_state = k->call(k, k->fn[V_NO], inp, refp, bytes, 0);
+			ref_meter = s_meter;
+
+			if ((off = check_guards(s_in, k->ins))) {
+				report(k, v, n, ioff, ooff, "input guard overwritten");
+			}
+
+			if (v != V_NO || c != 0) {
+				setup_regions(s_out, k->outs, alloc, ooff, GUARD_BYTE);
+				for (i = 0; i < k->outs; i++)
+					resp[i] = s_out[i].data;
+				memset(&s_meter, 0, sizeof(s_meter));
+				state = k->call(k, k->fn[v], inp, resp, bytes, 0);
+
+				check_outputs(k, v, n, ioff, ooff, s_ref, s_out, "full");
+				if (state != ref_state)
+					report(k, v, n, ioff, ooff, "returned state mismatch");
+				if ((k->flags & K_METER) && memcmp(&s_meter, &ref_meter, sizeof(s_meter)))
+					report(k, v, n, ioff, ooff, "meter mismatch");
+			} else {
+				/* the reference has to fill every output regardless of its prior content */
+				setup_regions(s_out, k->outs, alloc, zoff, (uint8_t)~GUARD_BYTE);
+				for (i = 0; i < k->outs; i++)
+					resp[i] = s_out[i].data;
+				k->call(k, k->fn[V_NO], inp, resp, bytes, 0);
+
+				for (i = 0; i < k->outs && !(k->flags & K_SPARSE); i++) {
+					if (memcmp(s_ref[i].data, s_out[i].data, n * k->out_bytes)) {
+						report(k, v, n, ioff, zoff, "output isn't fully written");
+						break;
+					}
+				}
+				if ((off = check_guards(s_ref, k->outs)))
+					report(k, v, n, ioff, zoff, "reference output guard overwritten");
+			}
+
+			if (!(k->flags & K_STATE) || n > 64 || c != 0)
+				continue;
+
+			/* feed the stream in two chunks split at every byte */
+			for (size_t split = 0; split <= bytes; split++) {
+				uint8_t* inp2[MAX_REGIONS];
+				uint8_t* resp2[MAX_REGIONS];
+
+				setup_regions(s_out, k->outs, alloc, zoff, GUARD_BYTE);
+				for (i = 0; i < k->outs; i++) {
+					resp[i] = s_out[i].data;
+					resp2[i] = s_out[i].data + split / 3 * k->out_bytes;
+				}
+				for (i = 0; i < k->ins; i++)
+					inp2[i] = s_in[i].data + split;
+
+				memset(&s_meter, 0, sizeof(s_meter));
+				state = k->call(k, k->fn[v], inp, resp, split, 0);
+				state = k->call(k, k->fn[v], inp2, resp2, bytes - split, state);
+
+				check_outputs(k, v, n, ioff, zoff, s_ref, s_out, "split");
+				if (state != ref_state)
+					report(k, v, n, ioff, zoff, "split state mismatch");
+				if ((k->flags & K_METER) && memcmp(&s_meter, &ref_meter, sizeof(s_meter)))
+					report(k, v, n, ioff, zoff, "split meter mismatch");
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned k, v, i;
+	int prev;
+
+	for (i = 0; i < MAX_REGIONS; i++) {
+		s_in[i].base = (uint8_t*)xtrxdsp_aligned_alloc(REGION_ALLOC);
+		s_out[i].base = (uint8_t*)xtrxdsp_aligned_alloc(REGION_ALLOC);
+		s_ref[i].base = (uint8_t*)xtrxdsp_aligned_alloc(REGION_ALLOC);
+		if (!s_in[i].base || !s_out[i].base || !s_ref[i].base) {
+			fprintf(stderr, "Unable to allocate buffers\n");
+			return 2;
+		}
+	}
+
+	for (i = 0; i < 64; i++) {
+		s_taps_sc32[i] = rnd_float() / 16;
+		s_taps_iq16[i] = (int16_t)rnd() / 16;
+	}
+
+	for (k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++) {
+		const conf_kernel_t* kern = &s_kernels[k];
+		if (argc > 1) {
+			int match = 0;
+			for (i = 1; i < (unsigned)argc; i++)
+				match |= (strstr(kern->name, argv[i]) != NULL);
+			if (!match)
+				continue;
+		}
+
+		for (v = 0; v < V_COUNT; v++) {
+			if (kern->fn[v] == NULL || !variant_supported(v))
+				continue;
+
+			prev = g_errors;
+			test_kernel(kern, v);
+			printf("%-18s %u %-9s %s\n", kern->name, kern->chans, s_variant_names[v],
+				   (prev == g_errors) ? "OK" : "FAILED");
+		}
+	}
+
+	for (i = 0; i < MAX_REGIONS; i++) {
+		xtrxdsp_aligned_free(s_in[i].base);
+		xtrxdsp_aligned_free(s_out[i].base);
+		xtrxdsp_aligned_free(s_ref[i].base);
+	}
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
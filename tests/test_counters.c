@@ -0,0 +1,109 @@
+/*
+ * xtrxdsp kernel counters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <xtrxdsp.h>
+
+#define SAMPLES 1024
+#define CALLS   3
+
+static int g_errors = 0;
+
+#define CHECK(x) do { if (!(x)) { fprintf(stderr, "Check failed: " #x "\n"); g_errors++; } } while(0)
+
+#ifdef XTRXDSP_INSTRUMENT
+static const xtrxdsp_counter_t* find(const xtrxdsp_counter_t* c, int cnt, const char* func)
+{
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		if (strcmp(c[i].func, func) == 0)
+			return &c[i];
+	}
+	return NULL;
+}
+
+static void test_counters(void)
+{
+	xtrxdsp_counter_t c[64];
+	const xtrxdsp_counter_t* e;
+	int16_t iq[2*SAMPLES] = { 0 };
+	int8_t iq8[2*SAMPLES] = { 0 };
+	float out[2*SAMPLES];
+	int cnt, i;
+
+	xtrxdsp_counters_reset();
+	for (i = 0; i < CALLS; i++)
+		xtrxdsp_iq16_sc32(iq, out, 1.0f, sizeof(iq));
+	xtrxdsp_iq8_sc32(iq8, out, sizeof(iq8));
+
+	cnt = xtrxdsp_counters_snapshot(c, 64);
+	CHECK(cnt == 2);
+
+	e = find(c, cnt, "xtrxdsp_iq16_sc32");
+	CHECK(e != NULL);
+	if (e) {
+		CHECK(e->calls == CALLS);
+		CHECK(e->samples == CALLS * SAMPLES);
+		CHECK(e->cycles > 0);
+		CHECK(strcmp(e->variant, xtrxdsp_get_variant("xtrxdsp_iq16_sc32")) == 0);
+	}
+
+	e = find(c, cnt, "xtrxdsp_iq8_sc32");
+	CHECK(e && e->calls == 1 && e->samples == SAMPLES);
+
+	for (i = 0; i < cnt; i++) {
+		printf("%-20s %-8s %8llu calls %10llu samples %12llu cycles\n",
+			   c[i].func, c[i].variant,
+			   (unsigned long long)c[i].calls,
+			   (unsigned long long)c[i].samples,
+			   (unsigned long long)c[i].cycles);
+	}
+
+	CHECK(xtrxdsp_counters_snapshot(c, 1) == 1);
+
+	xtrxdsp_counters_reset();
+	CHECK(xtrxdsp_counters_snapshot(c, 64) == 0);
+}
+#else
+/* counters are compiled out, the API is still there and says so */
+static void test_counters(void)
+{
+	xtrxdsp_counter_t c[64];
+	int16_t iq[2*SAMPLES] = { 0 };
+	float out[2*SAMPLES];
+
+	xtrxdsp_counters_reset();
+	xtrxdsp_iq16_sc32(iq, out, 1.0f, sizeof(iq));
+	CHECK(xtrxdsp_counters_snapshot(c, 64) == -ENOTSUP);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	test_counters();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
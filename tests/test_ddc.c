@@ -0,0 +1,160 @@
+/*
+ * xtrxdsp DDC test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include <xtrxdsp_ddc.h>
+
+/* in floats, long enough for several DDC chunks and an uneven tail */
+#define VALS   (5 * XTRXDSP_DDC_CHUNK + 1000)
+#define FREQ   0.15
+#define FREQ2  -0.1
+#define AMP    0.5
+/* filter transient, in output floats at 2x decimation */
+#define SETTLE (FILTER_TAPS_64)
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "%s: expected %f (" #x ") got %f (" #y ") at %u!\n", name, (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+/* multiples of the 2x decimation step, not less than filter history */
+static const unsigned s_blocks[] = { 128, 132, 1000, 4100, 260, 8196, 516, 4096, 2052 };
+#define NBLOCKS (sizeof(s_blocks) / sizeof(s_blocks[0]))
+
+static float s_in[VALS] __attribute__((aligned(64)));
+static float s_out[VALS / 2 + 4] __attribute__((aligned(64)));
+static float s_ref[VALS / 2 + 4] __attribute__((aligned(64)));
+
+/* tone with continuous phase, switching frequency after sample `at` the
+ * same way NCO does when retuned between calls
+ */
+static void tone(float* out, unsigned count, double freq, double freq2, unsigned at)
+{
+	double ph = 0;
+	for (unsigned i = 0; i < count; i++) {
+		out[2*i]     = AMP * cos(2 * M_PI * ph);
+		out[2*i + 1] = AMP * sin(2 * M_PI * ph);
+		ph += (i < at) ? freq : freq2;
+		ph -= floor(ph);
+	}
+}
+
+static double dc_gain(void)
+{
+	double g = 0;
+	for (unsigned i = 0; i < FILTER_TAPS_64; i++) {
+		g += g_filter_float_taps_64_2x[i];
+	}
+	return g;
+}
+
+static void test_ddc_tone(void)
+{
+	const char* name = "ddc tone";
+	const double g = AMP * dc_gain();
+	xtrxdsp_ddc_state_t state;
+	unsigned i = 0, cnt;
+
+	CHECK_F(xtrxdsp_ddc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, FREQ, &state), 0, 0);
+
+	tone(s_in, VALS / 2, FREQ, FREQ, 0);
+	cnt = xtrxdsp_ddc_work(&state, s_in, s_out, VALS);
+	xtrxdsp_ddc_free(&state);
+	CHECK_F(VALS / 2, cnt, 0);
+
+	/* channel is at DC, image at -2 * FREQ would beat here */
+	for (i = SETTLE; i < cnt / 2; i++) {
+		CHECK_F(g, s_out[2*i], 1e-3);
+		CHECK_F(0, s_out[2*i + 1], 1e-3);
+	}
+	printf("%s: ok\n", name);
+}
+
+static void test_ddc_retune(void)
+{
+	const char* name = "ddc retune";
+	const double g = AMP * dc_gain();
+	const unsigned half = VALS / 2 & ~3u;
+	xtrxdsp_ddc_state_t state;
+	unsigned i = 0, cnt;
+
+	CHECK_F(xtrxdsp_ddc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, FREQ, &state), 0, 0);
+
+	tone(s_in, VALS / 2, FREQ, FREQ2, half / 2);
+	cnt = xtrxdsp_ddc_work(&state, s_in, s_out, half);
+	CHECK_F(xtrxdsp_ddc_set_freq(&state, FREQ2), 0, 0);
+	cnt += xtrxdsp_ddc_work(&state, s_in + half, s_out + cnt, VALS - half);
+	CHECK_F(xtrxdsp_ddc_set_freq(&state, 0.75), -EINVAL, 0);
+	xtrxdsp_ddc_free(&state);
+	CHECK_F(VALS / 2, cnt, 0);
+
+	/* NCO phase is kept, so a phase continuous input gives no transient */
+	for (i = SETTLE; i < cnt / 2; i++) {
+		CHECK_F(g, s_out[2*i], 1e-3);
+		CHECK_F(0, s_out[2*i + 1], 1e-3);
+	}
+	printf("%s: ok\n", name);
+}
+
+static void test_ddc_chunks(void)
+{
+	const char* name = "ddc chunks";
+	xtrxdsp_ddc_state_t state;
+	unsigned i = 0, n, b, sz, cnt, total;
+
+	for (i = 0; i < VALS; i++) {
+		s_in[i] = (float)rand() / RAND_MAX * 2 - 1;
+	}
+
+	i = 0;
+	CHECK_F(xtrxdsp_ddc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, FREQ, &state), 0, 0);
+	total = xtrxdsp_ddc_work(&state, s_in, s_ref, VALS);
+	xtrxdsp_ddc_free(&state);
+
+	CHECK_F(xtrxdsp_ddc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, FREQ, &state), 0, 0);
+	for (n = 0, b = 0, cnt = 0; n < VALS; n += sz, b = (b + 1) % NBLOCKS) {
+		sz = (VALS - n < s_blocks[b] + FILTER_TAPS_64 * 2) ? VALS - n : s_blocks[b];
+		cnt += xtrxdsp_ddc_work(&state, s_in + n, s_out + cnt, sz);
+	}
+	xtrxdsp_ddc_free(&state);
+	CHECK_F(total, cnt, 0);
+
+	/* only NCO phase rounding differs between the two */
+	for (i = 0; i < cnt; i++) {
+		CHECK_F(s_ref[i], s_out[i], 1e-4);
+	}
+	printf("%s: ok\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	srand(1);
+
+	test_ddc_tone();
+	test_ddc_retune();
+	test_ddc_chunks();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * xtrxdsp dispatch table test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <xtrxdsp.h>
+
+#define THREADS 4
+#define SAMPLES 64
+
+static int g_errors = 0;
+
+#define CHECK(x) do { if (!(x)) { fprintf(stderr, "Check failed: " #x "\n"); g_errors++; } } while(0)
+
+static void* fetch_thread(void* arg)
+{
+	*(const xtrxdsp_dispatch_t**)arg = xtrxdsp_get_dispatch();
+	return NULL;
+}
+
+static void test_dispatch_once(void)
+{
+	pthread_t th[THREADS];
+	const xtrxdsp_dispatch_t* t[THREADS];
+	unsigned i;
+
+	for (i = 0; i < THREADS; i++)
+		pthread_create(&th[i], NULL, fetch_thread, &t[i]);
+	for (i = 0; i < THREADS; i++)
+		pthread_join(th[i], NULL);
+
+	for (i = 0; i < THREADS; i++)
+		CHECK(t[i] != NULL && t[i] == xtrxdsp_get_dispatch());
+}
+
+static void test_dispatch_call(void)
+{
+	const xtrxdsp_dispatch_t* t = xtrxdsp_get_dispatch();
+	const xtrxdsp_dispatch_t* g;
+	__typeof__(t->iq16_sc32) iq16_sc32 = t->iq16_sc32;
+	int16_t in[2*SAMPLES];
+	float a[2*SAMPLES], b[2*SAMPLES];
+	unsigned i;
+
+	CHECK(t->iq16_sc32 != NULL);
+	CHECK(t->sc32_iq16 != NULL);
+	CHECK(t->sc32_nco != NULL);
+
+	for (i = 0; i < 2*SAMPLES; i++)
+		in[i] = (int16_t)(i * 517 - 16000);
+
+	t->iq16_sc32(in, a, 1.0f / 32768, sizeof(in));
+	xtrxdsp_iq16_sc32(in, b, 1.0f / 32768, sizeof(in));
+	CHECK(memcmp(a, b, sizeof(a)) == 0);
+
+	/* set_isa() publishes another table, the kept one is left intact */
+	CHECK(xtrxdsp_set_isa(XTRXDSP_ISA_GENERIC) == 0);
+	CHECK(t->iq16_sc32 == iq16_sc32);
+	g = xtrxdsp_get_dispatch();
+	CHECK(g->iq16_sc32 == xtrxdsp_iq16_sc32_no);
+	g->iq16_sc32(in, a, 1.0f / 32768, sizeof(in));
+	CHECK(memcmp(a, b, sizeof(a)) == 0);
+
+	/* and it's the same one once the limit is lifted again */
+	CHECK(xtrxdsp_set_isa(XTRXDSP_ISA_NATIVE) == 0);
+	CHECK(xtrxdsp_get_dispatch() == t);
+}
+
+int main(int argc, char** argv)
+{
+	test_dispatch_once();
+	test_dispatch_call();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
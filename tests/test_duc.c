@@ -0,0 +1,191 @@
+/*
+ * xtrxdsp DUC test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include <xtrxdsp_duc.h>
+
+/* input floats, long enough for several DUC chunks and an uneven tail */
+#define VALS   (3 * XTRXDSP_DUC_CHUNK + 500)
+#define INTER  1
+#define FREQ   0.1
+#define FREQ2  -0.22
+#define SCALE  32767.0
+/* filter transient, in output samples */
+#define SETTLE (FILTER_TAPS_64)
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "%s: expected %f (" #x ") got %f (" #y ") at %u!\n", name, (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+/* even and not less than filter history, in input floats */
+static const unsigned s_blocks[] = { 128, 130, 1002, 2050, 262, 4098, 514, 2048, 3000 };
+#define NBLOCKS (sizeof(s_blocks) / sizeof(s_blocks[0]))
+
+static float   s_in[VALS] __attribute__((aligned(64)));
+static int16_t s_out[VALS << INTER] __attribute__((aligned(64)));
+static int16_t s_ref[VALS << INTER] __attribute__((aligned(64)));
+
+static double dc_gain(void)
+{
+	double g = 0;
+	for (unsigned i = 0; i < FILTER_TAPS_64; i++) {
+		g += g_filter_float_taps_64_2x[i];
+	}
+	return g;
+}
+
+static void dc(float i_val, float q_val)
+{
+	for (unsigned i = 0; i < VALS / 2; i++) {
+		s_in[2*i]     = i_val;
+		s_in[2*i + 1] = q_val;
+	}
+}
+
+/* tone of amplitude amp expected at output, frequency switched after
+ * sample `at` the same way NCO does when retuned between calls
+ */
+static void check_tone(const char* name, const int16_t* out, unsigned count,
+					   double amp, unsigned at)
+{
+	double ph = 0;
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		double ei = amp * cos(2 * M_PI * ph);
+		double eq = amp * sin(2 * M_PI * ph);
+
+		ei = (ei > 32767) ? 32767 : (ei < -32768) ? -32768 : ei;
+		eq = (eq > 32767) ? 32767 : (eq < -32768) ? -32768 : eq;
+
+		if (i >= SETTLE) {
+			CHECK_F(ei, out[2*i], 2);
+			CHECK_F(eq, out[2*i + 1], 2);
+		}
+		ph += (i < at) ? FREQ : FREQ2;
+		ph -= floor(ph);
+	}
+}
+
+static void test_duc_tone(void)
+{
+	const char* name = "duc tone";
+	xtrxdsp_duc_state_t state;
+	unsigned i = 0, cnt;
+
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, 0, FREQ, SCALE, &state), -EINVAL, 0);
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, INTER, FREQ, SCALE, &state), 0, 0);
+
+	dc(0.5, 0);
+	cnt = xtrxdsp_duc_work(&state, s_in, s_out, VALS);
+	xtrxdsp_duc_free(&state);
+	CHECK_F(VALS << INTER, cnt, 0);
+
+	check_tone(name, s_out, cnt / 2, 0.5 * SCALE * dc_gain(), cnt);
+	printf("%s: ok\n", name);
+}
+
+static void test_duc_retune(void)
+{
+	const char* name = "duc retune";
+	const unsigned half = VALS / 2 & ~1u;
+	xtrxdsp_duc_state_t state;
+	unsigned i = 0, cnt;
+
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, INTER, FREQ, SCALE, &state), 0, 0);
+
+	dc(0.5, 0);
+	cnt = xtrxdsp_duc_work(&state, s_in, s_out, half);
+	CHECK_F(xtrxdsp_duc_set_freq(&state, FREQ2), 0, 0);
+	cnt += xtrxdsp_duc_work(&state, s_in + half, s_out + cnt, VALS - half);
+	CHECK_F(xtrxdsp_duc_set_freq(&state, 0.75), -EINVAL, 0);
+	xtrxdsp_duc_free(&state);
+	CHECK_F(VALS << INTER, cnt, 0);
+
+	/* NCO phase is kept, tone continues at the new frequency */
+	check_tone(name, s_out, cnt / 2, 0.5 * SCALE * dc_gain(), (half << INTER) / 2);
+	printf("%s: ok\n", name);
+}
+
+static void test_duc_saturation(void)
+{
+	const char* name = "duc saturation";
+	xtrxdsp_duc_state_t state;
+	unsigned i = 0, cnt;
+
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, INTER, FREQ, SCALE, &state), 0, 0);
+
+	/* 1.5 full scale, clips around the peaks of I and Q */
+	dc(1.5, 0);
+	cnt = xtrxdsp_duc_work(&state, s_in, s_out, VALS);
+	xtrxdsp_duc_free(&state);
+	CHECK_F(VALS << INTER, cnt, 0);
+
+	check_tone(name, s_out, cnt / 2, 1.5 * SCALE * dc_gain(), cnt);
+	printf("%s: ok\n", name);
+}
+
+static void test_duc_chunks(void)
+{
+	const char* name = "duc chunks";
+	xtrxdsp_duc_state_t state;
+	unsigned i = 0, n, b, sz, cnt, total;
+
+	for (i = 0; i < VALS; i++) {
+		s_in[i] = (float)rand() / RAND_MAX * 2 - 1;
+	}
+
+	i = 0;
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, INTER, FREQ, SCALE, &state), 0, 0);
+	total = xtrxdsp_duc_work(&state, s_in, s_ref, VALS);
+	xtrxdsp_duc_free(&state);
+
+	CHECK_F(xtrxdsp_duc_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, INTER, FREQ, SCALE, &state), 0, 0);
+	for (n = 0, b = 0, cnt = 0; n < VALS; n += sz, b = (b + 1) % NBLOCKS) {
+		sz = (VALS - n < s_blocks[b] + FILTER_TAPS_64 * 2) ? VALS - n : s_blocks[b];
+		cnt += xtrxdsp_duc_work(&state, s_in + n, s_out + cnt, sz);
+	}
+	xtrxdsp_duc_free(&state);
+	CHECK_F(total, cnt, 0);
+
+	/* phase is carried across calls, so only rounding may differ */
+	for (i = 0; i < cnt; i++) {
+		CHECK_F(s_ref[i], s_out[i], 1);
+	}
+	printf("%s: ok\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	srand(1);
+
+	test_duc_tone();
+	test_duc_retune();
+	test_duc_saturation();
+	test_duc_chunks();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
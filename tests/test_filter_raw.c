@@ -0,0 +1,119 @@
+/*
+ * xtrxdsp wire format filter test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <xtrxdsp_filters.h>
+
+/* in floats, the largest block is several raw chunks */
+#define MAX_BLOCK 10000
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "%s: expected %f (" #x ") got %f (" #y ") at %u!\n", name, (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+/* multiples of every decimation step, in floats; most don't fit a single
+ * XTRXDSP_FILTER_RAW_CHUNK and hit the split tail
+ */
+static const unsigned s_blocks[] = { 128, 2056, 4000, 4096, 6000, 136, MAX_BLOCK };
+
+static int16_t s_iq16[MAX_BLOCK] __attribute__((aligned(64)));
+static uint8_t s_iq12[MAX_BLOCK / 2 * 3] __attribute__((aligned(64)));
+static float   s_sc32[MAX_BLOCK] __attribute__((aligned(64)));
+/* conv kernel may store one output past the returned count */
+static float   s_out[MAX_BLOCK + 8] __attribute__((aligned(64)));
+static float   s_ref[MAX_BLOCK + 8] __attribute__((aligned(64)));
+
+static void test_work_iq16(unsigned decim)
+{
+	const char* name = "filter_work_iq16";
+	xtrxdsp_filter_state_t ref, st;
+	unsigned i = 0, b, cnt, ref_cnt;
+
+	CHECK_F(xtrxdsp_filter_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, decim, 0, MAX_BLOCK, &ref), 0, 0);
+	CHECK_F(xtrxdsp_filter_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, decim, 0, MAX_BLOCK, &st), 0, 0);
+
+	/* history has to carry over between calls as well as between chunks */
+	for (b = 0; b < sizeof(s_blocks) / sizeof(s_blocks[0]); b++) {
+		for (i = 0; i < s_blocks[b]; i++) {
+			s_iq16[i] = (int16_t)rand();
+		}
+
+		xtrxdsp_iq16_sc32(s_iq16, s_sc32, 1.0f / 32767, s_blocks[b] * sizeof(int16_t));
+		ref_cnt = xtrxdsp_filter_work(&ref, s_sc32, s_ref, s_blocks[b]);
+		cnt = xtrxdsp_filter_work_iq16(&st, s_iq16, s_out, 1.0f / 32767, s_blocks[b]);
+
+		i = b;
+		CHECK_F(ref_cnt, cnt, 0);
+		for (i = 0; i < cnt; i++) {
+			CHECK_F(s_ref[i], s_out[i], 1e-6);
+		}
+	}
+
+	xtrxdsp_filter_free(&ref);
+	xtrxdsp_filter_free(&st);
+	printf("%s decim %u: ok\n", name, decim);
+}
+
+static void test_work_iq12(unsigned decim)
+{
+	const char* name = "filter_work_iq12";
+	xtrxdsp_filter_state_t ref, st;
+	unsigned i = 0, b, cnt, ref_cnt, bytes;
+
+	CHECK_F(xtrxdsp_filter_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, decim, 0, MAX_BLOCK, &ref), 0, 0);
+	CHECK_F(xtrxdsp_filter_init(g_filter_float_taps_64_2x, FILTER_TAPS_64, decim, 0, MAX_BLOCK, &st), 0, 0);
+
+	for (b = 0; b < sizeof(s_blocks) / sizeof(s_blocks[0]); b++) {
+		bytes = s_blocks[b] / 2 * 3;
+		for (i = 0; i < bytes; i++) {
+			s_iq12[i] = (uint8_t)rand();
+		}
+
+		xtrxdsp_iq12_sc32(s_iq12, s_sc32, bytes, 0);
+		ref_cnt = xtrxdsp_filter_work(&ref, s_sc32, s_ref, s_blocks[b]);
+		cnt = xtrxdsp_filter_work_iq12(&st, s_iq12, s_out, bytes);
+
+		i = b;
+		CHECK_F(ref_cnt, cnt, 0);
+		for (i = 0; i < cnt; i++) {
+			CHECK_F(s_ref[i], s_out[i], 1e-6);
+		}
+	}
+
+	xtrxdsp_filter_free(&ref);
+	xtrxdsp_filter_free(&st);
+	printf("%s decim %u: ok\n", name, decim);
+}
+
+int main(int argc, char** argv)
+{
+	srand(1);
+
+	for (unsigned decim = 0; decim < 3; decim++) {
+		test_work_iq16(decim);
+		test_work_iq12(decim);
+	}
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * xtrxdsp filters C++ interface test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+
+#include <vector>
+#include <utility>
+
+#include <xtrxdsp_filters.hpp>
+
+/* in T values, I/Q interleaved */
+#define BLOCK  1024
+#define BLOCKS 8
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "%s: expected %f (" #x ") got %f (" #y ") at %u!\n", name, (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+template <typename T>
+static std::vector<T> make_input()
+{
+	std::vector<T> in(BLOCK * BLOCKS);
+	for (auto& v : in) {
+		if constexpr (std::is_same_v<T, float>) {
+			v = (float)rand() / RAND_MAX * 2 - 1;
+		} else {
+			v = (int16_t)(rand() & 0xfff0);
+		}
+	}
+	return in;
+}
+
+template <typename T>
+static std::vector<T> run_c(const T* taps, unsigned count, const std::vector<T>& in)
+{
+	xtrxdsp::filter_state<T> f(taps, count, 1, 0, BLOCK);
+	/* C kernel may store one output past the returned count */
+	std::vector<T> out(in.size() / 2 + 2);
+	unsigned produced = 0;
+
+	for (unsigned b = 0; b < BLOCKS; b++) {
+		produced += f.work(in.data() + b * BLOCK, out.data() + produced, BLOCK);
+	}
+	out.resize(produced);
+	return out;
+}
+
+template <typename T, unsigned Taps>
+static void test_fir(const char* name, const T* taps, double eps)
+{
+	std::vector<T> in = make_input<T>();
+	std::vector<T> ref = run_c(taps, Taps, in);
+
+	xtrxdsp::fir<T, Taps, 2> f(taps);
+	std::vector<T> out(in.size() / 2);
+	unsigned produced = 0;
+
+	for (unsigned b = 0; b < BLOCKS; b++) {
+		produced += f.work(in.data() + b * BLOCK, out.data() + produced, BLOCK);
+	}
+
+	unsigned i = 0;
+	CHECK_F(ref.size(), produced, 0);
+
+	/* C delay line is always 64 samples, lag in I/Q values at 2x decimation */
+	const unsigned lag = 2 * ((64 - Taps) / 2);
+	for (i = 0; i + lag < produced; i++) {
+		CHECK_F(ref[i + lag], out[i], eps);
+	}
+}
+
+static void test_state_move()
+{
+	const char* name = "filter_state";
+	unsigned i = 0;
+	std::vector<float> in = make_input<float>();
+	std::vector<float> out_a(BLOCK), out_b(BLOCK);
+
+	xtrxdsp::filter_state<float> a(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, 0, BLOCK);
+	const void* taps_mem = a.get()->filter_taps;
+	a.work(in.data(), out_a.data(), BLOCK);
+
+	/* moved state keeps history and buffers */
+	xtrxdsp::filter_state<float> b(std::move(a));
+	CHECK_F(!!a, false, 0);
+	CHECK_F(b.get()->filter_taps == taps_mem, true, 0);
+
+	xtrxdsp::filter_state<float> c(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, 0, BLOCK);
+	c.work(in.data(), out_b.data(), BLOCK);
+	c = std::move(b);
+	CHECK_F(!!b, false, 0);
+	CHECK_F(!!c, true, 0);
+
+	unsigned na = c.work(in.data() + BLOCK, out_a.data(), BLOCK);
+
+	xtrxdsp::filter_state<float> d(g_filter_float_taps_64_2x, FILTER_TAPS_64, 1, 0, BLOCK);
+	d.work(in.data(), out_b.data(), BLOCK);
+	unsigned nb = d.work(in.data() + BLOCK, out_b.data(), BLOCK);
+
+	CHECK_F(na, nb, 0);
+	for (i = 0; i < na; i++) {
+		CHECK_F(out_a[i], out_b[i], 0);
+	}
+}
+
+static void test_state_error()
+{
+	const char* name = "filter_state error";
+	unsigned i = 0;
+	int err = 0;
+
+	try {
+		xtrxdsp::filter_state<int16_t> f(g_filter_int16_taps_64_2x, 65, 1, 0, BLOCK);
+	} catch (const std::system_error& e) {
+		err = e.code().value();
+	}
+	CHECK_F(err, EINVAL, 0);
+}
+
+int main(int argc, char** argv)
+{
+	int16_t taps_i32[32];
+	float taps_f32[32];
+
+	srand(1);
+	for (unsigned i = 0; i < 32; i++) {
+		taps_i32[i] = g_filter_int16_taps_64_2x[2 * i];
+		taps_f32[i] = g_filter_float_taps_64_2x[2 * i];
+	}
+
+	test_state_move();
+	test_state_error();
+
+	test_fir<float, 64>("fir<float, 64, 2>", g_filter_float_taps_64_2x, 1e-5);
+	test_fir<float, 32>("fir<float, 32, 2>", taps_f32, 1e-5);
+	test_fir<int16_t, 64>("fir<int16_t, 64, 2>", g_filter_int16_taps_64_2x, 1);
+	test_fir<int16_t, 32>("fir<int16_t, 32, 2>", taps_i32, 1);
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * xtrxdsp half precision converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <xtrxdsp.h>
+
+#define VALS 65536
+
+static int g_errors = 0;
+
+typedef void (*to_half_t)(const int16_t *__restrict, uint16_t *__restrict, float, size_t);
+typedef void (*from_half_t)(const uint16_t *__restrict, int16_t *__restrict, float, size_t);
+
+static double hc16_value(uint16_t h)
+{
+	int e = (h >> 10) & 0x1f;
+	double m = h & 0x3ff;
+	double v = (e == 0) ? ldexp(m, -24) : (e == 31) ? INFINITY : ldexp(1024 + m, e - 25);
+	return (h & 0x8000) ? -v : v;
+}
+
+static double bf16_value(uint16_t h)
+{
+	int e = (h >> 7) & 0xff;
+	double m = h & 0x7f;
+	double v = (e == 0) ? ldexp(m, -133) : (e == 255) ? INFINITY : ldexp(128 + m, e - 134);
+	return (h & 0x8000) ? -v : v;
+}
+
+/* result should be the closest representable value, ties to even */
+static int is_nearest(double (*value)(uint16_t), uint16_t h, double x)
+{
+	double v = value(h);
+	double d = fabs(v - x);
+	uint16_t mag = h & 0x7fff;
+
+	if (isinf(v)) {
+		double max = value((h & 0x8000) | (mag - 1));
+		double next = max + (max - value((h & 0x8000) | (mag - 2)));
+		return fabs(x) >= (fabs(max) + fabs(next)) / 2;
+	}
+	if (x != 0 && (x < 0) != ((h & 0x8000) != 0))
+		return 0;
+
+	double dn = (mag < 0x7fff) ? fabs(value(h + 1) - x) : INFINITY;
+	double dp = (mag > 0) ? fabs(value(h - 1) - x) : INFINITY;
+	if (d > dn || d > dp)
+		return 0;
+	if ((d == dn || d == dp) && (h & 1))
+		return 0;
+	return 1;
+}
+
+static int16_t ref_sat(double v)
+{
+	v = nearbyint(v);
+	return (v > 32767) ? 32767 : (v < -32768) ? -32768 : (int16_t)v;
+}
+
+static void test_to(const char* name, to_half_t func, double (*value)(uint16_t), float scale)
+{
+	static int16_t in[VALS];
+	static uint16_t out[VALS];
+
+	for (unsigned i = 0; i < VALS; i++)
+		in[i] = (int16_t)i;
+
+	/* odd byte count checks vector tails */
+	func(in, out, scale, 2 * VALS - 6);
+	for (unsigned i = 0; i < VALS - 3; i++) {
+		if (!is_nearest(value, out[i], (double)(in[i] * scale))) {
+			fprintf(stderr, "%s(%g): %d -> 0x%04x (%g) isn't nearest!\n", name, scale,
+					in[i], out[i], value(out[i]));
+			g_errors++;
+			return;
+		}
+	}
+	printf("%s(%g): ok\n", name, scale);
+}
+
+static void test_from(const char* name, from_half_t func, double (*value)(uint16_t), float scale)
+{
+	static uint16_t in[VALS];
+	static int16_t out[VALS];
+
+	for (unsigned i = 0; i < VALS; i++)
+		in[i] = i;
+
+	func(in, out, scale, 2 * VALS - 6);
+	for (unsigned i = 0; i < VALS - 3; i++) {
+		double v = value(in[i]);
+		if (isnan(v) || (in[i] & 0x7fff) > ((value == hc16_value) ? 0x7c00 : 0x7f80))
+			continue; /* NaN */
+		int16_t e = ref_sat((float)v * scale); /* float math as in converters */
+		if (e != out[i]) {
+			fprintf(stderr, "%s(%g): 0x%04x -> %d, expected %d!\n", name, scale, in[i], out[i], e);
+			g_errors++;
+			return;
+		}
+	}
+	printf("%s(%g): ok\n", name, scale);
+}
+
+static void test_variant(const char* name, to_half_t hc16, to_half_t bf16, from_half_t fhc16, from_half_t fbf16)
+{
+	static const float scales[] = { 1.0f/32768, 1.0f, 3.0f };
+	static const float tx_scales[] = { 32767.0f, 1.0f, 1e-3f };
+	char buf[64];
+
+	for (unsigned k = 0; k < 3; k++) {
+		if (hc16) {
+			snprintf(buf, sizeof(buf), "iq16_hc16_%s", name);
+			test_to(buf, hc16, hc16_value, scales[k]);
+			snprintf(buf, sizeof(buf), "hc16_iq16_%s", name);
+			test_from(buf, fhc16, hc16_value, tx_scales[k]);
+		}
+		if (bf16) {
+			snprintf(buf, sizeof(buf), "iq16_bf16_%s", name);
+			test_to(buf, bf16, bf16_value, scales[k]);
+			snprintf(buf, sizeof(buf), "bf16_iq16_%s", name);
+			test_from(buf, fbf16, bf16_value, tx_scales[k]);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	test_variant("no", xtrxdsp_iq16_hc16_no, xtrxdsp_iq16_bf16_no,
+				 xtrxdsp_hc16_iq16_no, xtrxdsp_bf16_iq16_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		test_variant("sse2", xtrxdsp_iq16_hc16_sse2, xtrxdsp_iq16_bf16_sse2,
+					 xtrxdsp_hc16_iq16_sse2, xtrxdsp_bf16_iq16_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		test_variant("avx", xtrxdsp_iq16_hc16_avx, xtrxdsp_iq16_bf16_avx,
+					 xtrxdsp_hc16_iq16_avx, xtrxdsp_bf16_iq16_avx);
+	}
+	if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) {
+		test_variant("avx_f16c", xtrxdsp_iq16_hc16_avx_f16c, NULL,
+					 xtrxdsp_hc16_iq16_avx_f16c, NULL);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
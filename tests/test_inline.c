@@ -0,0 +1,157 @@
+/*
+ * xtrxdsp header-only converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <xtrxdsp_inline.h>
+
+/* complex samples, multiple of every vector width and above conv64 window */
+#define SAMPLES 1024
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "%s: expected %f (" #x ") got %f (" #y ") at %u!\n", name, (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+#define CHECK_I(x, y) do { if ((x) != (y)) { fprintf(stderr, "%s: expected %d (" #x ") got %d (" #y ") at %u!\n", name, (int)(x), (int)(y), i); g_errors++; return; } } while(0)
+
+static int16_t s_iq16[2 * SAMPLES] __attribute__((aligned(64)));
+static int8_t  s_iq8[2 * SAMPLES] __attribute__((aligned(64)));
+static float   s_sc32[2 * SAMPLES] __attribute__((aligned(64)));
+static float   s_taps[64] __attribute__((aligned(64)));
+
+static float   s_fa[2 * SAMPLES] __attribute__((aligned(64)));
+static float   s_fb[2 * SAMPLES] __attribute__((aligned(64)));
+static float   s_fc[2 * SAMPLES] __attribute__((aligned(64)));
+static float   s_fd[2 * SAMPLES] __attribute__((aligned(64)));
+static int16_t s_ia[2 * SAMPLES] __attribute__((aligned(64)));
+static int16_t s_ib[2 * SAMPLES] __attribute__((aligned(64)));
+
+static void compare_f(const char* name, const float* a, const float* b, unsigned cnt, float eps)
+{
+	for (unsigned i = 0; i < cnt; i++) {
+		CHECK_F(a[i], b[i], eps);
+	}
+}
+
+static void compare_i(const char* name, const int16_t* a, const int16_t* b, unsigned cnt)
+{
+	for (unsigned i = 0; i < cnt; i++) {
+		CHECK_I(a[i], b[i]);
+	}
+}
+
+static void test_unpack()
+{
+	memset(s_fa, 0, sizeof(s_fa));
+	memset(s_fb, 0, sizeof(s_fb));
+	xtrxdsp_iq16_sc32(s_iq16, s_fa, 1.0f, sizeof(s_iq16));
+	xtrxdsp_iq16_sc32_inline(s_iq16, s_fb, 1.0f, sizeof(s_iq16));
+	compare_f("iq16_sc32", s_fa, s_fb, 2 * SAMPLES, 0);
+
+	memset(s_fa, 0, sizeof(s_fa));
+	memset(s_fb, 0, sizeof(s_fb));
+	xtrxdsp_iq8_sc32(s_iq8, s_fa, sizeof(s_iq8));
+	xtrxdsp_iq8_sc32_inline(s_iq8, s_fb, sizeof(s_iq8));
+	compare_f("iq8_sc32", s_fa, s_fb, 2 * SAMPLES, 0);
+
+	memset(s_fa, 0, sizeof(s_fa));
+	memset(s_fb, 0, sizeof(s_fb));
+	memset(s_fc, 0, sizeof(s_fc));
+	memset(s_fd, 0, sizeof(s_fd));
+	xtrxdsp_iq16_sc32i(s_iq16, s_fa, s_fc, 1.0f, sizeof(s_iq16));
+	xtrxdsp_iq16_sc32i_inline(s_iq16, s_fb, s_fd, 1.0f, sizeof(s_iq16));
+	compare_f("iq16_sc32i a", s_fa, s_fb, SAMPLES, 0);
+	compare_f("iq16_sc32i b", s_fc, s_fd, SAMPLES, 0);
+
+	const unsigned i = 0;
+	const char* name = "iq12_sc32";
+	uint64_t sa = xtrxdsp_iq12_sc32(s_iq16, s_fa, 3 * SAMPLES, 0);
+	uint64_t sb = xtrxdsp_iq12_sc32_inline(s_iq16, s_fb, 3 * SAMPLES, 0);
+	CHECK_I(sa, sb);
+	compare_f(name, s_fa, s_fb, 2 * SAMPLES, 0);
+}
+
+static void test_pack()
+{
+	memset(s_ia, 0, sizeof(s_ia));
+	memset(s_ib, 0, sizeof(s_ib));
+	xtrxdsp_sc32_iq16(s_sc32, s_ia, 32767.0f, sizeof(s_ia));
+	xtrxdsp_sc32_iq16_inline(s_sc32, s_ib, 32767.0f, sizeof(s_ib));
+	compare_i("sc32_iq16", s_ia, s_ib, 2 * SAMPLES);
+
+	memset(s_ia, 0, sizeof(s_ia));
+	memset(s_ib, 0, sizeof(s_ib));
+	xtrxdsp_sc32i_iq16(s_sc32, s_sc32 + SAMPLES, s_ia, 32767.0f, sizeof(s_ia));
+	xtrxdsp_sc32i_iq16_inline(s_sc32, s_sc32 + SAMPLES, s_ib, 32767.0f, sizeof(s_ib));
+	compare_i("sc32i_iq16", s_ia, s_ib, 2 * SAMPLES);
+
+	/* half floats, F16C path when built with -mf16c */
+	memset(s_ia, 0, sizeof(s_ia));
+	memset(s_ib, 0, sizeof(s_ib));
+	xtrxdsp_iq16_hc16(s_iq16, (uint16_t*)s_ia, 1.0f, sizeof(s_iq16));
+	xtrxdsp_iq16_hc16_inline(s_iq16, (uint16_t*)s_ib, 1.0f, sizeof(s_iq16));
+	compare_i("iq16_hc16", s_ia, s_ib, 2 * SAMPLES);
+}
+
+static void test_conv_nco()
+{
+	memset(s_fa, 0, sizeof(s_fa));
+	memset(s_fb, 0, sizeof(s_fb));
+	xtrxdsp_sc32_conv64(s_sc32, s_taps, s_fa, 2 * SAMPLES, 1);
+	xtrxdsp_sc32_conv64_inline(s_sc32, s_taps, s_fb, 2 * SAMPLES, 1);
+	compare_f("sc32_conv64", s_fa, s_fb, SAMPLES / 2, 1e-4);
+
+	const unsigned i = 0;
+	const char* name = "sc32_nco";
+	uint32_t pa = xtrxdsp_sc32_nco(s_sc32, s_fa, SAMPLES, 12345, 0x01234567);
+	uint32_t pb = xtrxdsp_sc32_nco_inline(s_sc32, s_fb, SAMPLES, 12345, 0x01234567);
+	CHECK_I(pa, pb);
+	compare_f(name, s_fa, s_fb, 2 * SAMPLES, 1e-4);
+
+	memset(s_fa, 0, sizeof(s_fa));
+	memset(s_fb, 0, sizeof(s_fb));
+	xtrxdsp_b8_expand_x2(s_sc32, s_fa, SAMPLES / 2);
+	xtrxdsp_b8_expand_x2_inline(s_sc32, s_fb, SAMPLES / 2);
+	compare_f("b8_expand_x2", s_fa, s_fb, 2 * SAMPLES, 0);
+}
+
+int main(int argc, char** argv)
+{
+	srand(1);
+	for (unsigned i = 0; i < 2 * SAMPLES; i++) {
+		s_iq16[i] = (int16_t)(rand() & 0xfff0);
+		s_iq8[i] = (int8_t)rand();
+		s_sc32[i] = (float)rand() / RAND_MAX * 2 - 1;
+	}
+	for (unsigned i = 0; i < 64; i++) {
+		s_taps[i] = (float)rand() / RAND_MAX / 32;
+	}
+
+	printf("Inline kernels: %s\n", XTRXDSP_INLINE_ISA);
+
+	test_unpack();
+	test_pack();
+	test_conv_nco();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
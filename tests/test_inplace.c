@@ -0,0 +1,138 @@
+/*
+ * xtrxdsp in-place converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xtrxdsp.h>
+
+#define VALS 4096
+
+static int g_errors = 0;
+
+typedef struct ip_funcs {
+	const char* name;
+	void (*iq16_ic16i)(int16_t *, int16_t *__restrict, size_t);
+	void (*iq8_ic8i)(int8_t *, int8_t *__restrict, size_t);
+	void (*ic16i_iq16)(int16_t *, const int16_t *__restrict, size_t);
+	void (*sc32_iq16)(void *, float, size_t);
+	void (*iq16_sc32)(void *, float, size_t);
+	void (*iq8_sc32)(void *, size_t);
+	void (*iq8_ic16)(void *, size_t);
+} ip_funcs_t;
+
+static int16_t s_iq16[VALS];
+
+#define CHECK_V(fn, x, y, i) do { if ((x) != (y)) { \
+	fprintf(stderr, "%s_%s: got %f expected %f at %u (%u samples)!\n", fn, f->name, \
+	        (double)(x), (double)(y), (unsigned)(i), (unsigned)n); \
+	g_errors++; return; } } while (0)
+
+/* n is number of scalar values, odd counts leave half of a pair unprocessed */
+static void test_size(const ip_funcs_t* f, unsigned n)
+{
+	static union { int16_t i16[2 * VALS]; int8_t i8[4 * VALS]; float f32[VALS]; } buf;
+	static int16_t q16[VALS];
+	static int8_t q8[VALS];
+	unsigned i, pairs = n / 2;
+
+	memcpy(buf.i16, s_iq16, n * sizeof(int16_t));
+	f->iq16_ic16i(buf.i16, q16, n * sizeof(int16_t));
+	for (i = 0; i < pairs; i++) {
+		CHECK_V("iq16_ic16i_ip", buf.i16[i], s_iq16[2 * i], i);
+		CHECK_V("iq16_ic16i_ip", q16[i], s_iq16[2 * i + 1], i);
+	}
+
+	f->ic16i_iq16(buf.i16, q16, pairs * 2 * sizeof(int16_t));
+	for (i = 0; i < 2 * pairs; i++)
+		CHECK_V("ic16i_iq16_ip", buf.i16[i], s_iq16[i], i);
+
+	for (i = 0; i < n; i++)
+		buf.i8[i] = (int8_t)s_iq16[i];
+	f->iq8_ic8i(buf.i8, q8, n);
+	for (i = 0; i < pairs; i++) {
+		CHECK_V("iq8_ic8i_ip", buf.i8[i], (int8_t)s_iq16[2 * i], i);
+		CHECK_V("iq8_ic8i_ip", q8[i], (int8_t)s_iq16[2 * i + 1], i);
+	}
+
+	for (i = 0; i < n; i++)
+		buf.i8[i] = (int8_t)s_iq16[i];
+	f->iq8_ic16(buf.i8, n);
+	for (i = 0; i < n; i++)
+		CHECK_V("iq8_ic16_ip", buf.i16[i], (int16_t)((int8_t)s_iq16[i] * 256), i);
+
+	for (i = 0; i < n; i++)
+		buf.i8[i] = (int8_t)s_iq16[i];
+	f->iq8_sc32(buf.i8, n);
+	for (i = 0; i < n; i++)
+		CHECK_V("iq8_sc32_ip", buf.f32[i], (int8_t)s_iq16[i] / 128.0f, i);
+
+	memcpy(buf.i16, s_iq16, n * sizeof(int16_t));
+	f->iq16_sc32(buf.i16, 1.0f / 32768, n * sizeof(int16_t));
+	for (i = 0; i < n; i++)
+		CHECK_V("iq16_sc32_ip", buf.f32[i], s_iq16[i] * (1.0f / 32768), i);
+
+	f->sc32_iq16(buf.f32, 32768, n * sizeof(int16_t));
+	for (i = 0; i < n; i++)
+		CHECK_V("sc32_iq16_ip", buf.i16[i], s_iq16[i], i);
+}
+
+static void test_variant(const ip_funcs_t* f)
+{
+	static const unsigned sizes[] = { 0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, VALS - 1, VALS };
+	unsigned k, errors = g_errors;
+
+	for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++)
+		test_size(f, sizes[k]);
+
+	if (errors == g_errors)
+		printf("ip_%s: ok\n", f->name);
+}
+
+#define IP_FUNCS(suffix) { #suffix, \
+	xtrxdsp_iq16_ic16i_ip_##suffix, xtrxdsp_iq8_ic8i_ip_##suffix, xtrxdsp_ic16i_iq16_ip_##suffix, \
+	xtrxdsp_sc32_iq16_ip_##suffix, xtrxdsp_iq16_sc32_ip_##suffix, xtrxdsp_iq8_sc32_ip_##suffix, \
+	xtrxdsp_iq8_ic16_ip_##suffix }
+
+int main(int argc, char** argv)
+{
+	unsigned i;
+
+	for (i = 0; i < VALS; i++)
+		s_iq16[i] = (int16_t)(i * 40503u);
+
+	const ip_funcs_t f_no = IP_FUNCS(no);
+	test_variant(&f_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		const ip_funcs_t f_sse2 = IP_FUNCS(sse2);
+		test_variant(&f_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		const ip_funcs_t f_avx = IP_FUNCS(avx);
+		test_variant(&f_avx);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
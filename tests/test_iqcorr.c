@@ -0,0 +1,357 @@
+/*
+ * xtrxdsp IQ correction test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <xtrxdsp_iqcorr.h>
+
+#define F_VALS 3001
+#define EST_BLOCK 4096
+
+typedef void (*conv_t)(const int16_t *__restrict, float *__restrict, const xtrxdsp_iqcorr_t *__restrict, xtrxdsp_iqcorr_stat_t *__restrict, size_t);
+typedef void (*convi_t)(const int16_t *__restrict, float *__restrict, float *__restrict, const xtrxdsp_iqcorr_t *__restrict, xtrxdsp_iqcorr_stat_t *__restrict, size_t);
+typedef uint64_t (*conv12_t)(const void *__restrict, float *__restrict, const xtrxdsp_iqcorr_t *__restrict, xtrxdsp_iqcorr_stat_t *__restrict, size_t, uint64_t);
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "Expected %f got %f at %u!\n", (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+/* blocks of odd sizes to check vector tails and iq12 carry */
+static const unsigned s_blocks[] = { 1, 7, 8, 13, 256, 257, 1000, 1459, 3 * F_VALS };
+
+static const xtrxdsp_iqcorr_t s_corr = {
+	1.0f/32768, 0.01f/32768, -0.05f/32768, 1.1f/32768, 0.003f, -0.007f, 0, 1, 1
+};
+
+static void test_corr(const char* name, conv_t func, convi_t funci, conv12_t func12)
+{
+	int16_t in[2*F_VALS];
+	uint8_t in12[3*F_VALS];
+	float out[2*F_VALS];
+	float outa[F_VALS];
+	float outb[F_VALS];
+	float out12[2*F_VALS];
+	xtrxdsp_iqcorr_est_t ref, est, esti, est12;
+	uint64_t state = 0;
+	unsigned i, n, b, m;
+
+	srand(1);
+	for (i = 0; i < F_VALS; i++) {
+		/* iq12 keeps only 12 MSBs */
+		in[2*i]     = (int16_t)(rand() & 0xfff0);
+		in[2*i + 1] = (int16_t)(rand() & 0xfff0);
+
+		uint16_t a = (uint16_t)in[2*i] >> 4;
+		uint16_t c = (uint16_t)in[2*i + 1] >> 4;
+		in12[3*i]     = a & 0xff;
+		in12[3*i + 1] = (a >> 8) | ((c & 0xf) << 4);
+		in12[3*i + 2] = c >> 4;
+	}
+
+	xtrxdsp_iqcorr_est_init(&ref, 1);
+	xtrxdsp_iqcorr_est_init(&est, 1);
+	xtrxdsp_iqcorr_est_init(&esti, 1);
+	xtrxdsp_iqcorr_est_init(&est12, 1);
+
+	func(in, out, &s_corr, &est.stat, sizeof(in));
+	funci(in, outa, outb, &s_corr, &esti.stat, sizeof(in));
+
+	/* carried bytes complete a sample at the start of the next block */
+	for (n = 0, b = 0; n < 3*F_VALS; n += m, b++) {
+		m = (3*F_VALS - n > s_blocks[b]) ? s_blocks[b] : 3*F_VALS - n;
+		state = func12(in12 + n, out12 + 2 * (n / 3), &s_corr, &est12.stat, m, state);
+	}
+
+	for (i = 0; i < F_VALS; i++) {
+		double vi = in[2*i], vq = in[2*i + 1];
+		double ei = s_corr.m_ii * vi + s_corr.m_iq * vq + s_corr.dc_i;
+		double eq = s_corr.m_qi * vi + s_corr.m_qq * vq + s_corr.dc_q;
+
+		CHECK_F(ei, out[2*i], 1e-5);
+		CHECK_F(eq, out[2*i + 1], 1e-5);
+		CHECK_F(ei, outa[i], 1e-5);
+		CHECK_F(eq, outb[i], 1e-5);
+		CHECK_F(ei, out12[2*i], 1e-5);
+		CHECK_F(eq, out12[2*i + 1], 1e-5);
+	}
+
+	/* statistics gathered in the conversion pass match a separate pass */
+	xtrxdsp_iqcorr_est_update(&ref, out, F_VALS);
+	i = 0;
+	if (est.stat.count != F_VALS || esti.stat.count != F_VALS || est12.stat.count != F_VALS) {
+		fprintf(stderr, "Expected %u samples in statistics!\n", F_VALS);
+		g_errors++;
+		return;
+	}
+	CHECK_F(ref.stat.sum_i, est.stat.sum_i, 1e-4);
+	CHECK_F(ref.stat.sum_q, est.stat.sum_q, 1e-4);
+	CHECK_F(ref.stat.sum_ii, est.stat.sum_ii, 1e-4);
+	CHECK_F(ref.stat.sum_qq, est.stat.sum_qq, 1e-4);
+	CHECK_F(ref.stat.sum_iq, est.stat.sum_iq, 1e-4);
+	CHECK_F(ref.stat.sum_i, esti.stat.sum_i, 1e-4);
+	CHECK_F(ref.stat.sum_q, esti.stat.sum_q, 1e-4);
+	CHECK_F(ref.stat.sum_ii, esti.stat.sum_ii, 1e-4);
+	CHECK_F(ref.stat.sum_qq, esti.stat.sum_qq, 1e-4);
+	CHECK_F(ref.stat.sum_iq, esti.stat.sum_iq, 1e-4);
+	CHECK_F(ref.stat.sum_i, est12.stat.sum_i, 1e-4);
+	CHECK_F(ref.stat.sum_q, est12.stat.sum_q, 1e-4);
+	CHECK_F(ref.stat.sum_ii, est12.stat.sum_ii, 1e-4);
+	CHECK_F(ref.stat.sum_qq, est12.stat.sum_qq, 1e-4);
+	CHECK_F(ref.stat.sum_iq, est12.stat.sum_iq, 1e-4);
+	printf("%s: ok\n", name);
+}
+
+/* tone with DC offsets, gain and phase imbalance */
+static void est_input(int16_t* in)
+{
+	const double gain = 1.2, phase = 0.15, dci = 900, dcq = -1500;
+
+	for (unsigned i = 0; i < EST_BLOCK; i++) {
+		double r = 2 * M_PI * 0.0123 * i;
+		in[2*i]     = lrint(16000 * cos(r) + dci);
+		in[2*i + 1] = lrint(16000 * gain * sin(r + phase) + dcq);
+	}
+}
+
+static int est_run(const int16_t* in, float* out, xtrxdsp_iqcorr_t* corr,
+				   xtrxdsp_iqcorr_est_t* est, unsigned iterations)
+{
+	for (unsigned it = 0; it < iterations; it++) {
+		xtrxdsp_iq16_sc32_corr(in, out, corr, &est->stat, 2 * EST_BLOCK * sizeof(int16_t));
+		if (xtrxdsp_iqcorr_est_apply(est, corr) != 0) {
+			fprintf(stderr, "Estimator apply failed!\n");
+			return -1;
+		}
+	}
+
+	xtrxdsp_iq16_sc32_corr(in, out, corr, NULL, 2 * EST_BLOCK * sizeof(int16_t));
+	return 0;
+}
+
+/* residual image and DC should be way below -60 dBc, power of output Q is
+ * expected to be ratio times power of output I
+ */
+static void est_check(const char* name, const float* out, double ratio)
+{
+	double mi = 0, mq = 0, pii = 0, pqq = 0, piq = 0;
+	unsigned i;
+
+	for (i = 0; i < EST_BLOCK; i++) {
+		mi += out[2*i];
+		mq += out[2*i + 1];
+		pii += out[2*i] * out[2*i];
+		pqq += out[2*i + 1] * out[2*i + 1];
+		piq += out[2*i] * out[2*i + 1];
+	}
+	mi /= EST_BLOCK; mq /= EST_BLOCK;
+	pii = pii / EST_BLOCK - mi * mi;
+	pqq = pqq / EST_BLOCK - mq * mq;
+	piq = piq / EST_BLOCK - mi * mq;
+
+	i = 0;
+	CHECK_F(0, mi / sqrt(pii), 1e-3);
+	CHECK_F(0, mq / sqrt(pqq), 1e-3);
+	CHECK_F(ratio, pqq / pii, 1e-3 * ratio);
+	CHECK_F(0, piq / sqrt(pii * pqq), 1e-3);
+	printf("%s: ok\n", name);
+}
+
+static void test_estimator()
+{
+	static int16_t in[2*EST_BLOCK];
+	static float out[2*EST_BLOCK];
+	xtrxdsp_iqcorr_t corr;
+	xtrxdsp_iqcorr_est_t est;
+
+	est_input(in);
+	xtrxdsp_iqcorr_init(&corr, 1.0f/32768);
+	if (xtrxdsp_iqcorr_est_init(&est, 0.5) != 0 ||
+			xtrxdsp_iqcorr_est_apply(&est, &corr) != -EAGAIN) {
+		fprintf(stderr, "Estimator init failed!\n");
+		g_errors++;
+		return;
+	}
+
+	if (est_run(in, out, &corr, &est, 40) != 0) {
+		g_errors++;
+		return;
+	}
+	est_check("estimator", out, 1);
+}
+
+/* output fixups survive whitening when the estimator knows about them */
+static void test_estimator_flags()
+{
+	static int16_t in[2*EST_BLOCK];
+	static float out[2*EST_BLOCK];
+	xtrxdsp_iqcorr_t corr;
+	xtrxdsp_iqcorr_est_t est;
+	unsigned flags;
+
+	est_input(in);
+	for (flags = 0; flags < 8; flags++) {
+		xtrxdsp_iqcorr_init(&corr, 1.0f/32768);
+		if (xtrxdsp_iqcorr_apply_flags(&corr, flags, 0.5f, 2.0f) != 0 ||
+				xtrxdsp_iqcorr_apply_flags(&corr, flags, 0, 2.0f) != -EINVAL ||
+				xtrxdsp_iqcorr_est_init(&est, 1) != 0) {
+			fprintf(stderr, "Estimator init failed!\n");
+			g_errors++;
+			return;
+		}
+
+		if (est_run(in, out, &corr, &est, 4) != 0) {
+			g_errors++;
+			return;
+		}
+		est_check("estimator flags", out, 16);
+
+		if (corr.flags != flags || corr.gain_i != 0.5f || corr.gain_q != 2.0f) {
+			fprintf(stderr, "Fixups lost with flags %u!\n", flags);
+			g_errors++;
+			return;
+		}
+
+		/* signs of I and Q show up in the rotation direction of the tone */
+		double rot = 0;
+		for (unsigned i = 1; i < EST_BLOCK; i++) {
+			rot += out[2*i - 2] * out[2*i + 1] - out[2*i - 1] * out[2*i];
+		}
+		int flips = !!(flags & XTRXDSP_IQCORR_SWAP_IQ) + !!(flags & XTRXDSP_IQCORR_NEG_I) +
+				!!(flags & XTRXDSP_IQCORR_NEG_Q);
+		if ((rot > 0) != !(flips & 1)) {
+			fprintf(stderr, "Wrong rotation direction with flags %u!\n", flags);
+			g_errors++;
+			return;
+		}
+	}
+}
+
+/* conversion with fixups matches plain conversion with fixups done afterwards */
+static void test_flags()
+{
+	int16_t in[2*F_VALS];
+	float ref[2*F_VALS];
+	float out[2*F_VALS];
+	xtrxdsp_iqcorr_t corr;
+	unsigned flags, i;
+
+	for (i = 0; i < 2*F_VALS; i++)
+		in[i] = (int16_t)(i * 40503u);
+
+	xtrxdsp_iq16_sc32(in, ref, 1.0f/32768, sizeof(in));
+
+	for (flags = 0; flags < 8; flags++) {
+		/* fixups set before are replaced */
+		xtrxdsp_iqcorr_init(&corr, 1.0f/32768);
+		xtrxdsp_iqcorr_apply_flags(&corr, 7 - flags, 3.0f, -0.25f);
+		xtrxdsp_iqcorr_apply_flags(&corr, flags, 0.5f, 2.0f);
+		xtrxdsp_iq16_sc32_corr(in, out, &corr, NULL, sizeof(in));
+
+		for (i = 0; i < F_VALS; i++) {
+			float ei = ref[2*i], eq = ref[2*i + 1], t;
+			if (flags & XTRXDSP_IQCORR_SWAP_IQ) {
+				t = ei; ei = eq; eq = t;
+			}
+			ei *= (flags & XTRXDSP_IQCORR_NEG_I) ? -0.5f : 0.5f;
+			eq *= (flags & XTRXDSP_IQCORR_NEG_Q) ? -2.0f : 2.0f;
+
+			CHECK_F(ei, out[2*i], 1e-6);
+			CHECK_F(eq, out[2*i + 1], 1e-6);
+		}
+	}
+	printf("flags: ok\n");
+}
+
+typedef void (*sc32_fixup_t)(float *, const xtrxdsp_iqcorr_t *__restrict, size_t);
+typedef void (*ic16_fixup_t)(int16_t *, const xtrxdsp_iqcorr_t *__restrict, size_t);
+
+/* fixup passes do the same as fixups folded into correction, every flag
+ * combination with unit gains, which take the shuffle and integer paths,
+ * and with others
+ */
+static void test_fixup(const char* name, sc32_fixup_t sc32_fixup, ic16_fixup_t ic16_fixup)
+{
+	static const float gains[][2] = { { 1, 1 }, { -1, 1 }, { 0.5f, 2.0f }, { 3.0f, -1.5f } };
+	int16_t in[2*F_VALS];
+	int16_t out16[2*F_VALS];
+	float ref[2*F_VALS];
+	float out[2*F_VALS];
+	xtrxdsp_iqcorr_t corr;
+	unsigned flags, g, i, n;
+
+	for (i = 0; i < 2*F_VALS; i++)
+		in[i] = (int16_t)(i * 40503u);
+	/* the most negative code saturates when negated */
+	in[0] = in[3] = -32768;
+
+	for (g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+		for (flags = 0; flags < 8; flags++) {
+			xtrxdsp_iqcorr_init(&corr, 1.0f/32768);
+			xtrxdsp_iqcorr_apply_flags(&corr, flags, gains[g][0], gains[g][1]);
+			xtrxdsp_iq16_sc32_corr_no(in, ref, &corr, NULL, sizeof(in));
+
+			/* odd sizes leave scalar tails */
+			for (n = 2*F_VALS - 6; n <= 2*F_VALS; n += 2) {
+				xtrxdsp_iq16_sc32_no(in, out, 1.0f/32768, n * sizeof(int16_t));
+				sc32_fixup(out, &corr, n * sizeof(float));
+				for (i = 0; i < n; i++)
+					CHECK_F(ref[i], out[i], 1e-6);
+
+				memcpy(out16, in, n * sizeof(int16_t));
+				ic16_fixup(out16, &corr, n * sizeof(int16_t));
+				for (i = 0; i < n; i++) {
+					double e = ref[i] * 32768;
+					e = (e > 32767) ? 32767 : (e < -32768) ? -32768 : (int)e;
+					CHECK_F(e, out16[i], 0);
+				}
+			}
+		}
+	}
+	printf("%s: ok\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	test_corr("corr_no", xtrxdsp_iq16_sc32_corr_no, xtrxdsp_iq16_sc32i_corr_no,
+			  xtrxdsp_iq12_sc32_corr_no);
+	test_fixup("fixup_no", xtrxdsp_sc32_fixup_no, xtrxdsp_ic16_fixup_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		test_corr("corr_sse2", xtrxdsp_iq16_sc32_corr_sse2, xtrxdsp_iq16_sc32i_corr_sse2,
+				  xtrxdsp_iq12_sc32_corr_sse2);
+		test_fixup("fixup_sse2", xtrxdsp_sc32_fixup_sse2, xtrxdsp_ic16_fixup_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		test_corr("corr_avx", xtrxdsp_iq16_sc32_corr_avx, xtrxdsp_iq16_sc32i_corr_avx,
+				  xtrxdsp_iq12_sc32_corr_avx);
+		test_fixup("fixup_avx", xtrxdsp_sc32_fixup_avx, xtrxdsp_ic16_fixup_avx);
+	}
+#endif
+	test_estimator();
+	test_estimator_flags();
+	test_flags();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
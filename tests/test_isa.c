@@ -0,0 +1,82 @@
+/*
+ * xtrxdsp kernel selection test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <xtrxdsp.h>
+
+static int g_errors = 0;
+
+#define CHECK(x) do { if (!(x)) { fprintf(stderr, "Check failed: " #x "\n"); g_errors++; } } while(0)
+
+static void test_variant_query(void)
+{
+	int16_t in[8] = { 0 };
+	float out[8];
+	const char *func, *variant;
+	unsigned i;
+	int found = 0;
+
+	CHECK(xtrxdsp_get_variant("xtrxdsp_no_such_function") == NULL);
+
+	xtrxdsp_iq16_sc32(in, out, 1.0f, sizeof(in));
+	CHECK(xtrxdsp_get_variant("xtrxdsp_iq16_sc32") != NULL);
+
+	for (i = 0; xtrxdsp_get_resolved(i, &func, &variant) == 0; i++) {
+		if (strcmp(func, "xtrxdsp_iq16_sc32") == 0)
+			found = (strcmp(variant, xtrxdsp_get_variant(func)) == 0);
+	}
+	CHECK(found);
+	CHECK(xtrxdsp_get_resolved(i, &func, &variant) == -ENOENT);
+}
+
+static void test_isa_limit(void)
+{
+	const char* v;
+
+	CHECK(xtrxdsp_set_isa((enum xtrxdsp_isa)100) == -EINVAL);
+
+	CHECK(xtrxdsp_set_isa(XTRXDSP_ISA_GENERIC) == 0);
+	CHECK(xtrxdsp_get_isa() == XTRXDSP_ISA_GENERIC);
+	CHECK(xtrxdsp_get_dispatch()->sc32_conv64 == xtrxdsp_sc32_conv64_no);
+	resolve_xtrxdsp_sc32_conv64();
+	v = xtrxdsp_get_variant("xtrxdsp_sc32_conv64");
+	CHECK(v && strcmp(v, "no") == 0);
+
+	CHECK(xtrxdsp_set_isa(XTRXDSP_ISA_SSE2) == 0);
+	resolve_xtrxdsp_sc32_conv64();
+	v = xtrxdsp_get_variant("xtrxdsp_sc32_conv64");
+	CHECK(v && (strcmp(v, "no") == 0 || strcmp(v, "sse2") == 0));
+
+	CHECK(xtrxdsp_set_isa(XTRXDSP_ISA_NATIVE) == 0);
+	CHECK(xtrxdsp_get_isa() == XTRXDSP_ISA_NATIVE);
+}
+
+int main(int argc, char** argv)
+{
+	test_variant_query();
+	test_isa_limit();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * xtrxdsp metering converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <xtrxdsp.h>
+
+#define F_VALS 1027
+
+static int g_errors = 0;
+
+#define CHECK(x, y, name) do { if ((x) != (y)) { fprintf(stderr, "%s: expected %lld got %lld (" #y ")!\n", name, (long long)(x), (long long)(y)); g_errors++; } } while(0)
+
+typedef struct variants {
+	const char* name;
+	void (*iq16_sc32)(const int16_t *__restrict, float *__restrict, float, xtrxdsp_meter_t *__restrict, size_t);
+	void (*iq16_sc32i)(const int16_t *__restrict, float *__restrict, float *__restrict, float, xtrxdsp_meter_t *__restrict, size_t);
+	void (*iq16_ic16i)(const int16_t *__restrict, int16_t *__restrict, int16_t *__restrict, xtrxdsp_meter_t *__restrict, size_t);
+	uint64_t (*iq12_sc32)(const void *__restrict, float *__restrict, xtrxdsp_meter_t *__restrict, size_t, uint64_t);
+	uint64_t (*iq12_sc32i)(const void *__restrict, float *__restrict, float *__restrict, xtrxdsp_meter_t *__restrict, size_t, uint64_t);
+	void (*iq8_sc32)(const int8_t *__restrict, float *__restrict, xtrxdsp_meter_t *__restrict, size_t);
+	void (*iq8_ic16)(const int8_t *__restrict, int16_t *__restrict, xtrxdsp_meter_t *__restrict, size_t);
+	void (*iq8_sc32i)(const int8_t *__restrict, float *__restrict, float *__restrict, xtrxdsp_meter_t *__restrict, size_t);
+	void (*iq8_ic16i)(const int8_t *__restrict, int16_t *__restrict, int16_t *__restrict, xtrxdsp_meter_t *__restrict, size_t);
+} variants_t;
+
+#define VARIANTS(sfx) { #sfx, \
+	xtrxdsp_iq16_sc32_meter_##sfx, xtrxdsp_iq16_sc32i_meter_##sfx, xtrxdsp_iq16_ic16i_meter_##sfx, \
+	xtrxdsp_iq12_sc32_meter_##sfx, xtrxdsp_iq12_sc32i_meter_##sfx, \
+	xtrxdsp_iq8_sc32_meter_##sfx, xtrxdsp_iq8_ic16_meter_##sfx, \
+	xtrxdsp_iq8_sc32i_meter_##sfx, xtrxdsp_iq8_ic16i_meter_##sfx }
+
+static int16_t s_iq16[2*F_VALS];
+static int16_t s_iq12v[2*F_VALS];
+static uint8_t s_iq12[3*F_VALS];
+static int8_t s_iq8[2*F_VALS];
+
+/* reference metering of int16 scaled values */
+static void ref_meter(xtrxdsp_meter_t* m, const int16_t* v, unsigned count, int32_t fs)
+{
+	memset(m, 0, sizeof(*m));
+	for (unsigned i = 0; i < 2 * count; i++) {
+		int32_t x = v[i];
+		uint32_t a = abs(x);
+		m->sumsq[i & 1] += (uint64_t)(x * x);
+		if (a > m->peak[i & 1])
+			m->peak[i & 1] = a;
+		m->clips[i & 1] += (x >= fs || x == -32768);
+	}
+	m->count = count;
+}
+
+static void check_meter(const char* name, const xtrxdsp_meter_t* e, const xtrxdsp_meter_t* m)
+{
+	for (unsigned ch = 0; ch < 2; ch++) {
+		CHECK(e->sumsq[ch], m->sumsq[ch], name);
+		CHECK(e->peak[ch], m->peak[ch], name);
+		CHECK(e->clips[ch], m->clips[ch], name);
+	}
+	CHECK(e->count, m->count, name);
+}
+
+static void check_floats(const char* name, const int16_t* v, unsigned stride, const float* a, const float* b, float scale)
+{
+	for (unsigned i = 0; i < F_VALS; i++) {
+		if (a[i * stride] != v[2*i] * scale || b[i * stride] != v[2*i + 1] * scale) {
+			fprintf(stderr, "%s: output mismatch at %u!\n", name, i);
+			g_errors++;
+			return;
+		}
+	}
+}
+
+static void test_meter(const variants_t* f)
+{
+	static float out[2*F_VALS], outa[F_VALS], outb[F_VALS];
+	static int16_t outi[2*F_VALS], outia[F_VALS], outib[F_VALS];
+	int16_t v8[2*F_VALS];
+	xtrxdsp_meter_t e, m;
+	uint64_t state = 0;
+	unsigned i, n, b, l;
+
+	/* odd split points for vector tails and iq12 carry */
+	static const unsigned blocks[] = { 1, 2, 5, 16, 33, 100, 3 * F_VALS };
+	/* complex samples */
+	static const unsigned small[] = { 1, 2, 3 };
+
+	ref_meter(&e, s_iq16, F_VALS, 0x7fff);
+	memset(&m, 0, sizeof(m));
+	f->iq16_sc32(s_iq16, out, 1.0f/32768, &m, 4 * F_VALS);
+	check_meter("iq16_sc32", &e, &m);
+	check_floats("iq16_sc32", s_iq16, 2, out, out + 1, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	f->iq16_sc32i(s_iq16, outa, outb, 1.0f/32768, &m, 4 * F_VALS);
+	check_meter("iq16_sc32i", &e, &m);
+	check_floats("iq16_sc32i", s_iq16, 1, outa, outb, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	f->iq16_ic16i(s_iq16, outia, outib, &m, 4 * F_VALS);
+	check_meter("iq16_ic16i", &e, &m);
+	for (i = 0; i < F_VALS; i++) {
+		CHECK(s_iq16[2*i], outia[i], "iq16_ic16i");
+		CHECK(s_iq16[2*i + 1], outib[i], "iq16_ic16i");
+	}
+
+	/* blocks shorter than a vector, vector loops never run */
+	memset(&m, 0, sizeof(m));
+	for (n = 0, b = 0; n < F_VALS; n += l, b++) {
+		l = (F_VALS - n > small[b % 3]) ? small[b % 3] : F_VALS - n;
+		f->iq16_sc32(s_iq16 + 2 * n, out + 2 * n, 1.0f/32768, &m, 4 * l);
+	}
+	check_meter("iq16_sc32 small", &e, &m);
+	check_floats("iq16_sc32 small", s_iq16, 2, out, out + 1, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	for (n = 0, b = 0; n < F_VALS; n += l, b++) {
+		l = (F_VALS - n > small[b % 3]) ? small[b % 3] : F_VALS - n;
+		f->iq16_sc32i(s_iq16 + 2 * n, outa + n, outb + n, 1.0f/32768, &m, 4 * l);
+	}
+	check_meter("iq16_sc32i small", &e, &m);
+	check_floats("iq16_sc32i small", s_iq16, 1, outa, outb, 1.0f/32768);
+
+	ref_meter(&e, s_iq12v, F_VALS, 0x7ff0);
+	memset(&m, 0, sizeof(m));
+	for (n = 0, b = 0; n < 3*F_VALS; n += blocks[b], b++) {
+		unsigned l = (3*F_VALS - n > blocks[b]) ? blocks[b] : 3*F_VALS - n;
+		state = f->iq12_sc32(s_iq12 + n, out + 2 * (n / 3), &m, l, state);
+	}
+	check_meter("iq12_sc32", &e, &m);
+	check_floats("iq12_sc32", s_iq12v, 2, out, out + 1, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	for (n = 0, b = 0; n < 3*F_VALS; n += blocks[b], b++) {
+		unsigned l = (3*F_VALS - n > blocks[b]) ? blocks[b] : 3*F_VALS - n;
+		state = f->iq12_sc32i(s_iq12 + n, outa + n / 3, outb + n / 3, &m, l, state);
+	}
+	check_meter("iq12_sc32i", &e, &m);
+	check_floats("iq12_sc32i", s_iq12v, 1, outa, outb, 1.0f/32768);
+
+	for (i = 0; i < 2*F_VALS; i++)
+		v8[i] = s_iq8[i] * 256;
+	ref_meter(&e, v8, F_VALS, 0x7f00);
+
+	memset(&m, 0, sizeof(m));
+	f->iq8_sc32(s_iq8, out, &m, 2 * F_VALS);
+	check_meter("iq8_sc32", &e, &m);
+	check_floats("iq8_sc32", v8, 2, out, out + 1, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	f->iq8_sc32i(s_iq8, outa, outb, &m, 2 * F_VALS);
+	check_meter("iq8_sc32i", &e, &m);
+	check_floats("iq8_sc32i", v8, 1, outa, outb, 1.0f/32768);
+
+	memset(&m, 0, sizeof(m));
+	f->iq8_ic16(s_iq8, outi, &m, 2 * F_VALS);
+	check_meter("iq8_ic16", &e, &m);
+	memset(&m, 0, sizeof(m));
+	f->iq8_ic16i(s_iq8, outia, outib, &m, 2 * F_VALS);
+	check_meter("iq8_ic16i", &e, &m);
+	for (i = 0; i < F_VALS; i++) {
+		CHECK(v8[2*i], outi[2*i], "iq8_ic16");
+		CHECK(v8[2*i + 1], outi[2*i + 1], "iq8_ic16");
+		CHECK(v8[2*i], outia[i], "iq8_ic16i");
+		CHECK(v8[2*i + 1], outib[i], "iq8_ic16i");
+	}
+
+	printf("meter_%s: done\n", f->name);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned i;
+
+	srand(2);
+	for (i = 0; i < 2*F_VALS; i++) {
+		s_iq16[i] = (int16_t)rand();
+		s_iq8[i] = (int8_t)rand();
+		s_iq12v[i] = (int16_t)(rand() & 0xfff0);
+	}
+	/* a few full scale hits on both channels */
+	s_iq16[10] = 32767; s_iq16[11] = -32768; s_iq16[2*F_VALS - 1] = -32768;
+	s_iq12v[20] = 0x7ff0; s_iq12v[33] = -32768; s_iq12v[2*F_VALS - 2] = 0x7ff0;
+	s_iq8[3] = 127; s_iq8[4] = -128;
+
+	for (i = 0; i < F_VALS; i++) {
+		uint16_t a = (uint16_t)s_iq12v[2*i] >> 4;
+		uint16_t c = (uint16_t)s_iq12v[2*i + 1] >> 4;
+		s_iq12[3*i]     = a & 0xff;
+		s_iq12[3*i + 1] = (a >> 8) | ((c & 0xf) << 4);
+		s_iq12[3*i + 2] = c >> 4;
+	}
+
+	const variants_t v_no = VARIANTS(no);
+	test_meter(&v_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		const variants_t v = VARIANTS(sse2);
+		test_meter(&v);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		const variants_t v = VARIANTS(avx);
+		test_meter(&v);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
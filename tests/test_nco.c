@@ -0,0 +1,178 @@
+/*
+ * xtrxdsp NCO test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <xtrxdsp_nco.h>
+
+#define F_VALS 3001
+#define FREQ   0.123456789
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "Expected %f got %f at %u!\n", (double)(x), (double)(y), i); g_errors++; return; } } while(0)
+
+/* blocks of odd sizes to check phase continuity and vector tails */
+static const unsigned s_blocks[] = { 1, 7, 8, 13, 256, 257, 1000, 1459 };
+
+static void test_nco_sc32(const char* name, func_xtrxdsp_sc32_nco_t func)
+{
+	float in[2*F_VALS];
+	float out[2*F_VALS];
+	uint32_t phase = 0x40000000; /* pi / 2 */
+	uint32_t dphase = (uint32_t)(int64_t)llround(FREQ * 4294967296.0);
+	unsigned i, n, b;
+
+	for (i = 0; i < F_VALS; i++) {
+		in[2*i]     = 0.5 + 0.001 * i;
+		in[2*i + 1] = -0.25;
+	}
+
+	for (n = 0, b = 0; n < F_VALS; n += s_blocks[b], b++) {
+		phase = func(in + 2*n, out + 2*n, s_blocks[b], phase, dphase);
+	}
+
+	for (i = 0; i < F_VALS; i++) {
+		double ph = M_PI / 2 + 2 * M_PI * ((double)dphase / 4294967296.0) * i;
+		double ei = in[2*i] * cos(ph) - in[2*i + 1] * sin(ph);
+		double eq = in[2*i] * sin(ph) + in[2*i + 1] * cos(ph);
+
+		CHECK_F(ei, out[2*i], 1e-5);
+		CHECK_F(eq, out[2*i + 1], 1e-5);
+	}
+	printf("%s: ok\n", name);
+}
+
+static void test_nco_ic16(const char* name, func_xtrxdsp_ic16_nco_t func)
+{
+	int16_t in[2*F_VALS];
+	int16_t out[2*F_VALS];
+	uint32_t phase = 0;
+	uint32_t dphase = (uint32_t)(int64_t)llround(-FREQ * 4294967296.0);
+	unsigned i, n, b;
+
+	for (i = 0; i < F_VALS; i++) {
+		in[2*i]     = 32767 - 10 * i;
+		in[2*i + 1] = 32767;
+	}
+
+	for (n = 0, b = 0; n < F_VALS; n += s_blocks[b], b++) {
+		phase = func(in + 2*n, out + 2*n, s_blocks[b], phase, dphase);
+	}
+
+	for (i = 0; i < F_VALS; i++) {
+		double ph = 2 * M_PI * ((double)(int32_t)dphase / 4294967296.0) * i;
+		double ei = in[2*i] * cos(ph) - in[2*i + 1] * sin(ph);
+		double eq = in[2*i] * sin(ph) + in[2*i + 1] * cos(ph);
+
+		/* saturation is expected */
+		ei = (ei > 32767) ? 32767 : (ei < -32768) ? -32768 : ei;
+		eq = (eq > 32767) ? 32767 : (eq < -32768) ? -32768 : eq;
+
+		CHECK_F(ei, out[2*i], 1.5);
+		CHECK_F(eq, out[2*i + 1], 1.5);
+	}
+	printf("%s: ok\n", name);
+}
+
+static void test_nco_iq16(const char* name, func_xtrxdsp_sc32_nco_iq16_t func)
+{
+	float in[2*F_VALS];
+	int16_t out[2*F_VALS];
+	uint32_t phase = 0;
+	uint32_t dphase = (uint32_t)(int64_t)llround(FREQ * 4294967296.0);
+	unsigned i, n, b;
+
+	for (i = 0; i < F_VALS; i++) {
+		in[2*i]     = 1.1 - 0.001 * i;
+		in[2*i + 1] = 0.3;
+	}
+
+	for (n = 0, b = 0; n < F_VALS; n += s_blocks[b], b++) {
+		phase = func(in + 2*n, out + 2*n, s_blocks[b], 32767, phase, dphase);
+	}
+
+	for (i = 0; i < F_VALS; i++) {
+		double ph = 2 * M_PI * ((double)dphase / 4294967296.0) * i;
+		double ei = 32767 * (in[2*i] * cos(ph) - in[2*i + 1] * sin(ph));
+		double eq = 32767 * (in[2*i] * sin(ph) + in[2*i + 1] * cos(ph));
+
+		ei = (ei > 32767) ? 32767 : (ei < -32768) ? -32768 : ei;
+		eq = (eq > 32767) ? 32767 : (eq < -32768) ? -32768 : eq;
+
+		CHECK_F(ei, out[2*i], 1.5);
+		CHECK_F(eq, out[2*i + 1], 1.5);
+	}
+	printf("%s: ok\n", name);
+}
+
+static void test_nco_state(void)
+{
+	xtrxdsp_nco_state_t state;
+	float in[2*F_VALS];
+	float out[2*F_VALS];
+	unsigned i;
+
+	if (xtrxdsp_nco_init(0.25, &state) != 0) {
+		g_errors++;
+		return;
+	}
+	if (xtrxdsp_nco_set_freq(&state, 0.75) != -EINVAL)
+		g_errors++;
+
+	for (i = 0; i < F_VALS; i++) {
+		in[2*i] = 1;
+		in[2*i + 1] = 0;
+	}
+	xtrxdsp_nco_work(&state, in, out, 100);
+	xtrxdsp_nco_work(&state, in + 200, out + 200, F_VALS - 100);
+
+	/* quarter sample rate: 1, j, -1, -j, ... */
+	for (i = 0; i < F_VALS; i++) {
+		CHECK_F((i % 4 == 0) ? 1 : (i % 4 == 2) ? -1 : 0, out[2*i], 1e-5);
+		CHECK_F((i % 4 == 1) ? 1 : (i % 4 == 3) ? -1 : 0, out[2*i + 1], 1e-5);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	test_nco_sc32("sc32_nco_no", xtrxdsp_sc32_nco_no);
+	test_nco_ic16("ic16_nco_no", xtrxdsp_ic16_nco_no);
+	test_nco_iq16("sc32_nco_iq16_no", xtrxdsp_sc32_nco_iq16_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		test_nco_sc32("sc32_nco_sse2", xtrxdsp_sc32_nco_sse2);
+		test_nco_ic16("ic16_nco_sse2", xtrxdsp_ic16_nco_sse2);
+		test_nco_iq16("sc32_nco_iq16_sse2", xtrxdsp_sc32_nco_iq16_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		test_nco_sc32("sc32_nco_avx", xtrxdsp_sc32_nco_avx);
+		test_nco_ic16("ic16_nco_avx", xtrxdsp_ic16_nco_avx);
+		test_nco_iq16("sc32_nco_iq16_avx", xtrxdsp_sc32_nco_iq16_avx);
+	}
+#endif
+	test_nco_state();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * xtrxdsp non-temporal store converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xtrxdsp.h>
+
+/* values per call, enough for several vector iterations plus odd tails */
+#define MAXVALS 203
+/* output misalignment in elements, covers every position of a 16 byte line */
+#define SHIFTS  8
+#define GUARD   8
+/* iq12 bytes, well past the staging block of the streaming kernel */
+#define IQ12_BYTES 30000
+
+static int g_errors = 0;
+
+typedef void (*iq16_sc32_t)(const int16_t *__restrict, float *__restrict, float, size_t);
+typedef void (*iq16_sc32i_t)(const int16_t *__restrict, float *__restrict, float *__restrict, float, size_t);
+typedef void (*sc32_iq16_t)(const float *__restrict, int16_t *__restrict, float, size_t);
+typedef uint64_t (*iq12_sc32_t)(const void *__restrict, float *__restrict, size_t, uint64_t);
+typedef void (*iq8_sc32_t)(const int8_t *__restrict, float *__restrict, size_t);
+
+static int16_t s_iq16[MAXVALS];
+static float s_sc32[MAXVALS];
+static uint8_t s_iq12[IQ12_BYTES];
+
+static float s_refa[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static float s_refb[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static float s_outa[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static float s_outb[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static int16_t s_ref16[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static int16_t s_out16[MAXVALS + SHIFTS + GUARD] __attribute__((aligned(16)));
+static float s_ref12[2 * IQ12_BYTES / 3 + SHIFTS + GUARD] __attribute__((aligned(16)));
+static float s_out12[2 * IQ12_BYTES / 3 + SHIFTS + GUARD] __attribute__((aligned(16)));
+
+static void prefill(void)
+{
+	memset(s_refa, 0x5a, sizeof(s_refa));
+	memset(s_refb, 0x5a, sizeof(s_refb));
+	memset(s_outa, 0x5a, sizeof(s_outa));
+	memset(s_outb, 0x5a, sizeof(s_outb));
+	memset(s_ref16, 0x5a, sizeof(s_ref16));
+	memset(s_out16, 0x5a, sizeof(s_out16));
+	memset(s_ref12, 0x5a, sizeof(s_ref12));
+	memset(s_out12, 0x5a, sizeof(s_out12));
+}
+
+/* the same stream in blocks of odd sizes, so the carry state gets exercised */
+static int test_iq12(const char* name, iq12_sc32_t iq12_sc32, unsigned s)
+{
+	static const unsigned blocks[] = { 1, 2, 3, 7, 100, 3071, 3072, 3073, 7001 };
+	uint64_t rstate = 0, state = 0;
+	unsigned n, b, m, o;
+
+	prefill();
+	for (n = 0, b = 0; n < IQ12_BYTES; n += m, b = (b + 1) % (sizeof(blocks) / sizeof(blocks[0]))) {
+		m = (IQ12_BYTES - n > blocks[b]) ? blocks[b] : IQ12_BYTES - n;
+		/* a sample carried from the previous block is written first */
+		o = 2 * (n / 3) + s;
+		rstate = xtrxdsp_iq12_sc32_no(s_iq12 + n, s_ref12 + o, m, rstate);
+		state = iq12_sc32(s_iq12 + n, s_out12 + o, m, state);
+		if (rstate != state) {
+			fprintf(stderr, "iq12_sc32_nt_%s: state mismatch at %u, +%u!\n", name, n, s);
+			return -1;
+		}
+	}
+	if (memcmp(s_ref12, s_out12, sizeof(s_ref12))) {
+		fprintf(stderr, "iq12_sc32_nt_%s: mismatch at +%u!\n", name, s);
+		return -1;
+	}
+	return 0;
+}
+
+/* NT kernels must store exactly what the regular generic kernels store,
+ * including nothing past the last value
+ */
+static void test_variant(const char* name, iq16_sc32_t iq16_sc32,
+						 iq16_sc32i_t iq16_sc32i, sc32_iq16_t sc32_iq16,
+						 iq12_sc32_t iq12_sc32, iq8_sc32_t iq8_sc32)
+{
+	const float scale = 1.0f / 32768;
+	unsigned n, s;
+
+	for (s = 0; s < SHIFTS; s++) {
+		for (n = 0; n <= MAXVALS; n++) {
+			prefill();
+			xtrxdsp_iq16_sc32_no(s_iq16, s_refa + s, scale, 2 * n);
+			iq16_sc32(s_iq16, s_outa + s, scale, 2 * n);
+			if (memcmp(s_refa, s_outa, sizeof(s_refa))) {
+				fprintf(stderr, "iq16_sc32_nt_%s: mismatch for %u values at +%u!\n", name, n, s);
+				g_errors++;
+				return;
+			}
+
+			prefill();
+			xtrxdsp_sc32_iq16_no(s_sc32, s_ref16 + s, 32768, 2 * n);
+			sc32_iq16(s_sc32, s_out16 + s, 32768, 2 * n);
+			if (memcmp(s_ref16, s_out16, sizeof(s_ref16))) {
+				fprintf(stderr, "sc32_iq16_nt_%s: mismatch for %u values at +%u!\n", name, n, s);
+				g_errors++;
+				return;
+			}
+
+			/* whole IQ pairs, outb checked both in and out of phase with outa */
+			if (n % 2)
+				continue;
+
+			prefill();
+			xtrxdsp_iq8_sc32_no((const int8_t*)s_iq16, s_refa + s, n);
+			iq8_sc32((const int8_t*)s_iq16, s_outa + s, n);
+			if (memcmp(s_refa, s_outa, sizeof(s_refa))) {
+				fprintf(stderr, "iq8_sc32_nt_%s: mismatch for %u values at +%u!\n", name, n, s);
+				g_errors++;
+				return;
+			}
+
+			prefill();
+			xtrxdsp_iq16_sc32i_no(s_iq16, s_refa + s, s_refb + (n / 2 + s) % SHIFTS, scale, 2 * n);
+			iq16_sc32i(s_iq16, s_outa + s, s_outb + (n / 2 + s) % SHIFTS, scale, 2 * n);
+			if (memcmp(s_refa, s_outa, sizeof(s_refa)) ||
+					memcmp(s_refb, s_outb, sizeof(s_refb))) {
+				fprintf(stderr, "iq16_sc32i_nt_%s: mismatch for %u pairs at +%u!\n", name, n / 2, s);
+				g_errors++;
+				return;
+			}
+		}
+
+		/* odd float offsets can't be aligned with whole samples and fall back */
+		if (test_iq12(name, iq12_sc32, s) != 0) {
+			g_errors++;
+			return;
+		}
+	}
+
+	printf("nt_%s: ok\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned i;
+
+	for (i = 0; i < MAXVALS; i++) {
+		s_iq16[i] = (int16_t)(i * 40503u);
+		/* in range, scalar paths truncate without saturation */
+		s_sc32[i] = (s_iq16[i] / 2 + 0.75f) * (1.0f / 16384);
+	}
+	for (i = 0; i < IQ12_BYTES; i++)
+		s_iq12[i] = (uint8_t)(i * 40503u >> 7);
+
+	test_variant("no", xtrxdsp_iq16_sc32_nt_no, xtrxdsp_iq16_sc32i_nt_no, xtrxdsp_sc32_iq16_nt_no,
+				 xtrxdsp_iq12_sc32_nt_no, xtrxdsp_iq8_sc32_nt_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		test_variant("sse2", xtrxdsp_iq16_sc32_nt_sse2, xtrxdsp_iq16_sc32i_nt_sse2, xtrxdsp_sc32_iq16_nt_sse2,
+					 xtrxdsp_iq12_sc32_nt_sse2, xtrxdsp_iq8_sc32_nt_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		test_variant("avx", xtrxdsp_iq16_sc32_nt_avx, xtrxdsp_iq16_sc32i_nt_avx, xtrxdsp_sc32_iq16_nt_avx,
+					 xtrxdsp_iq12_sc32_nt_avx, xtrxdsp_iq8_sc32_nt_avx);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * xtrxdsp N-way converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xtrxdsp.h>
+
+#define MAX_CHANS 8
+#define FRAMES    1003
+
+static int g_errors = 0;
+
+typedef struct nway_funcs {
+	const char* name;
+	void (*iq16_sc32n)(const int16_t *__restrict, float *const *__restrict, unsigned, float, size_t);
+	void (*iq16_ic16n)(const int16_t *__restrict, int16_t *const *__restrict, unsigned, size_t);
+	void (*iq12_sc32n)(const void *__restrict, float *const *__restrict, unsigned, size_t);
+	void (*iq8_sc32n)(const int8_t *__restrict, float *const *__restrict, unsigned, size_t);
+	void (*iq8_ic16n)(const int8_t *__restrict, int16_t *const *__restrict, unsigned, size_t);
+	void (*sc32n_iq16)(const float *const *__restrict, unsigned, int16_t *__restrict, float, size_t);
+	void (*ic16n_iq16)(const int16_t *const *__restrict, unsigned, int16_t *__restrict, size_t);
+} nway_funcs_t;
+
+static int16_t s_iq16[2 * MAX_CHANS * FRAMES];
+static uint8_t s_iq12[3 * MAX_CHANS * FRAMES];
+
+static float s_f[MAX_CHANS][2 * FRAMES + 1];
+static int16_t s_i[MAX_CHANS][2 * FRAMES + 1];
+static int16_t s_back[2 * MAX_CHANS * FRAMES + 2];
+
+#define CHECK_V(fn, x, y, c, k) do { if ((x) != (y)) { \
+	fprintf(stderr, "%s_%s: got %f expected %f at ch %u idx %u (%u chans)!\n", fn, f->name, \
+	        (double)(x), (double)(y), (unsigned)(c), (unsigned)(k), chans); \
+	g_errors++; return; } } while (0)
+
+/* sample k of channel c in the stream */
+#define IDX(c, k) (2 * (chans * ((k) / 2) + (c)) + ((k) & 1))
+
+static void test_chans(const nway_funcs_t* f, unsigned chans)
+{
+	float* fo[MAX_CHANS];
+	int16_t* io[MAX_CHANS];
+	const float* fi[MAX_CHANS];
+	const int16_t* ii[MAX_CHANS];
+	/* extra half frame checks that partial frames aren't touched */
+	size_t bytes16 = 4 * chans * FRAMES + 2 * chans;
+	unsigned c, k;
+
+	for (c = 0; c < chans; c++) {
+		fo[c] = s_f[c];
+		io[c] = s_i[c];
+		fi[c] = s_f[c];
+		ii[c] = s_i[c];
+		s_f[c][2 * FRAMES] = 12345;
+		s_i[c][2 * FRAMES] = 12345;
+	}
+
+	f->iq16_sc32n(s_iq16, fo, chans, 1.0f / 32768, bytes16);
+	for (c = 0; c < chans; c++) {
+		for (k = 0; k < 2 * FRAMES; k++)
+			CHECK_V("iq16_sc32n", s_f[c][k], s_iq16[IDX(c, k)] * (1.0f / 32768), c, k);
+		CHECK_V("iq16_sc32n", s_f[c][k], 12345, c, k);
+	}
+
+	memset(s_back, 0, sizeof(s_back));
+	f->sc32n_iq16(fi, chans, s_back, 32768, 4 * chans * FRAMES);
+	for (k = 0; k < 2 * chans * FRAMES; k++)
+		CHECK_V("sc32n_iq16", s_back[k], s_iq16[k], k % (2 * chans), k);
+
+	f->iq16_ic16n(s_iq16, io, chans, bytes16);
+	for (c = 0; c < chans; c++) {
+		for (k = 0; k < 2 * FRAMES; k++)
+			CHECK_V("iq16_ic16n", s_i[c][k], s_iq16[IDX(c, k)], c, k);
+		CHECK_V("iq16_ic16n", s_i[c][k], 12345, c, k);
+	}
+
+	memset(s_back, 0, sizeof(s_back));
+	f->ic16n_iq16(ii, chans, s_back, 4 * chans * FRAMES + 2);
+	for (k = 0; k < 2 * chans * FRAMES; k++)
+		CHECK_V("ic16n_iq16", s_back[k], s_iq16[k], k % (2 * chans), k);
+	CHECK_V("ic16n_iq16", s_back[k], 0, k % (2 * chans), k);
+
+	f->iq12_sc32n(s_iq12, fo, chans, 3 * chans * FRAMES + 1);
+	for (c = 0; c < chans; c++)
+		for (k = 0; k < 2 * FRAMES; k++)
+			CHECK_V("iq12_sc32n", s_f[c][k], (s_iq16[IDX(c, k)] & ~0xf) * (1.0f / 32768), c, k);
+
+	f->iq8_sc32n((const int8_t*)s_iq16, fo, chans, 2 * chans * FRAMES);
+	for (c = 0; c < chans; c++)
+		for (k = 0; k < 2 * FRAMES; k++)
+			CHECK_V("iq8_sc32n", s_f[c][k], ((const int8_t*)s_iq16)[IDX(c, k)] / 128.0f, c, k);
+
+	f->iq8_ic16n((const int8_t*)s_iq16, io, chans, 2 * chans * FRAMES);
+	for (c = 0; c < chans; c++)
+		for (k = 0; k < 2 * FRAMES; k++)
+			CHECK_V("iq8_ic16n", s_i[c][k], (int16_t)(((const int8_t*)s_iq16)[IDX(c, k)] * 256), c, k);
+}
+
+/* iq16_sc32i splits alternate 16 bit words (A.I B.I A.Q B.Q), two channel
+ * frames are A.I A.Q B.I B.Q, so they match once the middle words are swapped
+ */
+static void test_sc32i_layout(void)
+{
+	float* fo[2] = { s_f[0], s_f[1] };
+	unsigned k;
+
+	for (k = 0; k < 4 * FRAMES; k += 4) {
+		s_back[k]     = s_iq16[k];
+		s_back[k + 1] = s_iq16[k + 2];
+		s_back[k + 2] = s_iq16[k + 1];
+		s_back[k + 3] = s_iq16[k + 3];
+	}
+
+	xtrxdsp_iq16_sc32i(s_iq16, s_f[2], s_f[3], 1.0f / 32768, 8 * FRAMES);
+	xtrxdsp_iq16_sc32n(s_back, fo, 2, 1.0f / 32768, 8 * FRAMES);
+	if (memcmp(s_f[0], s_f[2], 2 * FRAMES * sizeof(float)) ||
+			memcmp(s_f[1], s_f[3], 2 * FRAMES * sizeof(float))) {
+		fprintf(stderr, "iq16_sc32n: 2 channel layout doesn't match iq16_sc32i!\n");
+		g_errors++;
+	}
+}
+
+static void test_variant(const nway_funcs_t* f)
+{
+	unsigned chans, errors = g_errors;
+
+	for (chans = 1; chans <= MAX_CHANS; chans++)
+		test_chans(f, chans);
+
+	if (errors == g_errors)
+		printf("nway_%s: ok\n", f->name);
+}
+
+#define NWAY_FUNCS(suffix) { #suffix, \
+	xtrxdsp_iq16_sc32n_##suffix, xtrxdsp_iq16_ic16n_##suffix, xtrxdsp_iq12_sc32n_##suffix, \
+	xtrxdsp_iq8_sc32n_##suffix, xtrxdsp_iq8_ic16n_##suffix, xtrxdsp_sc32n_iq16_##suffix, \
+	xtrxdsp_ic16n_iq16_##suffix }
+
+int main(int argc, char** argv)
+{
+	unsigned i;
+
+	for (i = 0; i < 2 * MAX_CHANS * FRAMES; i++)
+		s_iq16[i] = (int16_t)(i * 40503u);
+
+	for (i = 0; i < MAX_CHANS * FRAMES; i++) {
+		uint16_t a = (uint16_t)s_iq16[2*i] >> 4;
+		uint16_t c = (uint16_t)s_iq16[2*i + 1] >> 4;
+		s_iq12[3*i]     = a & 0xff;
+		s_iq12[3*i + 1] = (a >> 8) | ((c & 0xf) << 4);
+		s_iq12[3*i + 2] = c >> 4;
+	}
+
+	test_sc32i_layout();
+
+	const nway_funcs_t f_no = NWAY_FUNCS(no);
+	test_variant(&f_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		const nway_funcs_t f_sse2 = NWAY_FUNCS(sse2);
+		test_variant(&f_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		const nway_funcs_t f_avx = NWAY_FUNCS(avx);
+		test_variant(&f_avx);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * xtrxdsp kernel planner test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <xtrxdsp_plan.h>
+
+#define SAMPLES 1024
+
+static int g_errors = 0;
+
+#define CHECK(x) do { if (!(x)) { fprintf(stderr, "Check failed: " #x "\n"); g_errors++; } } while(0)
+
+static void test_candidates(void)
+{
+	xtrxdsp_kernel_t fn[8];
+	const char* variant[8];
+	xtrxdsp_dispatch_t t = *xtrxdsp_get_dispatch();
+	int cnt;
+
+	CHECK(xtrxdsp_get_candidates("xtrxdsp_no_such_function", fn, variant, 8) == -EINVAL);
+
+	cnt = xtrxdsp_get_candidates("xtrxdsp_iq16_sc32", fn, variant, 8);
+	CHECK(cnt >= 1);
+	if (cnt < 1)
+		return;
+
+	/* generic is always there and is the last resort */
+	CHECK(strcmp(variant[cnt - 1], "no") == 0);
+	CHECK(fn[cnt - 1] == (xtrxdsp_kernel_t)xtrxdsp_iq16_sc32_no);
+	CHECK(xtrxdsp_get_candidates("xtrxdsp_iq16_sc32", fn, variant, 1) == 1);
+
+	CHECK(xtrxdsp_dispatch_bind(&t, "xtrxdsp_iq16_sc32", "no") == 0);
+	CHECK(t.iq16_sc32 == xtrxdsp_iq16_sc32_no);
+	CHECK(xtrxdsp_dispatch_bind(&t, "xtrxdsp_iq16_sc32", "bogus") == -ENOENT);
+	CHECK(xtrxdsp_dispatch_bind(&t, "xtrxdsp_bogus", "no") == -EINVAL);
+}
+
+static void test_plan(void)
+{
+	xtrxdsp_plan_t plan;
+	const xtrxdsp_plan_entry_t* e;
+	xtrxdsp_kernel_t fn;
+	const char* variant;
+	int16_t in[2*SAMPLES];
+	float a[2*SAMPLES], b[2*SAMPLES];
+	unsigned i;
+
+	xtrxdsp_plan_init(&plan);
+	CHECK(xtrxdsp_plan_find(&plan, "xtrxdsp_iq16_sc32") == NULL);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_bogus", sizeof(in), 0) == -EINVAL);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq16_sc32", 0, 0) == -EINVAL);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_sc32_nco", sizeof(in), 0) == -ENOTSUP);
+
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq16_sc32", sizeof(in), XTRXDSP_PLAN_MEASURE) == 0);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_sc32_iq16", sizeof(in), XTRXDSP_PLAN_MEASURE) == 0);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq12_sc32", 3 * 256, XTRXDSP_PLAN_ESTIMATE) == 0);
+	/* replanning replaces the entry */
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq16_sc32", 4 * sizeof(in), XTRXDSP_PLAN_MEASURE) == 0);
+	CHECK(plan.count == 3);
+
+	for (i = 0; i < plan.count; i++) {
+		printf("%-20s %8u bytes: %-8s %10.1f ns\n", plan.entry[i].func,
+			   (unsigned)plan.entry[i].bytes, plan.entry[i].variant, plan.entry[i].ns);
+	}
+
+	/* estimate takes the best candidate without measuring */
+	e = xtrxdsp_plan_find(&plan, "xtrxdsp_iq12_sc32");
+	CHECK(xtrxdsp_get_candidates("xtrxdsp_iq12_sc32", &fn, &variant, 1) == 1);
+	CHECK(e && e->ns == 0 && strcmp(e->variant, variant) == 0);
+
+	e = xtrxdsp_plan_find(&plan, "xtrxdsp_iq16_sc32");
+	CHECK(e && e->bytes == 4 * sizeof(in));
+
+	for (i = 0; i < 2*SAMPLES; i++)
+		in[i] = (int16_t)(i * 311 - 12000);
+
+	plan.k.iq16_sc32(in, a, 1.0f / 32768, sizeof(in));
+	xtrxdsp_iq16_sc32_no(in, b, 1.0f / 32768, sizeof(in));
+	for (i = 0; i < 2*SAMPLES; i++)
+		CHECK(a[i] == b[i]);
+}
+
+static void test_wisdom(void)
+{
+	char path[] = "/tmp/xtrxdsp_wisdom_XXXXXX";
+	xtrxdsp_plan_t plan, loaded;
+	const xtrxdsp_plan_entry_t* e;
+	unsigned i;
+	FILE* f;
+	int fd;
+
+	fd = mkstemp(path);
+	CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+
+	xtrxdsp_plan_init(&plan);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq16_sc32", 8192, 0) == 0);
+	CHECK(xtrxdsp_plan_func(&plan, "xtrxdsp_iq8_sc32", 2048, 0) == 0);
+	CHECK(xtrxdsp_plan_export(&plan, path) == 0);
+
+	xtrxdsp_plan_init(&loaded);
+	CHECK(xtrxdsp_plan_import(&loaded, path) == 0);
+	CHECK(loaded.count == plan.count);
+	for (i = 0; i < plan.count; i++) {
+		e = xtrxdsp_plan_find(&loaded, plan.entry[i].func);
+		CHECK(e && e->bytes == plan.entry[i].bytes &&
+			  strcmp(e->variant, plan.entry[i].variant) == 0);
+	}
+	CHECK(loaded.k.iq16_sc32 == plan.k.iq16_sc32);
+	CHECK(loaded.k.iq8_sc32 == plan.k.iq8_sc32);
+
+	/* known size is not measured again */
+	e = xtrxdsp_plan_find(&loaded, "xtrxdsp_iq16_sc32");
+	if (e && e->ns > 0) {
+		double ns = e->ns;
+		CHECK(xtrxdsp_plan_func(&loaded, "xtrxdsp_iq16_sc32", 8192, 0) == 0);
+		CHECK(e->ns == ns);
+	}
+
+	f = fopen(path, "w");
+	fprintf(f, "xtrxdsp-wisdom 1\ncpu some other cpu\nversion 0.0.0\n");
+	fclose(f);
+	CHECK(xtrxdsp_plan_import(&loaded, path) == -ESTALE);
+
+	f = fopen(path, "w");
+	fprintf(f, "not a wisdom file\n");
+	fclose(f);
+	CHECK(xtrxdsp_plan_import(&loaded, path) == -EINVAL);
+
+	unlink(path);
+	CHECK(xtrxdsp_plan_import(&loaded, path) == -ENOENT);
+}
+
+int main(int argc, char** argv)
+{
+	test_candidates();
+	test_plan();
+	test_wisdom();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * xtrxdsp resampler test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <xtrxdsp_resampler.h>
+
+#define BLOCK  1000
+#define BLOCKS 20
+#define TONE   0.01
+
+static int g_errors = 0;
+
+#define CHECK_F(x, y, eps) do { if (fabs((x) - (y)) > (eps)) { fprintf(stderr, "Expected %f (" #x ") got %f (" #y ")!\n", (double)(x), (double)(y)); g_errors++; } } while(0)
+
+static void tone(float* out, unsigned first, unsigned count)
+{
+	for (unsigned i = 0; i < count; i++) {
+		out[2*i]     = cos(2 * M_PI * TONE * (first + i));
+		out[2*i + 1] = sin(2 * M_PI * TONE * (first + i));
+	}
+}
+
+void test_resampler_unity()
+{
+	xtrxdsp_resampler_state_t state;
+	float in[2*BLOCK];
+	float out[2*BLOCK + 4];
+	unsigned cnt, total = 0;
+
+	CHECK_F(xtrxdsp_resampler_init(1.0, &state), 0, 0);
+
+	/* too short to stitch history, must be left alone */
+	tone(in, 0, BLOCK);
+	cnt = xtrxdsp_resampler_work(&state, in, out, XTRXDSP_RESAMPLER_HISTORY - 1);
+	CHECK_F(cnt, 0, 0);
+
+	for (unsigned b = 0; b < 2; b++) {
+		tone(in, b * BLOCK, BLOCK);
+		cnt = xtrxdsp_resampler_work(&state, in, out, BLOCK);
+		CHECK_F(cnt, BLOCK, 0);
+
+		/* two samples delay */
+		for (unsigned i = (b == 0) ? 2 : 0; i < cnt; i++) {
+			CHECK_F(out[2*i],     cos(2 * M_PI * TONE * (total + i - 2)), 1e-5);
+			CHECK_F(out[2*i + 1], sin(2 * M_PI * TONE * (total + i - 2)), 1e-5);
+		}
+		total += cnt;
+	}
+}
+
+void test_resampler_drift()
+{
+	xtrxdsp_resampler_state_t state;
+	float in[2*BLOCK];
+	float out[4*BLOCK];
+	double ratio = 0.8;
+	double pos = -2; /* input time of the first output */
+	unsigned cnt, maxcnt;
+
+	CHECK_F(xtrxdsp_resampler_init(ratio, &state), 0, 0);
+
+	for (unsigned b = 0; b < BLOCKS; b++) {
+		/* a few hundred ppm per block, way more than we'd see in practice */
+		ratio *= (b & 1) ? 1.0002 : 0.9999;
+		CHECK_F(xtrxdsp_resampler_set_ratio(&state, ratio), 0, 0);
+
+		tone(in, b * BLOCK, BLOCK);
+		maxcnt = xtrxdsp_resampler_max_out(&state, BLOCK);
+		cnt = xtrxdsp_resampler_work(&state, in, out, BLOCK);
+		if (cnt > maxcnt) {
+			fprintf(stderr, "Produced %u samples, max %u!\n", cnt, maxcnt);
+			g_errors++;
+		}
+
+		for (unsigned i = 0; i < cnt; i++, pos += ratio) {
+			if (pos < 2)
+				continue;
+			CHECK_F(out[2*i],     cos(2 * M_PI * TONE * pos), 1e-4);
+			CHECK_F(out[2*i + 1], sin(2 * M_PI * TONE * pos), 1e-4);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	test_resampler_unity();
+	test_resampler_drift();
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * xtrxdsp complex double converters test file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <xtrxdsp.h>
+
+#define VALS 65536
+
+static int g_errors = 0;
+
+typedef void (*iq16_sc64_t)(const int16_t *__restrict, double *__restrict, double, size_t);
+typedef uint64_t (*iq12_sc64_t)(const void *__restrict, double *__restrict, size_t, uint64_t);
+typedef void (*sc64_iq16_t)(const double *__restrict, int16_t *__restrict, double, size_t);
+
+static int16_t s_iq16[VALS];
+static uint8_t s_iq12[3 * VALS / 2];
+
+static void test_variant(const char* name, iq16_sc64_t iq16, iq12_sc64_t iq12, sc64_iq16_t tx)
+{
+	static double out[VALS];
+	static int16_t back[VALS];
+	static const unsigned blocks[] = { 1, 2, 4, 17, 1000, 3 * VALS / 2 };
+	const double scale = 1.0 / 32768;
+	uint64_t state = 0;
+	unsigned i, n, b;
+
+	/* odd byte count checks vector tails */
+	iq16(s_iq16, out, scale, 2 * VALS - 6);
+	for (i = 0; i < VALS - 3; i++) {
+		if (out[i] != s_iq16[i] * scale) {
+			fprintf(stderr, "iq16_sc64_%s: %d -> %f!\n", name, s_iq16[i], out[i]);
+			g_errors++;
+			return;
+		}
+	}
+
+	/* shifted by half LSB to check rounding, scaled over full range to check saturation */
+	for (i = 0; i < VALS; i++)
+		out[i] = (s_iq16[i] + 0.25) * (1.0 / 16384);
+	tx(out, back, 16384, 2 * VALS - 6);
+	for (i = 0; i < VALS - 3; i++) {
+		if (back[i] != s_iq16[i]) {
+			fprintf(stderr, "sc64_iq16_%s: %f -> %d!\n", name, out[i], back[i]);
+			g_errors++;
+			return;
+		}
+	}
+	tx(out, back, 2 * 16384, 2 * VALS);
+	for (i = 0; i < VALS; i++) {
+		int e = (int)lrint(out[i] * 2 * 16384);
+		e = (e > 32767) ? 32767 : (e < -32768) ? -32768 : e;
+		if (back[i] != e) {
+			fprintf(stderr, "sc64_iq16_%s: %f -> %d, expected %d!\n", name, out[i], back[i], e);
+			g_errors++;
+			return;
+		}
+	}
+
+	for (n = 0, b = 0; n < 3 * VALS / 2; n += blocks[b], b++) {
+		unsigned l = (3 * VALS / 2 - n > blocks[b]) ? blocks[b] : 3 * VALS / 2 - n;
+		state = iq12(s_iq12 + n, out + 2 * (n / 3), l, state);
+	}
+	for (i = 0; i < VALS; i++) {
+		if (out[i] != (s_iq16[i] & ~0xf) * scale) {
+			fprintf(stderr, "iq12_sc64_%s: %d -> %f at %u!\n", name, s_iq16[i] & ~0xf, out[i], i);
+			g_errors++;
+			return;
+		}
+	}
+
+	printf("sc64_%s: ok\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned i;
+
+	for (i = 0; i < VALS; i++)
+		s_iq16[i] = (int16_t)(i * 40503u);
+
+	for (i = 0; i < VALS / 2; i++) {
+		uint16_t a = (uint16_t)s_iq16[2*i] >> 4;
+		uint16_t c = (uint16_t)s_iq16[2*i + 1] >> 4;
+		s_iq12[3*i]     = a & 0xff;
+		s_iq12[3*i + 1] = (a >> 8) | ((c & 0xf) << 4);
+		s_iq12[3*i + 2] = c >> 4;
+	}
+
+	test_variant("no", xtrxdsp_iq16_sc64_no, xtrxdsp_iq12_sc64_no, xtrxdsp_sc64_iq16_no);
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2")) {
+		test_variant("sse2", xtrxdsp_iq16_sc64_sse2, xtrxdsp_iq12_sc64_sse2, xtrxdsp_sc64_iq16_sse2);
+	}
+	if (__builtin_cpu_supports("avx")) {
+		test_variant("avx", xtrxdsp_iq16_sc64_avx, xtrxdsp_iq12_sc64_avx, xtrxdsp_sc64_iq16_avx);
+	}
+#endif
+
+	printf("Total errors: %d\n", g_errors);
+	return (g_errors) ? 1 : 0;
+}
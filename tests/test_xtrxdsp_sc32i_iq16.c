@@ -56,9 +56,86 @@ void test_xtrxdsp_sc32i_iq16()
 	}
 }
 
+/* SSE2 iq16 converters pick aligned stores when the outputs are 16 byte
+ * aligned; both paths should give the same result as the generic code
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define IQ16_SC32   xtrxdsp_iq16_sc32_sse2
+#define IQ16_SC32I  xtrxdsp_iq16_sc32i_sse2
+#else
+#define IQ16_SC32   xtrxdsp_iq16_sc32_no
+#define IQ16_SC32I  xtrxdsp_iq16_sc32i_no
+#endif
+
+void test_xtrxdsp_iq16_sc32_aligned()
+{
+	static const size_t sizes[] = { 4*F_VALS, 4*F_VALS - 4, 4*F_VALS - 6 };
+	const float scale = 1.0f / 32768;
+	int16_t* in = (int16_t*)xtrxdsp_aligned_alloc(2*F_VALS * sizeof(int16_t));
+	float* ref = (float*)xtrxdsp_aligned_alloc((2*F_VALS + 8) * sizeof(float));
+	float* refb = (float*)xtrxdsp_aligned_alloc((F_VALS + 8) * sizeof(float));
+	float* out = (float*)xtrxdsp_aligned_alloc((2*F_VALS + 8) * sizeof(float));
+	float* outb = (float*)xtrxdsp_aligned_alloc((F_VALS + 8) * sizeof(float));
+	unsigned offa, offb, k;
+	int i;
+
+	if (!in || !ref || !refb || !out || !outb) {
+		fprintf(stderr, "Unable to allocate aligned buffers!\n");
+		g_errors++;
+		goto done;
+	}
+	if ((uintptr_t)in % XTRXDSP_ALIGN || (uintptr_t)out % XTRXDSP_ALIGN ||
+			(uintptr_t)outb % XTRXDSP_ALIGN) {
+		fprintf(stderr, "Buffers aren't aligned!\n");
+		g_errors++;
+	}
+
+	for (i = 0; i < 2*F_VALS; i++)
+		in[i] = (int16_t)(i * 40503u);
+
+	/* offset 0 takes the aligned stores, the rest the unaligned ones */
+	for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+		for (offa = 0; offa < 4; offa++) {
+			memset(ref, 0, (2*F_VALS + 8) * sizeof(float));
+			memset(out, 0, (2*F_VALS + 8) * sizeof(float));
+			xtrxdsp_iq16_sc32_no(in, ref + offa, scale, sizes[k]);
+			IQ16_SC32(in, out + offa, scale, sizes[k]);
+			if (memcmp(ref, out, (2*F_VALS + 8) * sizeof(float))) {
+				fprintf(stderr, "iq16_sc32: mismatch for %u bytes at +%u!\n",
+						(unsigned)sizes[k], offa);
+				g_errors++;
+			}
+
+			/* sc32i stores aligned only when both outputs are aligned */
+			for (offb = 0; offb < 4; offb++) {
+				memset(ref, 0, (F_VALS + 8) * sizeof(float));
+				memset(out, 0, (F_VALS + 8) * sizeof(float));
+				memset(refb, 0, (F_VALS + 8) * sizeof(float));
+				memset(outb, 0, (F_VALS + 8) * sizeof(float));
+				xtrxdsp_iq16_sc32i_no(in, ref + offa, refb + offb, scale, sizes[k] & ~3);
+				IQ16_SC32I(in, out + offa, outb + offb, scale, sizes[k] & ~3);
+				if (memcmp(ref, out, (F_VALS + 8) * sizeof(float)) ||
+						memcmp(refb, outb, (F_VALS + 8) * sizeof(float))) {
+					fprintf(stderr, "iq16_sc32i: mismatch for %u bytes at +%u/+%u!\n",
+							(unsigned)(sizes[k] & ~3), offa, offb);
+					g_errors++;
+				}
+			}
+		}
+	}
+
+done:
+	xtrxdsp_aligned_free(in);
+	xtrxdsp_aligned_free(ref);
+	xtrxdsp_aligned_free(refb);
+	xtrxdsp_aligned_free(out);
+	xtrxdsp_aligned_free(outb);
+}
+
 int main(int argc, char** argv)
 {
 	test_xtrxdsp_sc32i_iq16();
+	test_xtrxdsp_iq16_sc32_aligned();
 
 	printf("Total errors: %d\n", g_errors);
 	return 0;
@@ -20,22 +20,11 @@
 
 #include "xtrxdsp.h"
 
-typedef void (*func_xtrxdsp_iq16_sc32_t)(const int16_t *__restrict,float *__restrict, float, size_t);
-typedef uint64_t (*func_xtrxdsp_iq12_sc32_t)(const void *__restrict,float *__restrict, size_t, uint64_t prevstate);
-typedef void (*func_xtrxdsp_iq8_sc32_t)(const int8_t *__restrict,float *__restrict, size_t);
-typedef void (*func_xtrxdsp_iq8_ic16_t)(const int8_t *__restrict,int16_t *__restrict, size_t);
-
-typedef void (*func_xtrxdsp_iq16_sc32i_t)(const int16_t *__restrict, float *__restrict, float *__restrict, float, size_t);
-typedef void (*func_xtrxdsp_iq16_ic16i_t)(const int16_t *__restrict, int16_t *__restrict, int16_t *__restrict, size_t);
-
-typedef void (*func_xtrxdsp_iq8_sc32i_t)(const int8_t *__restrict,float *__restrict,float *__restrict, size_t);
-typedef void (*func_xtrxdsp_iq8_ic16i_t)(const int8_t *__restrict,int16_t *__restrict,int16_t *__restrict, size_t);
-typedef void (*func_xtrxdsp_iq8_ic8i_t)(const int8_t *__restrict,int8_t *__restrict,int8_t *__restrict, size_t);
-
-typedef void (*func_xtrxdsp_sc32_iq16_t)(const float *__restrict, int16_t *__restrict, float, size_t);
-typedef void (*func_xtrxdsp_sc32i_iq16_t)(const float *__restrict i, const float *__restrict, int16_t *__restrict, float, size_t);
-
-typedef void (*func_xtrxdsp_ic16i_iq16_t)(const int16_t *__restrict i, const int16_t *__restrict, int16_t *__restrict, size_t);
+/* ifunc is available not on all platforms, counting needs real entry points,
+ * resolvers of a static binary run before libc is initialized */
+#if defined(__linux) && (defined(__x86_64__) || defined(__i386__)) && !defined(XTRXDSP_INSTRUMENT) && !defined(XTRXDSP_STATIC)
+#define XTRXDSP_IFUNC
+#endif
 
 #ifndef NOPRINT
 #include <stdio.h>
@@ -45,6 +34,13 @@ typedef void (*func_xtrxdsp_ic16i_iq16_t)(const int16_t *__restrict i, const int
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#include <sched.h>
+#endif
 
 #if defined(__x86_64__) || defined(__i386__)
 #define GCC_VERSION (__GNUC__ * 10000 \
@@ -57,11 +53,23 @@ typedef void (*func_xtrxdsp_ic16i_iq16_t)(const int16_t *__restrict i, const int
 #define RUNTIME_CHECK_FMA()  0
 #endif
 
+#include <cpuid.h>
+
+/* __builtin_cpu_supports() doesn't know f16c on older compilers */
+static bool cpu_check_f16c(void)
+{
+	unsigned eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return false;
+	return (ecx & bit_F16C) != 0;
+}
+
 typedef struct cpu_features {
 	bool sse2;
 	bool sse41;
 	bool avx;
 	bool fma;
+	bool f16c;
 } cpu_features_t;
 
 static void cpu_features_init(cpu_features_t* features)
@@ -72,12 +80,28 @@ static void cpu_features_init(cpu_features_t* features)
 	features->sse41 = __builtin_cpu_supports("sse4.1");
 	features->avx = __builtin_cpu_supports("avx");
 	features->fma = RUNTIME_CHECK_FMA();
+	features->f16c = cpu_check_f16c();
 
-	INFORM("CPU Features: SSE2%c SSE4.1%c AVX%c FMA%c\n",
+	INFORM("CPU Features: SSE2%c SSE4.1%c AVX%c FMA%c F16C%c\n",
 		   features->sse2 ? '+' : '-',
 		   features->sse41 ? '+' : '-',
 		   features->avx ? '+' : '-',
-		   features->fma ? '+' : '-');
+		   features->fma ? '+' : '-',
+		   features->f16c ? '+' : '-');
+}
+
+static void cpu_features_limit(cpu_features_t* features, enum xtrxdsp_isa isa)
+{
+	if (isa < XTRXDSP_ISA_AVX_FMA) {
+		features->fma = false;
+		features->f16c = false;
+	}
+	if (isa < XTRXDSP_ISA_AVX)
+		features->avx = false;
+	if (isa < XTRXDSP_ISA_SSE41)
+		features->sse41 = false;
+	if (isa < XTRXDSP_ISA_SSE2)
+		features->sse2 = false;
 }
 
 #elif defined(__arm__) || defined(__aarch64__)
@@ -89,6 +113,12 @@ static void cpu_features_init(cpu_features_t* features)
 {
 	features->neon = false; //TODO
 }
+
+static void cpu_features_limit(cpu_features_t* features, enum xtrxdsp_isa isa)
+{
+	if (isa == XTRXDSP_ISA_GENERIC)
+		features->neon = false;
+}
 #else
 
 #warning Unknown platform!
@@ -101,41 +131,246 @@ static void cpu_features_init(cpu_features_t* features)
 {
 }
 
+static void cpu_features_limit(cpu_features_t* features, enum xtrxdsp_isa isa)
+{
+}
+
+#endif
+
+/* one time initialization states */
+enum {
+	ONCE_NONE,
+	ONCE_RUNNING,
+	ONCE_DONE,
+};
+
+/* returns true if the caller has to initialize and then call once_leave(),
+ * other callers wait for the initialization to be completed
+ */
+static bool once_enter(int* state)
+{
+	int expected = ONCE_NONE;
+
+	if (__builtin_expect(__atomic_load_n(state, __ATOMIC_ACQUIRE) == ONCE_DONE, 1))
+		return false;
+	if (__atomic_compare_exchange_n(state, &expected, ONCE_RUNNING, false,
+									__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return true;
+
+	while (__atomic_load_n(state, __ATOMIC_ACQUIRE) != ONCE_DONE) {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#else
+		sched_yield();
 #endif
+	}
+	return false;
+}
+
+static void once_leave(int* state)
+{
+	__atomic_store_n(state, ONCE_DONE, __ATOMIC_RELEASE);
+}
 
-static bool s_cpu_features_init = false;
-static cpu_features_t s_cpu_features;
+static int s_cpu_features_init = ONCE_NONE;
+/* written once under s_cpu_features_init, read only afterwards */
+static cpu_features_t s_cpu_detected;
+/* accessed atomically, resolvers limit detected features by it */
+static enum xtrxdsp_isa s_isa = XTRXDSP_ISA_NATIVE;
+
+static const char* s_isa_names[] = {
+	"generic", "sse2", "sse4.1", "avx", "avx_fma", "native"
+};
+
+static void isa_apply(enum xtrxdsp_isa isa)
+{
+	__atomic_store_n(&s_isa, isa, __ATOMIC_RELEASE);
+
+	if (isa != XTRXDSP_ISA_NATIVE) {
+		INFORM("Kernels are limited to %s\n", s_isa_names[isa]);
+	}
+}
+
+extern char** environ;
+
+/* returns the rest of s if it starts with prefix, NULL otherwise */
+static const char* str_skip(const char* s, const char* prefix)
+{
+	for (; *prefix; s++, prefix++) {
+		if (*s != *prefix)
+			return NULL;
+	}
+	return s;
+}
+
+/* runs from ifunc resolvers, possibly before libc string functions are
+ * resolved, so environment is walked without getenv() and strcmp()
+ */
+static enum xtrxdsp_isa isa_from_env(void)
+{
+	const char* env = NULL;
+	const char* rest;
+	char** e;
+	unsigned i;
+
+	for (e = environ; e != NULL && *e != NULL; e++) {
+		env = str_skip(*e, "XTRXDSP_ISA=");
+		if (env)
+			break;
+	}
+
+	if (env == NULL || *env == 0)
+		return XTRXDSP_ISA_NATIVE;
+
+	for (i = 0; i <= XTRXDSP_ISA_NATIVE; i++) {
+		rest = str_skip(env, s_isa_names[i]);
+		if (rest && *rest == 0)
+			return (enum xtrxdsp_isa)i;
+	}
+
+	INFORM("Unknown XTRXDSP_ISA=%s, ignoring\n", env);
+	return XTRXDSP_ISA_NATIVE;
+}
 
 void xtrxdsp_init(void)
 {
-	if (!s_cpu_features_init) {
-		cpu_features_init(&s_cpu_features);
-		s_cpu_features_init = true;
+	if (once_enter(&s_cpu_features_init)) {
+		cpu_features_init(&s_cpu_detected);
+		isa_apply(isa_from_env());
+		once_leave(&s_cpu_features_init);
 	}
 }
 
+static void cpu_features_get(cpu_features_t* features, enum xtrxdsp_isa isa)
+{
+	*features = s_cpu_detected;
+	cpu_features_limit(features, isa);
+}
+
+static const xtrxdsp_dispatch_t* dispatch_publish(enum xtrxdsp_isa isa, bool first);
+
+int xtrxdsp_set_isa(enum xtrxdsp_isa isa)
+{
+	if ((unsigned)isa > XTRXDSP_ISA_NATIVE)
+		return -EINVAL;
+
+	xtrxdsp_init();
+	isa_apply(isa);
+	dispatch_publish(isa, false);
+	return 0;
+}
+
+enum xtrxdsp_isa xtrxdsp_get_isa(void)
+{
+	xtrxdsp_init();
+	return __atomic_load_n(&s_isa, __ATOMIC_ACQUIRE);
+}
+
+/* last resolution of every dispatched function, entries are never removed */
+#define MAX_RESOLVED 128
+
+typedef struct resolved_func {
+	const char* func;
+	const char* variant;
+} resolved_func_t;
+
+static resolved_func_t s_resolved[MAX_RESOLVED];
+static unsigned s_resolved_cnt;
+
+static void note_resolved(const char* func, const char* variant)
+{
+	unsigned i, cnt = __atomic_load_n(&s_resolved_cnt, __ATOMIC_ACQUIRE);
+
+	INFORM("Using %s for %s\n", strcmp(variant, "no") ? variant : "generic", func);
+
+	for (i = 0; i < cnt; i++) {
+		if (strcmp(s_resolved[i].func, func) == 0) {
+			__atomic_store_n(&s_resolved[i].variant, variant, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+
+	/* racing first resolutions of the same function just produce a duplicate */
+	i = __atomic_load_n(&s_resolved_cnt, __ATOMIC_RELAXED);
+	if (i < MAX_RESOLVED) {
+		s_resolved[i].func = func;
+		s_resolved[i].variant = variant;
+		__atomic_store_n(&s_resolved_cnt, i + 1, __ATOMIC_RELEASE);
+	}
+}
+
+const char* xtrxdsp_get_variant(const char* func)
+{
+	unsigned i, cnt = __atomic_load_n(&s_resolved_cnt, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < cnt; i++) {
+		if (strcmp(s_resolved[i].func, func) == 0)
+			return __atomic_load_n(&s_resolved[i].variant, __ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+int xtrxdsp_get_resolved(unsigned idx, const char** func, const char** variant)
+{
+	if (idx >= __atomic_load_n(&s_resolved_cnt, __ATOMIC_ACQUIRE))
+		return -ENOENT;
+
+	*func = s_resolved[idx].func;
+	*variant = __atomic_load_n(&s_resolved[idx].variant, __ATOMIC_RELAXED);
+	return 0;
+}
+
+void* xtrxdsp_aligned_alloc(size_t size)
+{
+	void* ptr;
+	if (posix_memalign(&ptr, XTRXDSP_ALIGN, size) != 0)
+		return NULL;
+	return ptr;
+}
+
+void xtrxdsp_aligned_free(void* ptr)
+{
+	free(ptr);
+}
+
 
 #define STRINGIFY2(x) #x
 #define STRINGIFY(x)  STRINGIFY2(x)
 
-#define SELECT_FUNC(method, func, suffix) \
+/*
+ * select_<func>() picks the best variant for features f, resolve_<func>()
+ * applies it to the running CPU and records the choice
+ */
+#define SELECT_FUNC(func, suffix) \
 	do { \
-		INFORM("Using " method " for " STRINGIFY(func) "\n"); \
+		*variant = STRINGIFY(suffix); \
 		return func##_##suffix;	\
 	} while (0)
 
+#define RESOLVE_FUNC(func) \
+	do { \
+		const char* variant; \
+		cpu_features_t features; \
+		__typeof__(select_##func(NULL, NULL)) fn; \
+		xtrxdsp_init(); \
+		cpu_features_get(&features, __atomic_load_n(&s_isa, __ATOMIC_ACQUIRE)); \
+		fn = select_##func(&features, &variant); \
+		note_resolved(STRINGIFY(func), variant); \
+		return fn; \
+	} while (0)
+
 
 #define CHECK_FUNC_BODY_EX2(func, suffix, gccstring, gccstring2) \
 	do { \
-		if (s_cpu_features.gccstring && s_cpu_features.gccstring2) { \
-			SELECT_FUNC(STRINGIFY(suffix), func, suffix); \
+		if (f->gccstring && f->gccstring2) { \
+			SELECT_FUNC(func, suffix); \
 		} \
 	} while (0)
 
 #define CHECK_FUNC_BODY_EX(func, suffix, gccstring) \
 	do { \
-		if (s_cpu_features.gccstring) { \
-			SELECT_FUNC(STRINGIFY(suffix), func, suffix); \
+		if (f->gccstring) { \
+			SELECT_FUNC(func, suffix); \
 		} \
 	} while (0)
 
@@ -155,6 +390,12 @@ void xtrxdsp_init(void)
 #define CHECK_FUNC_AVX_FMA(func)
 #endif
 
+#if defined(XTRXDSP_HAS__AVX__) && defined(XTRXDSP_HAS__F16C__)
+#define CHECK_FUNC_AVX_F16C(func) CHECK_FUNC_BODY_EX2(func, avx_f16c, avx, f16c)
+#else
+#define CHECK_FUNC_AVX_F16C(func)
+#endif
+
 #ifdef XTRXDSP_HAS__AVX__
 #define CHECK_FUNC_AVX(func) CHECK_FUNC_BODY(func, avx)
 #else
@@ -179,409 +420,346 @@ void xtrxdsp_init(void)
 #define CHECK_FUNC_SSE2(func)
 #endif
 
-#if defined(__x86_64__) || defined(__i386__)
+#define CHECK_FUNC_GENERIC(func)
+
+/* probes the isas list of XTRXDSP_DISPATCH_KERNELS, up to 4 entries */
+#define CHECK_FUNCS_1(func, a) \
+	CHECK_FUNC_##a(func);
+#define CHECK_FUNCS_2(func, a, b) \
+	CHECK_FUNCS_1(func, a) CHECK_FUNC_##b(func);
+#define CHECK_FUNCS_3(func, a, b, c) \
+	CHECK_FUNCS_2(func, a, b) CHECK_FUNC_##c(func);
+#define CHECK_FUNCS_4(func, a, b, c, d) \
+	CHECK_FUNCS_3(func, a, b, c) CHECK_FUNC_##d(func);
+#define CHECK_FUNCS_N(_1, _2, _3, _4, n, ...) n
+#define CHECK_FUNCS_EXPAND(func, ...) \
+	CHECK_FUNCS_N(__VA_ARGS__, CHECK_FUNCS_4, CHECK_FUNCS_3, CHECK_FUNCS_2, CHECK_FUNCS_1, )(func, __VA_ARGS__)
+#define CHECK_FUNCS_LIST(...) __VA_ARGS__
 
-static func_xtrxdsp_iq16_sc32_t resolve_xtrxdsp_iq16_sc32(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq16_sc32);
-	CHECK_FUNC_AVX(xtrxdsp_iq16_sc32);
-	CHECK_FUNC_SSE2(xtrxdsp_iq16_sc32);
-	SELECT_FUNC("generic", xtrxdsp_iq16_sc32, no);
-}
+#if defined(__x86_64__) || defined(__i386__)
+#define CHECK_FUNCS(func, isas) CHECK_FUNCS_EXPAND(func, CHECK_FUNCS_LIST isas)
+#else
+#define CHECK_FUNCS(func, isas)
+#endif
 
+#define DISPATCH_SELECT(name, ret, params, args, samples, isas) \
+	static func_xtrxdsp_##name##_t select_xtrxdsp_##name(const cpu_features_t* f, const char** variant) \
+	{ \
+		CHECK_FUNCS(xtrxdsp_##name, isas) \
+		SELECT_FUNC(xtrxdsp_##name, no); \
+	}
 
-static func_xtrxdsp_iq12_sc32_t resolve_xtrxdsp_iq12_sc32(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq12_sc32);
-	CHECK_FUNC_AVX(xtrxdsp_iq12_sc32);
-	CHECK_FUNC_SSSE3(xtrxdsp_iq12_sc32);
-	CHECK_FUNC_SSE2(xtrxdsp_iq12_sc32);
-	SELECT_FUNC("generic", xtrxdsp_iq12_sc32, no);
-}
+XTRXDSP_DISPATCH_KERNELS(DISPATCH_SELECT)
 
+#ifdef XTRXDSP_INSTRUMENT
+/* callers keeping kernel pointers (filters, NCO, DUC) get counted entry points */
+#define RESOLVE_PUBLIC(func) \
+	do { \
+		xtrxdsp_get_dispatch(); \
+		return func; \
+	} while (0)
+#else
+#define RESOLVE_PUBLIC(func) RESOLVE_FUNC(func)
+#endif
 
-static func_xtrxdsp_iq8_sc32_t resolve_xtrxdsp_iq8_sc32(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq8_sc32);
-	CHECK_FUNC_AVX(xtrxdsp_iq8_sc32);
-	CHECK_FUNC_SSE4_1(xtrxdsp_iq8_sc32);
-	CHECK_FUNC_SSE2(xtrxdsp_iq8_sc32);
-	SELECT_FUNC("generic", xtrxdsp_iq8_sc32, no);
-}
+#define DISPATCH_RESOLVE(name, ret, params, args, samples, isas) \
+	func_xtrxdsp_##name##_t resolve_xtrxdsp_##name(void) \
+	{ RESOLVE_PUBLIC(xtrxdsp_##name); }
 
-static func_xtrxdsp_iq8_ic16_t resolve_xtrxdsp_iq8_ic16(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX(xtrxdsp_iq8_ic16);
-	CHECK_FUNC_SSE2(xtrxdsp_iq8_ic16);
-	SELECT_FUNC("generic", xtrxdsp_iq8_ic16, no);
-}
+XTRXDSP_DISPATCH_KERNELS(DISPATCH_RESOLVE)
 
-static func_xtrxdsp_iq16_sc32i_t resolve_xtrxdsp_iq16_sc32i(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq16_sc32i);
-	CHECK_FUNC_AVX(xtrxdsp_iq16_sc32i);
-	CHECK_FUNC_SSE2(xtrxdsp_iq16_sc32i);
-	SELECT_FUNC("generic", xtrxdsp_iq16_sc32i, no);
-}
+#define DISPATCH_INDEX(name, ...) \
+	KERNEL_##name,
 
-static func_xtrxdsp_iq16_ic16i_t resolve_xtrxdsp_iq16_ic16i(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq16_ic16i);
-	CHECK_FUNC_AVX(xtrxdsp_iq16_ic16i);
-	CHECK_FUNC_SSE2(xtrxdsp_iq16_ic16i);
-	SELECT_FUNC("generic", xtrxdsp_iq16_ic16i, no);
-}
+enum {
+	XTRXDSP_DISPATCH_KERNELS(DISPATCH_INDEX)
+	KERNEL_COUNT
+};
 
-static func_xtrxdsp_iq8_sc32i_t resolve_xtrxdsp_iq8_sc32i(void)
+#ifdef XTRXDSP_INSTRUMENT
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define instr_ticks() __rdtsc()
+#else
+#include <time.h>
+static inline uint64_t instr_ticks(void)
 {
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq8_sc32i);
-	CHECK_FUNC_AVX(xtrxdsp_iq8_sc32i);
-	CHECK_FUNC_SSE4_1(xtrxdsp_iq8_sc32i);
-	CHECK_FUNC_SSE2(xtrxdsp_iq8_sc32i);
-	SELECT_FUNC("generic", xtrxdsp_iq8_sc32i, no);
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
 }
+#endif
 
-static func_xtrxdsp_iq8_ic16i_t resolve_xtrxdsp_iq8_ic16i(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq8_ic16i);
-	CHECK_FUNC_AVX(xtrxdsp_iq8_ic16i);
-	CHECK_FUNC_SSE2(xtrxdsp_iq8_ic16i);
-	SELECT_FUNC("generic", xtrxdsp_iq8_ic16i, no);
-}
+static const char* s_instr_variants[] = {
+	"no", "sse2", "sse41", "avx", "avx_fma", "avx_f16c", "avx2"
+};
 
-static func_xtrxdsp_iq8_ic8i_t resolve_xtrxdsp_iq8_ic8i(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_iq8_ic8i);
-	CHECK_FUNC_AVX(xtrxdsp_iq8_ic8i);
-	CHECK_FUNC_SSE2(xtrxdsp_iq8_ic8i);
-	SELECT_FUNC("generic", xtrxdsp_iq8_ic8i, no);
-}
+#define INSTR_VARIANTS (sizeof(s_instr_variants) / sizeof(s_instr_variants[0]))
 
-static func_xtrxdsp_sc32_iq16_t resolve_xtrxdsp_sc32_iq16(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_sc32_iq16);
-	CHECK_FUNC_AVX(xtrxdsp_sc32_iq16);
-	CHECK_FUNC_SSE2(xtrxdsp_sc32_iq16);
-	SELECT_FUNC("generic", xtrxdsp_sc32_iq16, no);
-}
+typedef struct instr_counter {
+	uint64_t calls;
+	uint64_t samples;
+	uint64_t cycles;
+} instr_counter_t;
 
-static func_xtrxdsp_sc32i_iq16_t resolve_xtrxdsp_sc32i_iq16(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_sc32i_iq16);
-	CHECK_FUNC_AVX(xtrxdsp_sc32i_iq16);
-	CHECK_FUNC_SSE2(xtrxdsp_sc32i_iq16);
-	SELECT_FUNC("generic", xtrxdsp_sc32i_iq16, no);
-}
+static instr_counter_t s_instr[KERNEL_COUNT][INSTR_VARIANTS];
+/* variant slot each kernel is currently bound to */
+static unsigned char s_instr_slot[KERNEL_COUNT];
 
-static func_xtrxdsp_ic16i_iq16_t resolve_xtrxdsp_ic16i_iq16(void)
+static void instr_bind(unsigned kernel, const char* variant)
 {
-	xtrxdsp_init();
-	CHECK_FUNC_AVX2(xtrxdsp_ic16i_iq16);
-	CHECK_FUNC_AVX(xtrxdsp_ic16i_iq16);
-	CHECK_FUNC_SSE2(xtrxdsp_ic16i_iq16);
-	SELECT_FUNC("generic", xtrxdsp_ic16i_iq16, no);
-}
+	unsigned i;
 
-func_xtrxdsp_sc32_conv64_t resolve_xtrxdsp_sc32_conv64(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX_FMA(xtrxdsp_sc32_conv64);
-	CHECK_FUNC_AVX(xtrxdsp_sc32_conv64);
-	CHECK_FUNC_SSE2(xtrxdsp_sc32_conv64);
-	SELECT_FUNC("generic", xtrxdsp_sc32_conv64, no);
+	for (i = 0; i < INSTR_VARIANTS; i++) {
+		if (strcmp(s_instr_variants[i], variant) == 0)
+			break;
+	}
+	__atomic_store_n(&s_instr_slot[kernel], (i < INSTR_VARIANTS) ? i : 0, __ATOMIC_RELAXED);
 }
 
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x2(void)
+static inline void instr_count(unsigned kernel, uint64_t samples, uint64_t start)
 {
-	//CHECK_FUNC_AVX(xtrxdsp_b8_expand_x2);
-	//CHECK_FUNC_SSE2(xtrxdsp_b8_expand_x2);
-	SELECT_FUNC("generic", xtrxdsp_b8_expand_x2, no);
-}
+	uint64_t cycles = instr_ticks() - start;
+	instr_counter_t* c = &s_instr[kernel][__atomic_load_n(&s_instr_slot[kernel], __ATOMIC_RELAXED)];
 
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x4(void)
-{
-	//CHECK_FUNC_AVX(xtrxdsp_b8_expand_x4);
-	//CHECK_FUNC_SSE2(xtrxdsp_b8_expand_x4);
-	SELECT_FUNC("generic", xtrxdsp_b8_expand_x4, no);
+	__atomic_fetch_add(&c->calls, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&c->samples, samples, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&c->cycles, cycles, __ATOMIC_RELAXED);
 }
+#else
+#define instr_bind(kernel, variant)
+#endif
 
-func_xtrxdsp_iq16_conv64_t resolve_xtrxdsp_iq16_conv64(void)
-{
-	xtrxdsp_init();
-	CHECK_FUNC_AVX(xtrxdsp_iq16_conv64);
-	CHECK_FUNC_SSE2(xtrxdsp_iq16_conv64);
-	SELECT_FUNC("generic", xtrxdsp_iq16_conv64, no);
-}
+/* a table per ISA level, filled once and never modified afterwards, so a
+ * pointer returned earlier stays usable while another one gets published
+ */
+static xtrxdsp_dispatch_t s_dispatch[XTRXDSP_ISA_NATIVE + 1];
+static const char* s_dispatch_variant[XTRXDSP_ISA_NATIVE + 1][KERNEL_COUNT];
+static int s_dispatch_init[XTRXDSP_ISA_NATIVE + 1];
+static const xtrxdsp_dispatch_t* s_dispatch_cur;
 
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x2(void)
-{
-//	CHECK_FUNC_AVX(xtrxdsp_b8_expand_x2);
-//	CHECK_FUNC_SSE2(xtrxdsp_b8_expand_x2);
-	SELECT_FUNC("generic", xtrxdsp_b4_expand_x2, no);
-}
+#define DISPATCH_FILL(name, ...) \
+	t->name = select_xtrxdsp_##name(&features, &v[KERNEL_##name]);
 
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x4(void)
+static const xtrxdsp_dispatch_t* dispatch_table(enum xtrxdsp_isa isa)
 {
-//	CHECK_FUNC_AVX(xtrxdsp_b4_expand_x4);
-//	CHECK_FUNC_SSE2(xtrxdsp_b4_expand_x4);
-	SELECT_FUNC("generic", xtrxdsp_b4_expand_x4, no);
+	xtrxdsp_dispatch_t* t = &s_dispatch[isa];
+	const char** v = s_dispatch_variant[isa];
+	cpu_features_t features;
+
+	if (once_enter(&s_dispatch_init[isa])) {
+		cpu_features_get(&features, isa);
+		XTRXDSP_DISPATCH_KERNELS(DISPATCH_FILL)
+		once_leave(&s_dispatch_init[isa]);
+	}
+	return t;
 }
 
+#ifdef XTRXDSP_IFUNC
+/* exported entry points are bound by ifunc at load time and don't go through
+ * the table, so its variants aren't reported under their names
+ */
+#define DISPATCH_NOTE(name)
 #else
-
-static func_xtrxdsp_iq16_sc32_t resolve_xtrxdsp_iq16_sc32(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq16_sc32, no); }
-
-static func_xtrxdsp_iq12_sc32_t resolve_xtrxdsp_iq12_sc32(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq12_sc32, no); }
-
-static func_xtrxdsp_iq8_sc32_t resolve_xtrxdsp_iq8_sc32(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq8_sc32, no); }
-
-static func_xtrxdsp_iq8_ic16_t resolve_xtrxdsp_iq8_ic16(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq8_ic16, no); }
-
-static func_xtrxdsp_iq16_sc32i_t resolve_xtrxdsp_iq16_sc32i(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq16_sc32i, no); }
-
-static func_xtrxdsp_iq16_ic16i_t resolve_xtrxdsp_iq16_ic16i(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq16_ic16i, no); }
-
-static func_xtrxdsp_iq8_sc32i_t resolve_xtrxdsp_iq8_sc32i(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq8_sc32i, no); }
-
-static func_xtrxdsp_sc32_iq16_t resolve_xtrxdsp_sc32_iq16(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_sc32_iq16, no); }
-
-static func_xtrxdsp_sc32i_iq16_t resolve_xtrxdsp_sc32i_iq16(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_sc32i_iq16, no); }
-
-static func_xtrxdsp_ic16i_iq16_t resolve_xtrxdsp_ic16i_iq16(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_ic16i_iq16, no); }
-
-static func_xtrxdsp_iq8_ic16i_t resolve_xtrxdsp_iq8_ic16i(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq8_ic16i, no); }
-
-static func_xtrxdsp_iq8_ic8i_t resolve_xtrxdsp_iq8_ic8i(void)
-{ xtrxdsp_init(); SELECT_FUNC("generic", xtrxdsp_iq8_ic8i, no); }
-
-
-func_xtrxdsp_sc32_conv64_t resolve_xtrxdsp_sc32_conv64(void)
-{ return xtrxdsp_sc32_conv64_no; }
-
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x2(void)
-{ return xtrxdsp_b8_expand_x2_no; }
-
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x4(void)
-{ return xtrxdsp_b8_expand_x4_no; }
-
-func_xtrxdsp_iq16_conv64_t resolve_xtrxdsp_iq16_conv64(void)
-{ return xtrxdsp_iq16_conv64_no; }
-
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x2(void)
-{ return xtrxdsp_b4_expand_x2_no; }
-
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x4(void)
-{ return xtrxdsp_b4_expand_x4_no; }
-
+#define DISPATCH_NOTE(name) \
+	note_resolved("xtrxdsp_" #name, v[KERNEL_##name]);
 #endif
 
-#if defined(__linux) && (defined(__x86_64__) || defined(__i386__))
-// ifunc is available not on all platforms!
-
-void xtrxdsp_iq16_sc32(const int16_t *__restrict iq,
-					   float *__restrict out,
-					   float scale,
-					   size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq16_sc32")));
-
-
-uint64_t xtrxdsp_iq12_sc32(const void *__restrict iq,
-						   float *__restrict out,
-						   size_t inbytes,
-						   uint64_t prevstate)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq12_sc32")));
+#define DISPATCH_PUBLISH(name, ...) \
+	DISPATCH_NOTE(name) \
+	instr_bind(KERNEL_##name, v[KERNEL_##name]);
 
+/* the first publication must not override a table set by xtrxdsp_set_isa()
+ * in between, so it only replaces an empty pointer
+ */
+static const xtrxdsp_dispatch_t* dispatch_publish(enum xtrxdsp_isa isa, bool first)
+{
+	const xtrxdsp_dispatch_t* t = dispatch_table(isa);
+	const xtrxdsp_dispatch_t* prev = NULL;
+	const char** v = s_dispatch_variant[isa];
+
+	if (first) {
+		if (!__atomic_compare_exchange_n(&s_dispatch_cur, &prev, t, false,
+										 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			return prev;
+	} else {
+		__atomic_store_n(&s_dispatch_cur, t, __ATOMIC_RELEASE);
+	}
 
-void xtrxdsp_iq8_sc32(const int8_t *__restrict iq,
-					  float *__restrict out,
-					  size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq8_sc32")));
-
-void xtrxdsp_iq8_ic16(const int8_t *__restrict iq,
-					  int16_t *__restrict out,
-					  size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq8_ic16")));
-
-void xtrxdsp_iq16_sc32i(const int16_t *__restrict iq,
-						float *__restrict outa,
-						float *__restrict outb,
-						float scale,
-						size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq16_sc32i")));
+	XTRXDSP_DISPATCH_KERNELS(DISPATCH_PUBLISH)
+	(void)v;
+	return t;
+}
 
-void xtrxdsp_iq16_ic16i(const int16_t *__restrict iq,
-						int16_t *__restrict outa,
-						int16_t *__restrict outb,
-						size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq16_ic16i")));
+const xtrxdsp_dispatch_t* xtrxdsp_get_dispatch(void)
+{
+	const xtrxdsp_dispatch_t* t = __atomic_load_n(&s_dispatch_cur, __ATOMIC_ACQUIRE);
 
-void xtrxdsp_iq8_sc32i(const int8_t *__restrict iq,
-					   float *__restrict outa,
-					   float *__restrict outb,
-					   size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq8_sc32i")));
+	return (t != NULL) ? t : dispatch_publish(xtrxdsp_get_isa(), true);
+}
 
-void xtrxdsp_iq8_ic16i(const int8_t *__restrict iq,
-					   int16_t *__restrict outa,
-					   int16_t *__restrict outb,
-					   size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq8_ic16i")));
+typedef xtrxdsp_kernel_t (*kernel_select_t)(const cpu_features_t* f, const char** variant);
 
-void xtrxdsp_iq8_ic8i(const int8_t *__restrict iq,
-					   int8_t *__restrict outa,
-					   int8_t *__restrict outb,
-					   size_t bytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_iq8_ic8i")));
+typedef struct dispatch_kernel {
+	const char* name;
+	size_t offset;
+	kernel_select_t select;
+} dispatch_kernel_t;
 
+#define DISPATCH_KERNEL(name, ...) \
+	{ "xtrxdsp_" #name, offsetof(xtrxdsp_dispatch_t, name), (kernel_select_t)select_xtrxdsp_##name },
 
-void xtrxdsp_sc32_iq16(const float *__restrict iq,
-					   int16_t *__restrict out,
-					   float scale,
-					   size_t outbytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_sc32_iq16")));
+static const dispatch_kernel_t s_kernels[] = {
+	XTRXDSP_DISPATCH_KERNELS(DISPATCH_KERNEL)
+};
 
-void xtrxdsp_sc32i_iq16(const float *__restrict i,
-						const float *__restrict q,
-						int16_t *__restrict out,
-						float scale,
-						size_t outbytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_sc32i_iq16")));
+static const dispatch_kernel_t* kernel_find(const char* func)
+{
+	unsigned i;
 
-void xtrxdsp_ic16i_iq16(const int16_t *__restrict i,
-						const int16_t *__restrict q,
-						int16_t *__restrict out,
-						size_t outbytes)
-__attribute__ ((ifunc ("resolve_xtrxdsp_ic16i_iq16")));
+	for (i = 0; i < sizeof(s_kernels) / sizeof(s_kernels[0]); i++) {
+		if (strcmp(s_kernels[i].name, func) == 0)
+			return &s_kernels[i];
+	}
+	return NULL;
+}
 
-DECLARE_SC32_CONV64_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_sc32_conv64")));
+int xtrxdsp_get_candidates(const char* func,
+						   xtrxdsp_kernel_t* fn,
+						   const char** variant,
+						   unsigned max)
+{
+	const dispatch_kernel_t* k = kernel_find(func);
+	cpu_features_t features;
+	xtrxdsp_kernel_t kfn;
+	const char* kvariant;
+	unsigned cnt = 0, i;
+	int isa;
 
-DECLARE_B8_EXPAND_X2_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_b8_expand_x2")));
+	if (k == NULL)
+		return -EINVAL;
 
-DECLARE_B8_EXPAND_X4_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_b8_expand_x4")));
+	xtrxdsp_init();
 
-DECLARE_IQ16_CONV64_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_iq16_conv64")));
+	/* walk down the ISA levels, each one yields its best variant */
+	for (isa = xtrxdsp_get_isa(); isa >= XTRXDSP_ISA_GENERIC && cnt < max; isa--) {
+		features = s_cpu_detected;
+		cpu_features_limit(&features, (enum xtrxdsp_isa)isa);
+
+		kfn = k->select(&features, &kvariant);
+		for (i = 0; i < cnt && fn[i] != kfn; i++)
+			;
+		if (i == cnt) {
+			fn[cnt] = kfn;
+			variant[cnt++] = kvariant;
+		}
+	}
+	return cnt;
+}
 
-DECLARE_B4_EXPAND_X2_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_b4_expand_x2")));
+int xtrxdsp_dispatch_bind(xtrxdsp_dispatch_t* t,
+						  const char* func,
+						  const char* variant)
+{
+	const dispatch_kernel_t* k = kernel_find(func);
+	xtrxdsp_kernel_t fn[XTRXDSP_ISA_NATIVE + 1];
+	const char* names[XTRXDSP_ISA_NATIVE + 1];
+	int cnt, i;
+
+	if (k == NULL)
+		return -EINVAL;
+
+	cnt = xtrxdsp_get_candidates(func, fn, names, XTRXDSP_ISA_NATIVE + 1);
+	for (i = 0; i < cnt; i++) {
+		if (strcmp(names[i], variant) == 0) {
+			*(xtrxdsp_kernel_t*)((char*)t + k->offset) = fn[i];
+			return 0;
+		}
+	}
+	return -ENOENT;
+}
 
-DECLARE_B4_EXPAND_X4_FUNC() __attribute__ ((ifunc ("resolve_xtrxdsp_b4_expand_x4")));
+#define DISPATCH_NAME(name, ...) \
+	"xtrxdsp_" #name,
 
+int xtrxdsp_counters_snapshot(xtrxdsp_counter_t* out, unsigned max)
+{
+#ifdef XTRXDSP_INSTRUMENT
+	static const char* names[] = { XTRXDSP_DISPATCH_KERNELS(DISPATCH_NAME) };
+	unsigned k, v, cnt = 0;
+	uint64_t calls;
+
+	for (k = 0; k < KERNEL_COUNT; k++) {
+		for (v = 0; v < INSTR_VARIANTS; v++) {
+			calls = __atomic_load_n(&s_instr[k][v].calls, __ATOMIC_RELAXED);
+			if (calls == 0)
+				continue;
+			if (cnt == max)
+				return cnt;
+
+			out[cnt].func = names[k];
+			out[cnt].variant = s_instr_variants[v];
+			out[cnt].calls = calls;
+			out[cnt].samples = __atomic_load_n(&s_instr[k][v].samples, __ATOMIC_RELAXED);
+			out[cnt].cycles = __atomic_load_n(&s_instr[k][v].cycles, __ATOMIC_RELAXED);
+			cnt++;
+		}
+	}
+	return cnt;
 #else
-#define STATIC_RESOLVE(x, ...) \
-	static func_##x##_t r_func; \
-	if (r_func == NULL) r_func = resolve_##x(); \
-	r_func(__VA_ARGS__);
-
-#define STATIC_RESOLVE_RET(x, ...) \
-	static func_##x##_t r_func; \
-	if (r_func == NULL) r_func = resolve_##x(); \
-	return r_func(__VA_ARGS__);
-
-void xtrxdsp_iq16_sc32(const int16_t *__restrict iq,
-					   float *__restrict out,
-					   float scale,
-					   size_t bytes)
-{ STATIC_RESOLVE(xtrxdsp_iq16_sc32, iq, out, scale, bytes); }
-
-uint64_t xtrxdsp_iq12_sc32(const void *__restrict iq,
-						   float *__restrict out,
-						   size_t inbytes,
-						   uint64_t prevstate)
-{ STATIC_RESOLVE_RET(xtrxdsp_iq12_sc32, iq, out, inbytes, prevstate); }
-
-void xtrxdsp_iq8_sc32(const int8_t *__restrict iq,
-					  float *__restrict out,
-					  size_t bytes)
-{ STATIC_RESOLVE(xtrxdsp_iq8_sc32, iq, out, bytes); }
-
-
-void xtrxdsp_iq16_sc32i(const int16_t *__restrict iq,
-						float *__restrict outa,
-						float *__restrict outb,
-						float scale,
-						size_t bytes)
-{ STATIC_RESOLVE(xtrxdsp_iq16_sc32i, iq, outa, outb, scale, bytes); }
-
-void xtrxdsp_iq8_sc32i(const int8_t *__restrict iq,
-					   float *__restrict outa,
-					   float *__restrict outb,
-					   size_t bytes)
-{ STATIC_RESOLVE(xtrxdsp_iq8_sc32i, iq, outa, outb, bytes); }
-
-
-void xtrxdsp_sc32_iq16(const float *__restrict iq,
-					   int16_t *__restrict out,
-					   float scale,
-					   size_t outbytes)
-{ STATIC_RESOLVE(xtrxdsp_sc32_iq16, iq, out, scale, outbytes); }
-
-void xtrxdsp_sc32i_iq16(const float *__restrict i,
-						const float *__restrict q,
-						int16_t *__restrict out,
-						float scale,
-						size_t outbytes)
-{ STATIC_RESOLVE(xtrxdsp_sc32i_iq16, i, q, out, scale, outbytes); }
-
-void xtrxdsp_iq8_ic16(const int8_t *__restrict a, int16_t *__restrict b, size_t c)
-{ STATIC_RESOLVE(xtrxdsp_iq8_ic16, a, b, c); }
-
-void xtrxdsp_iq16_ic16i(const int16_t *__restrict a, int16_t *__restrict b, int16_t *__restrict c, size_t d)
-{ STATIC_RESOLVE(xtrxdsp_iq16_ic16i, a, b, c, d); }
-
-void xtrxdsp_iq8_ic16i(const int8_t *__restrict a, int16_t *__restrict b, int16_t *__restrict c, size_t d)
-{ STATIC_RESOLVE(xtrxdsp_iq8_ic16i, a, b, c, d); }
-
-void xtrxdsp_iq8_ic8i(const int8_t *__restrict a, int8_t *__restrict b, int8_t *__restrict c, size_t d)
-{ STATIC_RESOLVE(xtrxdsp_iq8_ic8i, a, b, c, d); }
-
-void xtrxdsp_ic16i_iq16(const int16_t *__restrict a, const int16_t *__restrict b, int16_t *__restrict c, size_t d)
-{ STATIC_RESOLVE(xtrxdsp_ic16i_iq16, a, b, c, d); }
+	return -ENOTSUP;
+#endif
+}
 
-DECLARE_SC32_CONV64_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_sc32_conv64, data, conv, out, count, decim_bits); }
+void xtrxdsp_counters_reset(void)
+{
+#ifdef XTRXDSP_INSTRUMENT
+	unsigned k, v;
+
+	for (k = 0; k < KERNEL_COUNT; k++) {
+		for (v = 0; v < INSTR_VARIANTS; v++) {
+			__atomic_store_n(&s_instr[k][v].calls, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&s_instr[k][v].samples, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&s_instr[k][v].cycles, 0, __ATOMIC_RELAXED);
+		}
+	}
+#endif
+}
 
-DECLARE_IQ16_CONV64_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_iq16_conv64, data, conv, out, count, decim_bits); }
+#ifdef XTRXDSP_IFUNC
 
-// TODO get rid of it
-typedef func_xtrxdsp_bx_expand_t func_xtrxdsp_b8_expand_x2_t;
-typedef func_xtrxdsp_bx_expand_t func_xtrxdsp_b4_expand_x2_t;
-typedef func_xtrxdsp_bx_expand_t func_xtrxdsp_b8_expand_x4_t;
-typedef func_xtrxdsp_bx_expand_t func_xtrxdsp_b4_expand_x4_t;
+#define DISPATCH_ENTRY(name, ret, params, args, samples, isas) \
+	ret xtrxdsp_##name params __attribute__ ((ifunc ("resolve_xtrxdsp_" #name)));
 
-DECLARE_B8_EXPAND_X2_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_b8_expand_x2, data, out, count_blocks); }
+#else
+#ifdef XTRXDSP_INSTRUMENT
+#define STATIC_RESOLVE_void(x, samples, args) \
+	const xtrxdsp_dispatch_t* t = xtrxdsp_get_dispatch(); \
+	uint64_t start = instr_ticks(); \
+	t->x args; \
+	instr_count(KERNEL_##x, samples, start);
+
+#define STATIC_RESOLVE_RET(x, samples, args) \
+	const xtrxdsp_dispatch_t* t = xtrxdsp_get_dispatch(); \
+	uint64_t start = instr_ticks(); \
+	__typeof__(t->x args) res = t->x args; \
+	instr_count(KERNEL_##x, samples, start); \
+	return res;
+#else
+#define STATIC_RESOLVE_void(x, samples, args) \
+	xtrxdsp_get_dispatch()->x args;
 
-DECLARE_B8_EXPAND_X4_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_b8_expand_x4, data, out, count_blocks); }
+#define STATIC_RESOLVE_RET(x, samples, args) \
+	return xtrxdsp_get_dispatch()->x args;
+#endif
 
-DECLARE_B4_EXPAND_X2_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_b4_expand_x2, data, out, count_blocks); }
+#define STATIC_RESOLVE_uint32_t STATIC_RESOLVE_RET
+#define STATIC_RESOLVE_uint64_t STATIC_RESOLVE_RET
 
-DECLARE_B4_EXPAND_X4_FUNC()
-{ STATIC_RESOLVE(xtrxdsp_b4_expand_x4, data, out, count_blocks); }
+#define DISPATCH_ENTRY(name, ret, params, args, samples, isas) \
+	ret xtrxdsp_##name params \
+	{ STATIC_RESOLVE_##ret(name, samples, args) }
 
 #endif
 
-
+XTRXDSP_DISPATCH_KERNELS(DISPATCH_ENTRY)
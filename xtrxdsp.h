@@ -26,8 +26,122 @@
 
 #include <xtrxdsp_config.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void xtrxdsp_init(void);
 
+/* ISA levels for kernel selection, each level includes all lower ones */
+enum xtrxdsp_isa {
+	XTRXDSP_ISA_GENERIC,
+	XTRXDSP_ISA_SSE2,
+	XTRXDSP_ISA_SSE41,
+	XTRXDSP_ISA_AVX,
+	XTRXDSP_ISA_AVX_FMA, // AVX with FMA and F16C
+	XTRXDSP_ISA_NATIVE, // Everything the CPU supports, default
+};
+
+/**
+ * @brief xtrxdsp_set_isa Limits kernel selection to the ISA level
+ *
+ * The initial level comes from XTRXDSP_ISA environment variable, one of
+ * generic, sse2, sse4.1, avx, avx_fma or native. Entry points bound through
+ * ifunc are resolved by the dynamic linker, so only the variable applies to
+ * them; the call affects everything resolved afterwards, i.e. filters, DDC/DUC
+ * and builds without ifunc.
+ * @return 0 on success, -EINVAL on unknown level
+ */
+int xtrxdsp_set_isa(enum xtrxdsp_isa isa);
+
+enum xtrxdsp_isa xtrxdsp_get_isa(void);
+
+/**
+ * @brief xtrxdsp_get_variant Returns the kernel a function was last resolved to
+ * @param func Function name, i.e. "xtrxdsp_iq16_sc32"
+ * @return Variant suffix ("no", "sse2", "avx", ...), NULL if not resolved yet
+ */
+const char* xtrxdsp_get_variant(const char* func);
+
+/**
+ * @brief xtrxdsp_get_resolved Enumerates resolved functions
+ * @param idx Index starting from 0
+ * @return 0 on success, -ENOENT past the last one
+ */
+int xtrxdsp_get_resolved(unsigned idx, const char** func, const char** variant);
+
+/* Alignment of buffers taking aligned fast paths in all kernels */
+#define XTRXDSP_ALIGN 64
+
+/**
+ * @brief xtrxdsp_aligned_alloc Allocates XTRXDSP_ALIGN aligned buffer
+ * @param size Size in bytes
+ * @return pointer to be released by xtrxdsp_aligned_free(), NULL on error
+ */
+void* xtrxdsp_aligned_alloc(size_t size);
+
+void xtrxdsp_aligned_free(void* ptr);
+
+/* Output fixups, swap is applied first, then negation and gains of the
+ * resulting I and Q
+ */
+enum xtrxdsp_iqcorr_flags {
+	XTRXDSP_IQCORR_SWAP_IQ = 1, // Swap I and Q
+	XTRXDSP_IQCORR_NEG_I   = 2, // Negate I
+	XTRXDSP_IQCORR_NEG_Q   = 4, // Negate Q, i.e. conjugate / invert spectrum
+};
+
+/* IQ correction applied to raw wire values during conversion
+ *   out_i = m_ii * I + m_iq * Q + dc_i
+ *   out_q = m_qi * I + m_qq * Q + dc_q
+ * conversion scale is a part of the matrix, see xtrxdsp_iqcorr_init().
+ * Output fixups set by xtrxdsp_iqcorr_apply_flags() are folded into the
+ * matrix and kept in flags and gains, which is all xtrxdsp_sc32_fixup() and
+ * xtrxdsp_ic16_fixup() use
+ */
+typedef struct xtrxdsp_iqcorr {
+	float m_ii;
+	float m_iq;
+	float m_qi;
+	float m_qq;
+	float dc_i;
+	float dc_q;
+	unsigned flags; // XTRXDSP_IQCORR_* fixups
+	float gain_i;   // Gain of the output I
+	float gain_q;   // Gain of the output Q
+} xtrxdsp_iqcorr_t;
+
+/* Statistics of the corrected output accumulated by *_corr converters in the
+ * same pass, input of the DC / IQ imbalance estimator in xtrxdsp_iqcorr.h.
+ * Pass NULL to skip accumulation. Sums are in output units and accumulate
+ * over calls
+ */
+typedef struct xtrxdsp_iqcorr_stat {
+	double sum_i;
+	double sum_q;
+	double sum_ii;
+	double sum_qq;
+	double sum_iq;
+	uint64_t count; // Number of complex samples
+} xtrxdsp_iqcorr_stat_t;
+
+/* Per channel input statistics accumulated by *_meter converters, channel 0
+ * is I (or A for deinterleaving converters), channel 1 is Q (or B). Values
+ * are in int16 units regardless of the wire format, i.e. iq12 is scaled by
+ * 16 and iq8 by 256. Zero it before the first block, results accumulate
+ * over calls
+ */
+typedef struct xtrxdsp_meter {
+	uint64_t sumsq[2]; // Sum of squares
+	uint32_t peak[2];  // Maximum absolute value
+	uint32_t clips[2]; // Number of values at ADC full scale
+	uint64_t count;    // Number of values per channel
+} xtrxdsp_meter_t;
+
 /* dynamically choise at runtime */
 
 #define DECLARE_IQ16_SC32_FUNC(funcname) \
@@ -109,45 +223,410 @@ void xtrxdsp_init(void);
 	int16_t *__restrict out, \
 	size_t bytes)
 
+#define DECLARE_IQ16_SC32_CORR_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32_corr_##funcname(const int16_t *__restrict iq, \
+	float *__restrict out, \
+	const xtrxdsp_iqcorr_t *__restrict corr, \
+	xtrxdsp_iqcorr_stat_t *__restrict stat, \
+	size_t bytes)
+
+#define DECLARE_IQ12_SC32_CORR_FUNC(funcname) \
+	uint64_t xtrxdsp_iq12_sc32_corr_##funcname(const void *__restrict iq, \
+	float *__restrict out, \
+	const xtrxdsp_iqcorr_t *__restrict corr, \
+	xtrxdsp_iqcorr_stat_t *__restrict stat, \
+	size_t inbytes, \
+	uint64_t prevstate)
+
+#define DECLARE_IQ16_SC32I_CORR_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32i_corr_##funcname(const int16_t *__restrict iq, \
+	float *__restrict outa, \
+	float *__restrict outb, \
+	const xtrxdsp_iqcorr_t *__restrict corr, \
+	xtrxdsp_iqcorr_stat_t *__restrict stat, \
+	size_t bytes)
+
+#define DECLARE_SC32_FIXUP_FUNC(funcname) \
+	void xtrxdsp_sc32_fixup_##funcname(float *iq, \
+	const xtrxdsp_iqcorr_t *__restrict corr, \
+	size_t bytes)
+
+#define DECLARE_IC16_FIXUP_FUNC(funcname) \
+	void xtrxdsp_ic16_fixup_##funcname(int16_t *iq, \
+	const xtrxdsp_iqcorr_t *__restrict corr, \
+	size_t bytes)
+
+#define DECLARE_IQ16_SC32_METER_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32_meter_##funcname(const int16_t *__restrict iq, \
+	float *__restrict out, \
+	float scale, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ12_SC32_METER_FUNC(funcname) \
+	uint64_t xtrxdsp_iq12_sc32_meter_##funcname(const void *__restrict iq, \
+	float *__restrict out, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t inbytes, \
+	uint64_t prevstate)
+
+#define DECLARE_IQ8_SC32_METER_FUNC(funcname) \
+	void xtrxdsp_iq8_sc32_meter_##funcname(const int8_t *__restrict iq, \
+	float *__restrict out, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ8_IC16_METER_FUNC(funcname) \
+	void xtrxdsp_iq8_ic16_meter_##funcname(const int8_t *__restrict iq, \
+	int16_t *__restrict out, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ16_SC32I_METER_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32i_meter_##funcname(const int16_t *__restrict iq, \
+	float *__restrict outa, \
+	float *__restrict outb, \
+	float scale, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ16_IC16I_METER_FUNC(funcname) \
+	void xtrxdsp_iq16_ic16i_meter_##funcname(const int16_t *__restrict iq, \
+	int16_t *__restrict outa, \
+	int16_t *__restrict outb, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ12_SC32I_METER_FUNC(funcname) \
+	uint64_t xtrxdsp_iq12_sc32i_meter_##funcname(const void *__restrict iq, \
+	float *__restrict outa, \
+	float *__restrict outb, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t inbytes, \
+	uint64_t prevstate)
+
+#define DECLARE_IQ8_SC32I_METER_FUNC(funcname) \
+	void xtrxdsp_iq8_sc32i_meter_##funcname(const int8_t *__restrict iq, \
+	float *__restrict outa, \
+	float *__restrict outb, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ8_IC16I_METER_FUNC(funcname) \
+	void xtrxdsp_iq8_ic16i_meter_##funcname(const int8_t *__restrict iq, \
+	int16_t *__restrict outa, \
+	int16_t *__restrict outb, \
+	xtrxdsp_meter_t *__restrict meter, \
+	size_t bytes)
+
+#define DECLARE_IQ16_HC16_FUNC(funcname) \
+	void xtrxdsp_iq16_hc16_##funcname(const int16_t *__restrict iq, \
+	uint16_t *__restrict out, \
+	float scale, \
+	size_t bytes)
+
+#define DECLARE_IQ16_BF16_FUNC(funcname) \
+	void xtrxdsp_iq16_bf16_##funcname(const int16_t *__restrict iq, \
+	uint16_t *__restrict out, \
+	float scale, \
+	size_t bytes)
+
+#define DECLARE_HC16_IQ16_FUNC(funcname) \
+	void xtrxdsp_hc16_iq16_##funcname(const uint16_t *__restrict iq, \
+	int16_t *__restrict out, \
+	float scale, \
+	size_t outbytes)
+
+#define DECLARE_BF16_IQ16_FUNC(funcname) \
+	void xtrxdsp_bf16_iq16_##funcname(const uint16_t *__restrict iq, \
+	int16_t *__restrict out, \
+	float scale, \
+	size_t outbytes)
+
+#define DECLARE_IQ16_SC64_FUNC(funcname) \
+	void xtrxdsp_iq16_sc64_##funcname(const int16_t *__restrict iq, \
+	double *__restrict out, \
+	double scale, \
+	size_t bytes)
+
+#define DECLARE_IQ12_SC64_FUNC(funcname) \
+	uint64_t xtrxdsp_iq12_sc64_##funcname(const void *__restrict iq, \
+	double *__restrict out, \
+	size_t inbytes, \
+	uint64_t prevstate)
+
+#define DECLARE_SC64_IQ16_FUNC(funcname) \
+	void xtrxdsp_sc64_iq16_##funcname(const double *__restrict iq, \
+	int16_t *__restrict out, \
+	double scale, \
+	size_t outbytes)
+
+#define DECLARE_IQ16_SC32_NT_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32_nt_##funcname(const int16_t *__restrict iq, \
+	float *__restrict out, \
+	float scale, \
+	size_t bytes)
+
+#define DECLARE_IQ16_SC32I_NT_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32i_nt_##funcname(const int16_t *__restrict iq, \
+	float *__restrict outa, \
+	float *__restrict outb, \
+	float scale, \
+	size_t bytes)
+
+#define DECLARE_SC32_IQ16_NT_FUNC(funcname) \
+	void xtrxdsp_sc32_iq16_nt_##funcname(const float *__restrict iq, \
+	int16_t *__restrict out, \
+	float scale, \
+	size_t outbytes)
+
+#define DECLARE_IQ12_SC32_NT_FUNC(funcname) \
+	uint64_t xtrxdsp_iq12_sc32_nt_##funcname(const void *__restrict iq, \
+	float *__restrict out, \
+	size_t inbytes, \
+	uint64_t prevstate)
+
+#define DECLARE_IQ8_SC32_NT_FUNC(funcname) \
+	void xtrxdsp_iq8_sc32_nt_##funcname(const int8_t *__restrict iq, \
+	float *__restrict out, \
+	size_t bytes)
+
+#define DECLARE_IQ16_IC16I_IP_FUNC(funcname) \
+	void xtrxdsp_iq16_ic16i_ip_##funcname(int16_t *iq, \
+	int16_t *__restrict outb, \
+	size_t bytes)
+
+#define DECLARE_IQ8_IC8I_IP_FUNC(funcname) \
+	void xtrxdsp_iq8_ic8i_ip_##funcname(int8_t *iq, \
+	int8_t *__restrict outb, \
+	size_t bytes)
+
+#define DECLARE_IC16I_IQ16_IP_FUNC(funcname) \
+	void xtrxdsp_ic16i_iq16_ip_##funcname(int16_t *i, \
+	const int16_t *__restrict q, \
+	size_t outbytes)
+
+#define DECLARE_SC32_IQ16_IP_FUNC(funcname) \
+	void xtrxdsp_sc32_iq16_ip_##funcname(void *buf, \
+	float scale, \
+	size_t outbytes)
+
+#define DECLARE_IQ16_SC32_IP_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32_ip_##funcname(void *buf, \
+	float scale, \
+	size_t inbytes)
+
+#define DECLARE_IQ8_SC32_IP_FUNC(funcname) \
+	void xtrxdsp_iq8_sc32_ip_##funcname(void *buf, \
+	size_t inbytes)
+
+#define DECLARE_IQ8_IC16_IP_FUNC(funcname) \
+	void xtrxdsp_iq8_ic16_ip_##funcname(void *buf, \
+	size_t inbytes)
+
+#define DECLARE_IQ16_SC32N_FUNC(funcname) \
+	void xtrxdsp_iq16_sc32n_##funcname(const int16_t *__restrict iq, \
+	float *const *__restrict out, \
+	unsigned chans, \
+	float scale, \
+	size_t bytes)
+
+#define DECLARE_IQ16_IC16N_FUNC(funcname) \
+	void xtrxdsp_iq16_ic16n_##funcname(const int16_t *__restrict iq, \
+	int16_t *const *__restrict out, \
+	unsigned chans, \
+	size_t bytes)
+
+#define DECLARE_IQ12_SC32N_FUNC(funcname) \
+	void xtrxdsp_iq12_sc32n_##funcname(const void *__restrict iq, \
+	float *const *__restrict out, \
+	unsigned chans, \
+	size_t inbytes)
+
+#define DECLARE_IQ8_SC32N_FUNC(funcname) \
+	void xtrxdsp_iq8_sc32n_##funcname(const int8_t *__restrict iq, \
+	float *const *__restrict out, \
+	unsigned chans, \
+	size_t bytes)
+
+#define DECLARE_IQ8_IC16N_FUNC(funcname) \
+	void xtrxdsp_iq8_ic16n_##funcname(const int8_t *__restrict iq, \
+	int16_t *const *__restrict out, \
+	unsigned chans, \
+	size_t bytes)
+
+#define DECLARE_SC32N_IQ16_FUNC(funcname) \
+	void xtrxdsp_sc32n_iq16_##funcname(const float *const *__restrict in, \
+	unsigned chans, \
+	int16_t *__restrict out, \
+	float scale, \
+	size_t outbytes)
+
+#define DECLARE_IC16N_IQ16_FUNC(funcname) \
+	void xtrxdsp_ic16n_iq16_##funcname(const int16_t *const *__restrict in, \
+	unsigned chans, \
+	int16_t *__restrict out, \
+	size_t outbytes)
+
 #define DECLARE_IQ16_SC32_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ16_SC32_FUNC(funcname) { xtrxdsp_iq16_sc32_template(iq, out, scale, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32_FUNC(funcname) { xtrxdsp_iq16_sc32_template(iq, out, scale, bytes); }
 
 #define DECLARE_IQ12_SC32_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ12_SC32_FUNC(funcname) { return xtrxdsp_iq12_sc32_template(iq, out, inbytes, prevstate); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32_FUNC(funcname) { return xtrxdsp_iq12_sc32_template(iq, out, inbytes, prevstate); }
 
 #define DECLARE_IQ8_SC32_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ8_SC32_FUNC(funcname) { xtrxdsp_iq8_sc32_template(iq, out, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32_FUNC(funcname) { xtrxdsp_iq8_sc32_template(iq, out, bytes); }
 
 #define DECLARE_IQ8_IC16_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ8_IC16_FUNC(funcname) { xtrxdsp_iq8_ic16_template(iq, out, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16_FUNC(funcname) { xtrxdsp_iq8_ic16_template(iq, out, bytes); }
 
 #define DECLARE_SC32_IQ16_FUNC_TEMPLATE(funcname) \
-	DECLARE_SC32_IQ16_FUNC(funcname) { xtrxdsp_sc32_iq16_template(iq, out, scale, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32_IQ16_FUNC(funcname) { xtrxdsp_sc32_iq16_template(iq, out, scale, bytes); }
 
 
 #define DECLARE_IQ16_SC32I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ16_SC32I_FUNC(funcname) { xtrxdsp_iq16_sc32i_template(iq, outa, outb, scale, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32I_FUNC(funcname) { xtrxdsp_iq16_sc32i_template(iq, outa, outb, scale, bytes); }
 
 #define DECLARE_IQ16_IC16I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ16_IC16I_FUNC(funcname) { xtrxdsp_iq16_ic16i_template(iq, outa, outb, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_IC16I_FUNC(funcname) { xtrxdsp_iq16_ic16i_template(iq, outa, outb, bytes); }
 
 #define DECLARE_IQ12_SC32I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ12_SC32I_FUNC(funcname) { return xtrxdsp_iq12_sc32i_template(iq, outa, outb, inbytes, prevstate); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32I_FUNC(funcname) { return xtrxdsp_iq12_sc32i_template(iq, outa, outb, inbytes, prevstate); }
 
 #define DECLARE_IQ8_SC32I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ8_SC32I_FUNC(funcname) { xtrxdsp_iq8_sc32i_template(iq, outa, outb, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32I_FUNC(funcname) { xtrxdsp_iq8_sc32i_template(iq, outa, outb, bytes); }
 
 #define DECLARE_IQ8_IC8I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ8_IC8I_FUNC(funcname) { xtrxdsp_iq8_ic8i_template(iq, outa, outb, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC8I_FUNC(funcname) { xtrxdsp_iq8_ic8i_template(iq, outa, outb, bytes); }
 
 #define DECLARE_IQ8_IC16I_FUNC_TEMPLATE(funcname) \
-	DECLARE_IQ8_IC16I_FUNC(funcname) { xtrxdsp_iq8_ic16i_template(iq, outa, outb, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16I_FUNC(funcname) { xtrxdsp_iq8_ic16i_template(iq, outa, outb, bytes); }
 
 #define DECLARE_SC32I_IQ16_FUNC_TEMPLATE(funcname) \
-	DECLARE_SC32I_IQ16_FUNC(funcname) { xtrxdsp_sc32i_iq16_template(i, q, out, scale, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32I_IQ16_FUNC(funcname) { xtrxdsp_sc32i_iq16_template(i, q, out, scale, bytes); }
 
 #define DECLARE_IC16I_IQ16_FUNC_TEMPLATE(funcname) \
-	DECLARE_IC16I_IQ16_FUNC(funcname) { xtrxdsp_ic16i_iq16_template(i, q, out, bytes); }
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IC16I_IQ16_FUNC(funcname) { xtrxdsp_ic16i_iq16_template(i, q, out, bytes); }
+
+#define DECLARE_IQ16_SC32_CORR_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32_CORR_FUNC(funcname) { xtrxdsp_iq16_sc32_corr_template(iq, out, corr, stat, bytes); }
+
+#define DECLARE_IQ12_SC32_CORR_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32_CORR_FUNC(funcname) { return xtrxdsp_iq12_sc32_corr_template(iq, out, corr, stat, inbytes, prevstate); }
+
+#define DECLARE_IQ16_SC32I_CORR_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32I_CORR_FUNC(funcname) { xtrxdsp_iq16_sc32i_corr_template(iq, outa, outb, corr, stat, bytes); }
+
+#define DECLARE_SC32_FIXUP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32_FIXUP_FUNC(funcname) { xtrxdsp_sc32_fixup_template(iq, corr, bytes); }
+
+#define DECLARE_IC16_FIXUP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IC16_FIXUP_FUNC(funcname) { xtrxdsp_ic16_fixup_template(iq, corr, bytes); }
+
+#define DECLARE_IQ16_SC32_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32_METER_FUNC(funcname) { xtrxdsp_iq16_sc32_meter_template(iq, out, scale, meter, bytes); }
+
+#define DECLARE_IQ12_SC32_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32_METER_FUNC(funcname) { return xtrxdsp_iq12_sc32_meter_template(iq, out, meter, inbytes, prevstate); }
+
+#define DECLARE_IQ8_SC32_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32_METER_FUNC(funcname) { xtrxdsp_iq8_sc32_meter_template(iq, out, meter, bytes); }
+
+#define DECLARE_IQ8_IC16_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16_METER_FUNC(funcname) { xtrxdsp_iq8_ic16_meter_template(iq, out, meter, bytes); }
+
+#define DECLARE_IQ16_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32I_METER_FUNC(funcname) { xtrxdsp_iq16_sc32i_meter_template(iq, outa, outb, scale, meter, bytes); }
+
+#define DECLARE_IQ16_IC16I_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_IC16I_METER_FUNC(funcname) { xtrxdsp_iq16_ic16i_meter_template(iq, outa, outb, meter, bytes); }
+
+#define DECLARE_IQ12_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32I_METER_FUNC(funcname) { return xtrxdsp_iq12_sc32i_meter_template(iq, outa, outb, meter, inbytes, prevstate); }
+
+#define DECLARE_IQ8_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32I_METER_FUNC(funcname) { xtrxdsp_iq8_sc32i_meter_template(iq, outa, outb, meter, bytes); }
+
+#define DECLARE_IQ8_IC16I_METER_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16I_METER_FUNC(funcname) { xtrxdsp_iq8_ic16i_meter_template(iq, outa, outb, meter, bytes); }
+
+#define DECLARE_IQ16_HC16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_HC16_FUNC(funcname) { xtrxdsp_iq16_hc16_template(iq, out, scale, bytes); }
+
+#define DECLARE_IQ16_BF16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_BF16_FUNC(funcname) { xtrxdsp_iq16_bf16_template(iq, out, scale, bytes); }
+
+#define DECLARE_HC16_IQ16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_HC16_IQ16_FUNC(funcname) { xtrxdsp_hc16_iq16_template(iq, out, scale, outbytes); }
+
+#define DECLARE_BF16_IQ16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_BF16_IQ16_FUNC(funcname) { xtrxdsp_bf16_iq16_template(iq, out, scale, outbytes); }
+
+#define DECLARE_IQ16_SC64_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC64_FUNC(funcname) { xtrxdsp_iq16_sc64_template(iq, out, scale, bytes); }
+
+#define DECLARE_IQ12_SC64_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC64_FUNC(funcname) { return xtrxdsp_iq12_sc64_template(iq, out, inbytes, prevstate); }
+
+#define DECLARE_SC64_IQ16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC64_IQ16_FUNC(funcname) { xtrxdsp_sc64_iq16_template(iq, out, scale, outbytes); }
+
+#define DECLARE_IQ16_SC32_NT_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32_NT_FUNC(funcname) { xtrxdsp_iq16_sc32_nt_template(iq, out, scale, bytes); }
+
+#define DECLARE_IQ16_SC32I_NT_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32I_NT_FUNC(funcname) { xtrxdsp_iq16_sc32i_nt_template(iq, outa, outb, scale, bytes); }
+
+#define DECLARE_SC32_IQ16_NT_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32_IQ16_NT_FUNC(funcname) { xtrxdsp_sc32_iq16_nt_template(iq, out, scale, outbytes); }
+
+#define DECLARE_IQ12_SC32_NT_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32_NT_FUNC(funcname) { return xtrxdsp_iq12_sc32_nt_template(iq, out, inbytes, prevstate); }
+
+#define DECLARE_IQ8_SC32_NT_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32_NT_FUNC(funcname) { xtrxdsp_iq8_sc32_nt_template(iq, out, bytes); }
+
+#define DECLARE_IQ16_IC16I_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_IC16I_IP_FUNC(funcname) { xtrxdsp_iq16_ic16i_ip_template(iq, outb, bytes); }
+
+#define DECLARE_IQ8_IC8I_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC8I_IP_FUNC(funcname) { xtrxdsp_iq8_ic8i_ip_template(iq, outb, bytes); }
+
+#define DECLARE_IC16I_IQ16_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IC16I_IQ16_IP_FUNC(funcname) { xtrxdsp_ic16i_iq16_ip_template(i, q, outbytes); }
+
+#define DECLARE_SC32_IQ16_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32_IQ16_IP_FUNC(funcname) { xtrxdsp_sc32_iq16_ip_template(buf, scale, outbytes); }
+
+#define DECLARE_IQ16_SC32_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32_IP_FUNC(funcname) { xtrxdsp_iq16_sc32_ip_template(buf, scale, inbytes); }
+
+#define DECLARE_IQ8_SC32_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32_IP_FUNC(funcname) { xtrxdsp_iq8_sc32_ip_template(buf, inbytes); }
+
+#define DECLARE_IQ8_IC16_IP_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16_IP_FUNC(funcname) { xtrxdsp_iq8_ic16_ip_template(buf, inbytes); }
+
+#define DECLARE_IQ16_SC32N_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_SC32N_FUNC(funcname) { xtrxdsp_iq16_sc32n_template(iq, out, chans, scale, bytes); }
+
+#define DECLARE_IQ16_IC16N_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ16_IC16N_FUNC(funcname) { xtrxdsp_iq16_ic16n_template(iq, out, chans, bytes); }
+
+#define DECLARE_IQ12_SC32N_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ12_SC32N_FUNC(funcname) { xtrxdsp_iq12_sc32n_template(iq, out, chans, inbytes); }
+
+#define DECLARE_IQ8_SC32N_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_SC32N_FUNC(funcname) { xtrxdsp_iq8_sc32n_template(iq, out, chans, bytes); }
+
+#define DECLARE_IQ8_IC16N_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IQ8_IC16N_FUNC(funcname) { xtrxdsp_iq8_ic16n_template(iq, out, chans, bytes); }
+
+#define DECLARE_SC32N_IQ16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_SC32N_IQ16_FUNC(funcname) { xtrxdsp_sc32n_iq16_template(in, chans, out, scale, outbytes); }
+
+#define DECLARE_IC16N_IQ16_FUNC_TEMPLATE(funcname) \
+	XTRXDSP_TEMPLATE_LINKAGE DECLARE_IC16N_IQ16_FUNC(funcname) { xtrxdsp_ic16n_iq16_template(in, chans, out, outbytes); }
 
 #define DECLARE_TEMPLATES(funcname)             \
 	DECLARE_IQ16_SC32_FUNC_TEMPLATE(funcname)   \
@@ -162,7 +641,47 @@ void xtrxdsp_init(void);
 	DECLARE_SC32I_IQ16_FUNC_TEMPLATE(funcname)  \
 	DECLARE_IC16I_IQ16_FUNC_TEMPLATE(funcname)  \
 	DECLARE_IQ8_IC16I_FUNC_TEMPLATE(funcname)    \
-	DECLARE_IQ8_IC8I_FUNC_TEMPLATE(funcname)
+	DECLARE_IQ8_IC8I_FUNC_TEMPLATE(funcname)    \
+	DECLARE_IQ16_SC32_CORR_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC32_CORR_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32I_CORR_FUNC_TEMPLATE(funcname) \
+	DECLARE_SC32_FIXUP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IC16_FIXUP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC32_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_SC32_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_IC16_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_IC16I_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_SC32I_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_IC16I_METER_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_HC16_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_BF16_FUNC_TEMPLATE(funcname) \
+	DECLARE_HC16_IQ16_FUNC_TEMPLATE(funcname) \
+	DECLARE_BF16_IQ16_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC64_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC64_FUNC_TEMPLATE(funcname) \
+	DECLARE_SC64_IQ16_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32_NT_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32I_NT_FUNC_TEMPLATE(funcname) \
+	DECLARE_SC32_IQ16_NT_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC32_NT_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_SC32_NT_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_IC16I_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_IC8I_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IC16I_IQ16_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_SC32_IQ16_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_SC32_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_IC16_IP_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_SC32N_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ16_IC16N_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ12_SC32N_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_SC32N_FUNC_TEMPLATE(funcname) \
+	DECLARE_IQ8_IC16N_FUNC_TEMPLATE(funcname) \
+	DECLARE_SC32N_IQ16_FUNC_TEMPLATE(funcname) \
+	DECLARE_IC16N_IQ16_FUNC_TEMPLATE(funcname)
 
 
 
@@ -232,6 +751,250 @@ extern void xtrxdsp_iq8_ic16i(const int8_t *__restrict iq,
 							  int16_t *__restrict outb,
 							  size_t bytes);
 
+/* converters with DC offset and IQ imbalance correction, optionally
+ * accumulating statistics of the output for the estimator
+ */
+extern void xtrxdsp_iq16_sc32_corr(const int16_t *__restrict iq,
+								   float *__restrict out,
+								   const xtrxdsp_iqcorr_t *__restrict corr,
+								   xtrxdsp_iqcorr_stat_t *__restrict stat,
+								   size_t bytes);
+
+extern uint64_t xtrxdsp_iq12_sc32_corr(const void *__restrict iq,
+									   float *__restrict out,
+									   const xtrxdsp_iqcorr_t *__restrict corr,
+									   xtrxdsp_iqcorr_stat_t *__restrict stat,
+									   size_t inbytes,
+									   uint64_t prevstate);
+
+extern void xtrxdsp_iq16_sc32i_corr(const int16_t *__restrict iq,
+									float *__restrict outa,
+									float *__restrict outb,
+									const xtrxdsp_iqcorr_t *__restrict corr,
+									xtrxdsp_iqcorr_stat_t *__restrict stat,
+									size_t bytes);
+
+/* in-place output fixups of corr->flags and gains for the converters
+ * without correction: sc32 for float and ic16 for int16 interleaved I/Q,
+ * i.e. output of RX converters or wire data produced by TX ones. The int16
+ * version truncates and saturates. Pure swaps and negations skip the
+ * multiplication
+ */
+extern void xtrxdsp_sc32_fixup(float *iq,
+							   const xtrxdsp_iqcorr_t *__restrict corr,
+							   size_t bytes);
+
+extern void xtrxdsp_ic16_fixup(int16_t *iq,
+							   const xtrxdsp_iqcorr_t *__restrict corr,
+							   size_t bytes);
+
+/* converters accumulating per channel metering of the input */
+extern void xtrxdsp_iq16_sc32_meter(const int16_t *__restrict iq,
+									float *__restrict out,
+									float scale,
+									xtrxdsp_meter_t *__restrict meter,
+									size_t bytes);
+
+extern uint64_t xtrxdsp_iq12_sc32_meter(const void *__restrict iq,
+										float *__restrict out,
+										xtrxdsp_meter_t *__restrict meter,
+										size_t inbytes,
+										uint64_t prevstate);
+
+extern void xtrxdsp_iq8_sc32_meter(const int8_t *__restrict iq,
+								   float *__restrict out,
+								   xtrxdsp_meter_t *__restrict meter,
+								   size_t bytes);
+
+extern void xtrxdsp_iq8_ic16_meter(const int8_t *__restrict iq,
+								   int16_t *__restrict out,
+								   xtrxdsp_meter_t *__restrict meter,
+								   size_t bytes);
+
+extern void xtrxdsp_iq16_sc32i_meter(const int16_t *__restrict iq,
+									 float *__restrict outa,
+									 float *__restrict outb,
+									 float scale,
+									 xtrxdsp_meter_t *__restrict meter,
+									 size_t bytes);
+
+extern void xtrxdsp_iq16_ic16i_meter(const int16_t *__restrict iq,
+									 int16_t *__restrict outa,
+									 int16_t *__restrict outb,
+									 xtrxdsp_meter_t *__restrict meter,
+									 size_t bytes);
+
+extern uint64_t xtrxdsp_iq12_sc32i_meter(const void *__restrict iq,
+										 float *__restrict outa,
+										 float *__restrict outb,
+										 xtrxdsp_meter_t *__restrict meter,
+										 size_t inbytes,
+										 uint64_t prevstate);
+
+extern void xtrxdsp_iq8_sc32i_meter(const int8_t *__restrict iq,
+									float *__restrict outa,
+									float *__restrict outb,
+									xtrxdsp_meter_t *__restrict meter,
+									size_t bytes);
+
+extern void xtrxdsp_iq8_ic16i_meter(const int8_t *__restrict iq,
+									int16_t *__restrict outa,
+									int16_t *__restrict outb,
+									xtrxdsp_meter_t *__restrict meter,
+									size_t bytes);
+
+/* half precision converters, hc16 is IEEE 754 binary16 and bf16 is bfloat16,
+ * both round to nearest even, TX direction rounds and saturates to int16
+ */
+extern void xtrxdsp_iq16_hc16(const int16_t *__restrict iq,
+							  uint16_t *__restrict out,
+							  float scale,
+							  size_t bytes);
+
+extern void xtrxdsp_iq16_bf16(const int16_t *__restrict iq,
+							  uint16_t *__restrict out,
+							  float scale,
+							  size_t bytes);
+
+extern void xtrxdsp_hc16_iq16(const uint16_t *__restrict iq,
+							  int16_t *__restrict out,
+							  float scale,
+							  size_t outbytes);
+
+extern void xtrxdsp_bf16_iq16(const uint16_t *__restrict iq,
+							  int16_t *__restrict out,
+							  float scale,
+							  size_t outbytes);
+
+/* complex double converters, TX direction rounds and saturates to int16 */
+extern void xtrxdsp_iq16_sc64(const int16_t *__restrict iq,
+							  double *__restrict out,
+							  double scale,
+							  size_t bytes);
+
+extern uint64_t xtrxdsp_iq12_sc64(const void *__restrict iq,
+								  double *__restrict out,
+								  size_t inbytes,
+								  uint64_t prevstate);
+
+extern void xtrxdsp_sc64_iq16(const double *__restrict iq,
+							  int16_t *__restrict out,
+							  double scale,
+							  size_t outbytes);
+
+/* same as xtrxdsp_iq16_sc32(), xtrxdsp_iq16_sc32i(), xtrxdsp_sc32_iq16(),
+ * xtrxdsp_iq12_sc32() and xtrxdsp_iq8_sc32() but with non-temporal stores, use
+ * for large buffers not read back by the calling core, e.g. recording to disk
+ */
+extern void xtrxdsp_iq16_sc32_nt(const int16_t *__restrict iq,
+								 float *__restrict out,
+								 float scale,
+								 size_t bytes);
+
+extern void xtrxdsp_iq16_sc32i_nt(const int16_t *__restrict iq,
+								  float *__restrict outa,
+								  float *__restrict outb,
+								  float scale,
+								  size_t bytes);
+
+extern void xtrxdsp_sc32_iq16_nt(const float *__restrict iq,
+								 int16_t *__restrict out,
+								 float scale,
+								 size_t outbytes);
+
+extern uint64_t xtrxdsp_iq12_sc32_nt(const void *__restrict iq,
+									 float *__restrict out,
+									 size_t inbytes,
+									 uint64_t prevstate);
+
+extern void xtrxdsp_iq8_sc32_nt(const int8_t *__restrict iq,
+								float *__restrict out,
+								size_t bytes);
+
+/* In-place conversions.
+ *
+ * Deinterleavers leave channel A at the start of iq and write channel B to
+ * outb, which must not overlap iq; xtrxdsp_ic16i_iq16_ip() is the opposite,
+ * i holds channel A on input and should be outbytes long.
+ * Expanding conversions take buf sized for the output and inbytes of data at
+ * its start, they run backward from the tail. Other parameters are the same
+ * as for the regular converters */
+extern void xtrxdsp_iq16_ic16i_ip(int16_t *iq,
+								  int16_t *__restrict outb,
+								  size_t bytes);
+
+extern void xtrxdsp_iq8_ic8i_ip(int8_t *iq,
+								int8_t *__restrict outb,
+								size_t bytes);
+
+extern void xtrxdsp_ic16i_iq16_ip(int16_t *i,
+								  const int16_t *__restrict q,
+								  size_t outbytes);
+
+extern void xtrxdsp_sc32_iq16_ip(void *buf,
+								 float scale,
+								 size_t outbytes);
+
+extern void xtrxdsp_iq16_sc32_ip(void *buf,
+								 float scale,
+								 size_t inbytes);
+
+extern void xtrxdsp_iq8_sc32_ip(void *buf,
+								size_t inbytes);
+
+extern void xtrxdsp_iq8_ic16_ip(void *buf,
+								size_t inbytes);
+
+/* N-way converters for streams of chans interleaved complex channels, i.e.
+ * several boards aggregated into one stream. The stream is a sequence of
+ * frames, frame f holding sample f of channel 0, 1 ... chans - 1, each one a
+ * whole wire sample with I first:
+ *
+ *   iq16: I0 Q0 I1 Q1 ... (2 bytes each)
+ *   iq8:  I0 Q0 I1 Q1 ... (1 byte each)
+ *   iq12: 3 bytes per I/Q pair, packed as in xtrxdsp_iq12_sc32()
+ *
+ * Every channel gets its own interleaved I/Q buffer out[0] ... out[chans - 1]
+ * (or in[] for TX). Note that for 2 channels this is not the layout of
+ * xtrxdsp_iq16_sc32i(), which splits alternate 16 bit words A.I B.I A.Q B.Q.
+ * Only whole frames are converted, 4 and 8 channels have vectorized paths */
+extern void xtrxdsp_iq16_sc32n(const int16_t *__restrict iq,
+							   float *const *__restrict out,
+							   unsigned chans,
+							   float scale,
+							   size_t bytes);
+
+extern void xtrxdsp_iq16_ic16n(const int16_t *__restrict iq,
+							   int16_t *const *__restrict out,
+							   unsigned chans,
+							   size_t bytes);
+
+extern void xtrxdsp_iq12_sc32n(const void *__restrict iq,
+							   float *const *__restrict out,
+							   unsigned chans,
+							   size_t inbytes);
+
+extern void xtrxdsp_iq8_sc32n(const int8_t *__restrict iq,
+							  float *const *__restrict out,
+							  unsigned chans,
+							  size_t bytes);
+
+extern void xtrxdsp_iq8_ic16n(const int8_t *__restrict iq,
+							  int16_t *const *__restrict out,
+							  unsigned chans,
+							  size_t bytes);
+
+extern void xtrxdsp_sc32n_iq16(const float *const *__restrict in,
+							   unsigned chans,
+							   int16_t *__restrict out,
+							   float scale,
+							   size_t outbytes);
+
+extern void xtrxdsp_ic16n_iq16(const int16_t *const *__restrict in,
+							   unsigned chans,
+							   int16_t *__restrict out,
+							   size_t outbytes);
+
 
 /* non vector optimized version */
 DECLARE_IQ16_SC32_FUNC(no);
@@ -251,6 +1014,53 @@ DECLARE_SC32I_IQ16_FUNC(no);
 DECLARE_IC16I_IQ16_FUNC(no);
 DECLARE_IQ16_IC16I_FUNC(no);
 
+DECLARE_IQ16_SC32_CORR_FUNC(no);
+DECLARE_IQ12_SC32_CORR_FUNC(no);
+DECLARE_IQ16_SC32I_CORR_FUNC(no);
+DECLARE_SC32_FIXUP_FUNC(no);
+DECLARE_IC16_FIXUP_FUNC(no);
+
+DECLARE_IQ16_SC32_METER_FUNC(no);
+DECLARE_IQ12_SC32_METER_FUNC(no);
+DECLARE_IQ8_SC32_METER_FUNC(no);
+DECLARE_IQ8_IC16_METER_FUNC(no);
+DECLARE_IQ16_SC32I_METER_FUNC(no);
+DECLARE_IQ16_IC16I_METER_FUNC(no);
+DECLARE_IQ12_SC32I_METER_FUNC(no);
+DECLARE_IQ8_SC32I_METER_FUNC(no);
+DECLARE_IQ8_IC16I_METER_FUNC(no);
+
+DECLARE_IQ16_HC16_FUNC(no);
+DECLARE_IQ16_BF16_FUNC(no);
+DECLARE_HC16_IQ16_FUNC(no);
+DECLARE_BF16_IQ16_FUNC(no);
+
+DECLARE_IQ16_SC64_FUNC(no);
+DECLARE_IQ12_SC64_FUNC(no);
+DECLARE_SC64_IQ16_FUNC(no);
+
+DECLARE_IQ16_SC32_NT_FUNC(no);
+DECLARE_IQ16_SC32I_NT_FUNC(no);
+DECLARE_SC32_IQ16_NT_FUNC(no);
+DECLARE_IQ12_SC32_NT_FUNC(no);
+DECLARE_IQ8_SC32_NT_FUNC(no);
+
+DECLARE_IQ16_IC16I_IP_FUNC(no);
+DECLARE_IQ8_IC8I_IP_FUNC(no);
+DECLARE_IC16I_IQ16_IP_FUNC(no);
+DECLARE_SC32_IQ16_IP_FUNC(no);
+DECLARE_IQ16_SC32_IP_FUNC(no);
+DECLARE_IQ8_SC32_IP_FUNC(no);
+DECLARE_IQ8_IC16_IP_FUNC(no);
+
+DECLARE_IQ16_SC32N_FUNC(no);
+DECLARE_IQ16_IC16N_FUNC(no);
+DECLARE_IQ12_SC32N_FUNC(no);
+DECLARE_IQ8_SC32N_FUNC(no);
+DECLARE_IQ8_IC16N_FUNC(no);
+DECLARE_SC32N_IQ16_FUNC(no);
+DECLARE_IC16N_IQ16_FUNC(no);
+
 #define CONCAT(x, y) x##y
 
 /* CONVOLUTIONS */
@@ -292,12 +1102,48 @@ DECLARE_IQ16_IC16I_FUNC(no);
 #define DECLARE_B4_EXPAND_X4_FUNC(funcname) \
 	DECLARE_BX_EXPAND_X_BASE(CONCAT(xtrxdsp_b4_expand_x4,funcname))
 
+/* NCO, count in complex samples, returns phase accumulator for the next call */
+#define DECLARE_SC32_NCO_BASE(func) \
+	uint32_t func (const float *__restrict in, \
+	float *__restrict out, \
+	unsigned count, \
+	uint32_t phase, \
+	uint32_t dphase)
+
+#define DECLARE_SC32_NCO_FUNC(funcname) \
+	DECLARE_SC32_NCO_BASE(CONCAT(xtrxdsp_sc32_nco,funcname))
+
+#define DECLARE_IC16_NCO_BASE(func) \
+	uint32_t func (const int16_t *__restrict in, \
+	int16_t *__restrict out, \
+	unsigned count, \
+	uint32_t phase, \
+	uint32_t dphase)
+
+#define DECLARE_IC16_NCO_FUNC(funcname) \
+	DECLARE_IC16_NCO_BASE(CONCAT(xtrxdsp_ic16_nco,funcname))
+
+/* NCO followed by scaling and saturation to wire format */
+#define DECLARE_SC32_NCO_IQ16_BASE(func) \
+	uint32_t func (const float *__restrict in, \
+	int16_t *__restrict out, \
+	unsigned count, \
+	float scale, \
+	uint32_t phase, \
+	uint32_t dphase)
+
+#define DECLARE_SC32_NCO_IQ16_FUNC(funcname) \
+	DECLARE_SC32_NCO_IQ16_BASE(CONCAT(xtrxdsp_sc32_nco_iq16,funcname))
+
 DECLARE_SC32_CONV64_FUNC();
 DECLARE_B8_EXPAND_X2_FUNC();
 DECLARE_B8_EXPAND_X4_FUNC();
 DECLARE_IQ16_CONV64_FUNC();
 DECLARE_B4_EXPAND_X2_FUNC();
 DECLARE_B4_EXPAND_X4_FUNC();
+DECLARE_SC32_NCO_FUNC();
+DECLARE_IC16_NCO_FUNC();
+DECLARE_SC32_NCO_IQ16_FUNC();
 
 DECLARE_SC32_CONV64_FUNC(_no);
 DECLARE_B8_EXPAND_X2_FUNC(_no);
@@ -305,10 +1151,11 @@ DECLARE_B8_EXPAND_X4_FUNC(_no);
 DECLARE_IQ16_CONV64_FUNC(_no);
 DECLARE_B4_EXPAND_X2_FUNC(_no);
 DECLARE_B4_EXPAND_X4_FUNC(_no);
+DECLARE_SC32_NCO_FUNC(_no);
+DECLARE_IC16_NCO_FUNC(_no);
+DECLARE_SC32_NCO_IQ16_FUNC(_no);
 
 #if defined(__x86_64__) || defined(__i386__)
-#include <immintrin.h>
-
 #ifdef XTRXDSP_HAS__SSE2__
 /* SSE2   */
 DECLARE_IQ16_SC32_FUNC(sse2);
@@ -328,6 +1175,53 @@ DECLARE_SC32I_IQ16_FUNC(sse2);
 DECLARE_IC16I_IQ16_FUNC(sse2);
 DECLARE_IQ16_IC16I_FUNC(sse2);
 
+DECLARE_IQ16_SC32_CORR_FUNC(sse2);
+DECLARE_IQ12_SC32_CORR_FUNC(sse2);
+DECLARE_IQ16_SC32I_CORR_FUNC(sse2);
+DECLARE_SC32_FIXUP_FUNC(sse2);
+DECLARE_IC16_FIXUP_FUNC(sse2);
+
+DECLARE_IQ16_SC32_METER_FUNC(sse2);
+DECLARE_IQ12_SC32_METER_FUNC(sse2);
+DECLARE_IQ8_SC32_METER_FUNC(sse2);
+DECLARE_IQ8_IC16_METER_FUNC(sse2);
+DECLARE_IQ16_SC32I_METER_FUNC(sse2);
+DECLARE_IQ16_IC16I_METER_FUNC(sse2);
+DECLARE_IQ12_SC32I_METER_FUNC(sse2);
+DECLARE_IQ8_SC32I_METER_FUNC(sse2);
+DECLARE_IQ8_IC16I_METER_FUNC(sse2);
+
+DECLARE_IQ16_HC16_FUNC(sse2);
+DECLARE_IQ16_BF16_FUNC(sse2);
+DECLARE_HC16_IQ16_FUNC(sse2);
+DECLARE_BF16_IQ16_FUNC(sse2);
+
+DECLARE_IQ16_SC64_FUNC(sse2);
+DECLARE_IQ12_SC64_FUNC(sse2);
+DECLARE_SC64_IQ16_FUNC(sse2);
+
+DECLARE_IQ16_SC32_NT_FUNC(sse2);
+DECLARE_IQ16_SC32I_NT_FUNC(sse2);
+DECLARE_SC32_IQ16_NT_FUNC(sse2);
+DECLARE_IQ12_SC32_NT_FUNC(sse2);
+DECLARE_IQ8_SC32_NT_FUNC(sse2);
+
+DECLARE_IQ16_IC16I_IP_FUNC(sse2);
+DECLARE_IQ8_IC8I_IP_FUNC(sse2);
+DECLARE_IC16I_IQ16_IP_FUNC(sse2);
+DECLARE_SC32_IQ16_IP_FUNC(sse2);
+DECLARE_IQ16_SC32_IP_FUNC(sse2);
+DECLARE_IQ8_SC32_IP_FUNC(sse2);
+DECLARE_IQ8_IC16_IP_FUNC(sse2);
+
+DECLARE_IQ16_SC32N_FUNC(sse2);
+DECLARE_IQ16_IC16N_FUNC(sse2);
+DECLARE_IQ12_SC32N_FUNC(sse2);
+DECLARE_IQ8_SC32N_FUNC(sse2);
+DECLARE_IQ8_IC16N_FUNC(sse2);
+DECLARE_SC32N_IQ16_FUNC(sse2);
+DECLARE_IC16N_IQ16_FUNC(sse2);
+
 #endif
 
 #ifdef XTRXDSP_HAS__SSSE3__
@@ -361,6 +1255,53 @@ DECLARE_SC32I_IQ16_FUNC(avx);
 DECLARE_IC16I_IQ16_FUNC(avx);
 DECLARE_IQ16_IC16I_FUNC(avx);
 
+DECLARE_IQ16_SC32_CORR_FUNC(avx);
+DECLARE_IQ12_SC32_CORR_FUNC(avx);
+DECLARE_IQ16_SC32I_CORR_FUNC(avx);
+DECLARE_SC32_FIXUP_FUNC(avx);
+DECLARE_IC16_FIXUP_FUNC(avx);
+
+DECLARE_IQ16_SC32_METER_FUNC(avx);
+DECLARE_IQ12_SC32_METER_FUNC(avx);
+DECLARE_IQ8_SC32_METER_FUNC(avx);
+DECLARE_IQ8_IC16_METER_FUNC(avx);
+DECLARE_IQ16_SC32I_METER_FUNC(avx);
+DECLARE_IQ16_IC16I_METER_FUNC(avx);
+DECLARE_IQ12_SC32I_METER_FUNC(avx);
+DECLARE_IQ8_SC32I_METER_FUNC(avx);
+DECLARE_IQ8_IC16I_METER_FUNC(avx);
+
+DECLARE_IQ16_HC16_FUNC(avx);
+DECLARE_IQ16_BF16_FUNC(avx);
+DECLARE_HC16_IQ16_FUNC(avx);
+DECLARE_BF16_IQ16_FUNC(avx);
+
+DECLARE_IQ16_SC64_FUNC(avx);
+DECLARE_IQ12_SC64_FUNC(avx);
+DECLARE_SC64_IQ16_FUNC(avx);
+
+DECLARE_IQ16_SC32_NT_FUNC(avx);
+DECLARE_IQ16_SC32I_NT_FUNC(avx);
+DECLARE_SC32_IQ16_NT_FUNC(avx);
+DECLARE_IQ12_SC32_NT_FUNC(avx);
+DECLARE_IQ8_SC32_NT_FUNC(avx);
+
+DECLARE_IQ16_IC16I_IP_FUNC(avx);
+DECLARE_IQ8_IC8I_IP_FUNC(avx);
+DECLARE_IC16I_IQ16_IP_FUNC(avx);
+DECLARE_SC32_IQ16_IP_FUNC(avx);
+DECLARE_IQ16_SC32_IP_FUNC(avx);
+DECLARE_IQ8_SC32_IP_FUNC(avx);
+DECLARE_IQ8_IC16_IP_FUNC(avx);
+
+DECLARE_IQ16_SC32N_FUNC(avx);
+DECLARE_IQ16_IC16N_FUNC(avx);
+DECLARE_IQ12_SC32N_FUNC(avx);
+DECLARE_IQ8_SC32N_FUNC(avx);
+DECLARE_IQ8_IC16N_FUNC(avx);
+DECLARE_SC32N_IQ16_FUNC(avx);
+DECLARE_IC16N_IQ16_FUNC(avx);
+
 #endif
 
 /* AVX2   */
@@ -383,6 +1324,9 @@ DECLARE_SC32_CONV64_FUNC(_sse2);
 //DECLARE_B8_EXPAND_X2_FUNC(_sse2);
 //DECLARE_B8_EXPAND_X4_FUNC(_sse2);
 DECLARE_IQ16_CONV64_FUNC(_sse2);
+DECLARE_SC32_NCO_FUNC(_sse2);
+DECLARE_IC16_NCO_FUNC(_sse2);
+DECLARE_SC32_NCO_IQ16_FUNC(_sse2);
 #endif
 
 #ifdef XTRXDSP_HAS__AVX__
@@ -390,10 +1334,18 @@ DECLARE_SC32_CONV64_FUNC(_avx);
 //DECLARE_B8_EXPAND_X2_FUNC(_avx);
 //DECLARE_B8_EXPAND_X4_FUNC(_avx);
 DECLARE_IQ16_CONV64_FUNC(_avx);
+DECLARE_SC32_NCO_FUNC(_avx);
+DECLARE_IC16_NCO_FUNC(_avx);
+DECLARE_SC32_NCO_IQ16_FUNC(_avx);
 
 #ifdef XTRXDSP_HAS__FMA__
 DECLARE_SC32_CONV64_FUNC(_avx_fma);
 #endif
+
+#ifdef XTRXDSP_HAS__F16C__
+DECLARE_IQ16_HC16_FUNC(avx_f16c);
+DECLARE_HC16_IQ16_FUNC(avx_f16c);
+#endif
 #endif
 
 
@@ -401,15 +1353,292 @@ DECLARE_SC32_CONV64_FUNC(_avx_fma);
 
 typedef DECLARE_BX_EXPAND_X_BASE( (*func_xtrxdsp_bx_expand_t) );
 
-typedef DECLARE_SC32_CONV64_BASE( (*func_xtrxdsp_sc32_conv64_t) );
-func_xtrxdsp_sc32_conv64_t resolve_xtrxdsp_sc32_conv64(void);
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x2(void);
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b8_expand_x4(void);
+/*
+ * Every dispatched function in xtrxdsp_dispatch_t order as
+ * X(name, ret, params, args, samples, isas):
+ *  name    - function name without xtrxdsp_ prefix
+ *  ret     - return type, void, uint32_t or uint64_t
+ *  params  - parameter list, args - the same names as an argument list
+ *  samples - samples processed by one call, for kernel counters
+ *  isas    - variants probed on x86 before the generic one, best first
+ *
+ * The library generates its entry points, resolvers and the dispatch table
+ * from this list, a kernel added here gets all of them.
+ */
+#define XTRXDSP_DISPATCH_KERNELS(X) \
+	X(iq16_sc32, void, \
+		(const int16_t *__restrict iq, float *__restrict out, float scale, size_t bytes), \
+		(iq, out, scale, bytes), bytes / 4, (AVX2, AVX, SSE2)) \
+	X(iq12_sc32, uint64_t, \
+		(const void *__restrict iq, float *__restrict out, size_t inbytes, uint64_t prevstate), \
+		(iq, out, inbytes, prevstate), inbytes / 3, (AVX2, AVX, SSSE3, SSE2)) \
+	X(iq8_sc32, void, \
+		(const int8_t *__restrict iq, float *__restrict out, size_t bytes), \
+		(iq, out, bytes), bytes / 2, (AVX2, AVX, SSE4_1, SSE2)) \
+	X(iq8_ic16, void, \
+		(const int8_t *__restrict iq, int16_t *__restrict out, size_t bytes), \
+		(iq, out, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq16_sc32i, void, \
+		(const int16_t *__restrict iq, float *__restrict outa, float *__restrict outb, float scale, size_t bytes), \
+		(iq, outa, outb, scale, bytes), bytes / 4, (AVX2, AVX, SSE2)) \
+	X(iq16_ic16i, void, \
+		(const int16_t *__restrict iq, int16_t *__restrict outa, int16_t *__restrict outb, size_t bytes), \
+		(iq, outa, outb, bytes), bytes / 4, (AVX2, AVX, SSE2)) \
+	X(iq8_sc32i, void, \
+		(const int8_t *__restrict iq, float *__restrict outa, float *__restrict outb, size_t bytes), \
+		(iq, outa, outb, bytes), bytes / 2, (AVX2, AVX, SSE4_1, SSE2)) \
+	X(sc32_iq16, void, \
+		(const float *__restrict iq, int16_t *__restrict out, float scale, size_t outbytes), \
+		(iq, out, scale, outbytes), outbytes / 4, (AVX2, AVX, SSE2)) \
+	X(sc32i_iq16, void, \
+		(const float *__restrict i, const float *__restrict q, int16_t *__restrict out, float scale, size_t outbytes), \
+		(i, q, out, scale, outbytes), outbytes / 4, (AVX2, AVX, SSE2)) \
+	X(ic16i_iq16, void, \
+		(const int16_t *__restrict i, const int16_t *__restrict q, int16_t *__restrict out, size_t outbytes), \
+		(i, q, out, outbytes), outbytes / 4, (AVX2, AVX, SSE2)) \
+	X(iq8_ic8i, void, \
+		(const int8_t *__restrict iq, int8_t *__restrict outa, int8_t *__restrict outb, size_t bytes), \
+		(iq, outa, outb, bytes), bytes / 2, (AVX2, AVX, SSE2)) \
+	X(iq8_ic16i, void, \
+		(const int8_t *__restrict iq, int16_t *__restrict outa, int16_t *__restrict outb, size_t bytes), \
+		(iq, outa, outb, bytes), bytes / 2, (AVX2, AVX, SSE2)) \
+	X(iq16_sc32_corr, void, \
+		(const int16_t *__restrict iq, float *__restrict out, const xtrxdsp_iqcorr_t *__restrict corr, xtrxdsp_iqcorr_stat_t *__restrict stat, size_t bytes), \
+		(iq, out, corr, stat, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq12_sc32_corr, uint64_t, \
+		(const void *__restrict iq, float *__restrict out, const xtrxdsp_iqcorr_t *__restrict corr, xtrxdsp_iqcorr_stat_t *__restrict stat, size_t inbytes, uint64_t prevstate), \
+		(iq, out, corr, stat, inbytes, prevstate), inbytes / 3, (AVX, SSE2)) \
+	X(iq16_sc32i_corr, void, \
+		(const int16_t *__restrict iq, float *__restrict outa, float *__restrict outb, const xtrxdsp_iqcorr_t *__restrict corr, xtrxdsp_iqcorr_stat_t *__restrict stat, size_t bytes), \
+		(iq, outa, outb, corr, stat, bytes), bytes / 4, (AVX, SSE2)) \
+	X(sc32_fixup, void, \
+		(float *iq, const xtrxdsp_iqcorr_t *__restrict corr, size_t bytes), \
+		(iq, corr, bytes), bytes / 8, (AVX, SSE2)) \
+	X(ic16_fixup, void, \
+		(int16_t *iq, const xtrxdsp_iqcorr_t *__restrict corr, size_t bytes), \
+		(iq, corr, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq16_sc32_meter, void, \
+		(const int16_t *__restrict iq, float *__restrict out, float scale, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, out, scale, meter, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq12_sc32_meter, uint64_t, \
+		(const void *__restrict iq, float *__restrict out, xtrxdsp_meter_t *__restrict meter, size_t inbytes, uint64_t prevstate), \
+		(iq, out, meter, inbytes, prevstate), inbytes / 3, (AVX, SSE2)) \
+	X(iq8_sc32_meter, void, \
+		(const int8_t *__restrict iq, float *__restrict out, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, out, meter, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq8_ic16_meter, void, \
+		(const int8_t *__restrict iq, int16_t *__restrict out, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, out, meter, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq16_sc32i_meter, void, \
+		(const int16_t *__restrict iq, float *__restrict outa, float *__restrict outb, float scale, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, outa, outb, scale, meter, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq16_ic16i_meter, void, \
+		(const int16_t *__restrict iq, int16_t *__restrict outa, int16_t *__restrict outb, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, outa, outb, meter, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq12_sc32i_meter, uint64_t, \
+		(const void *__restrict iq, float *__restrict outa, float *__restrict outb, xtrxdsp_meter_t *__restrict meter, size_t inbytes, uint64_t prevstate), \
+		(iq, outa, outb, meter, inbytes, prevstate), inbytes / 3, (AVX, SSE2)) \
+	X(iq8_sc32i_meter, void, \
+		(const int8_t *__restrict iq, float *__restrict outa, float *__restrict outb, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, outa, outb, meter, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq8_ic16i_meter, void, \
+		(const int8_t *__restrict iq, int16_t *__restrict outa, int16_t *__restrict outb, xtrxdsp_meter_t *__restrict meter, size_t bytes), \
+		(iq, outa, outb, meter, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq16_hc16, void, \
+		(const int16_t *__restrict iq, uint16_t *__restrict out, float scale, size_t bytes), \
+		(iq, out, scale, bytes), bytes / 4, (AVX_F16C, AVX, SSE2)) \
+	X(iq16_bf16, void, \
+		(const int16_t *__restrict iq, uint16_t *__restrict out, float scale, size_t bytes), \
+		(iq, out, scale, bytes), bytes / 4, (AVX, SSE2)) \
+	X(hc16_iq16, void, \
+		(const uint16_t *__restrict iq, int16_t *__restrict out, float scale, size_t outbytes), \
+		(iq, out, scale, outbytes), outbytes / 4, (AVX_F16C, AVX, SSE2)) \
+	X(bf16_iq16, void, \
+		(const uint16_t *__restrict iq, int16_t *__restrict out, float scale, size_t outbytes), \
+		(iq, out, scale, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(iq16_sc64, void, \
+		(const int16_t *__restrict iq, double *__restrict out, double scale, size_t bytes), \
+		(iq, out, scale, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq12_sc64, uint64_t, \
+		(const void *__restrict iq, double *__restrict out, size_t inbytes, uint64_t prevstate), \
+		(iq, out, inbytes, prevstate), inbytes / 3, (AVX, SSE2)) \
+	X(sc64_iq16, void, \
+		(const double *__restrict iq, int16_t *__restrict out, double scale, size_t outbytes), \
+		(iq, out, scale, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(iq16_sc32_nt, void, \
+		(const int16_t *__restrict iq, float *__restrict out, float scale, size_t bytes), \
+		(iq, out, scale, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq16_sc32i_nt, void, \
+		(const int16_t *__restrict iq, float *__restrict outa, float *__restrict outb, float scale, size_t bytes), \
+		(iq, outa, outb, scale, bytes), bytes / 4, (AVX, SSE2)) \
+	X(sc32_iq16_nt, void, \
+		(const float *__restrict iq, int16_t *__restrict out, float scale, size_t outbytes), \
+		(iq, out, scale, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(iq12_sc32_nt, uint64_t, \
+		(const void *__restrict iq, float *__restrict out, size_t inbytes, uint64_t prevstate), \
+		(iq, out, inbytes, prevstate), inbytes / 3, (AVX, SSE2)) \
+	X(iq8_sc32_nt, void, \
+		(const int8_t *__restrict iq, float *__restrict out, size_t bytes), \
+		(iq, out, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq16_ic16i_ip, void, \
+		(int16_t *iq, int16_t *__restrict outb, size_t bytes), \
+		(iq, outb, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq8_ic8i_ip, void, \
+		(int8_t *iq, int8_t *__restrict outb, size_t bytes), \
+		(iq, outb, bytes), bytes / 2, (AVX, SSE2)) \
+	X(ic16i_iq16_ip, void, \
+		(int16_t *i, const int16_t *__restrict q, size_t outbytes), \
+		(i, q, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(sc32_iq16_ip, void, \
+		(void *buf, float scale, size_t outbytes), \
+		(buf, scale, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(iq16_sc32_ip, void, \
+		(void *buf, float scale, size_t inbytes), \
+		(buf, scale, inbytes), inbytes / 4, (AVX, SSE2)) \
+	X(iq8_sc32_ip, void, \
+		(void *buf, size_t inbytes), \
+		(buf, inbytes), inbytes / 2, (AVX, SSE2)) \
+	X(iq8_ic16_ip, void, \
+		(void *buf, size_t inbytes), \
+		(buf, inbytes), inbytes / 2, (AVX, SSE2)) \
+	X(iq16_sc32n, void, \
+		(const int16_t *__restrict iq, float *const *__restrict out, unsigned chans, float scale, size_t bytes), \
+		(iq, out, chans, scale, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq16_ic16n, void, \
+		(const int16_t *__restrict iq, int16_t *const *__restrict out, unsigned chans, size_t bytes), \
+		(iq, out, chans, bytes), bytes / 4, (AVX, SSE2)) \
+	X(iq12_sc32n, void, \
+		(const void *__restrict iq, float *const *__restrict out, unsigned chans, size_t inbytes), \
+		(iq, out, chans, inbytes), inbytes / 3, (AVX, SSE2)) \
+	X(iq8_sc32n, void, \
+		(const int8_t *__restrict iq, float *const *__restrict out, unsigned chans, size_t bytes), \
+		(iq, out, chans, bytes), bytes / 2, (AVX, SSE2)) \
+	X(iq8_ic16n, void, \
+		(const int8_t *__restrict iq, int16_t *const *__restrict out, unsigned chans, size_t bytes), \
+		(iq, out, chans, bytes), bytes / 2, (AVX, SSE2)) \
+	X(sc32n_iq16, void, \
+		(const float *const *__restrict in, unsigned chans, int16_t *__restrict out, float scale, size_t outbytes), \
+		(in, chans, out, scale, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(ic16n_iq16, void, \
+		(const int16_t *const *__restrict in, unsigned chans, int16_t *__restrict out, size_t outbytes), \
+		(in, chans, out, outbytes), outbytes / 4, (AVX, SSE2)) \
+	X(sc32_conv64, void, \
+		(const float *__restrict data, const float *__restrict conv, float *__restrict out, unsigned count, unsigned decim_bits), \
+		(data, conv, out, count, decim_bits), count, (AVX_FMA, AVX, SSE2)) \
+	X(b8_expand_x2, void, \
+		(const void *__restrict data, void *__restrict out, unsigned count_blocks), \
+		(data, out, count_blocks), count_blocks, (GENERIC)) \
+	X(b8_expand_x4, void, \
+		(const void *__restrict data, void *__restrict out, unsigned count_blocks), \
+		(data, out, count_blocks), count_blocks, (GENERIC)) \
+	X(iq16_conv64, void, \
+		(const int16_t *__restrict data, const int16_t *__restrict conv, int16_t *__restrict out, unsigned count, unsigned decim_bits), \
+		(data, conv, out, count, decim_bits), count, (AVX, SSE2)) \
+	X(b4_expand_x2, void, \
+		(const void *__restrict data, void *__restrict out, unsigned count_blocks), \
+		(data, out, count_blocks), count_blocks, (GENERIC)) \
+	X(b4_expand_x4, void, \
+		(const void *__restrict data, void *__restrict out, unsigned count_blocks), \
+		(data, out, count_blocks), count_blocks, (GENERIC)) \
+	X(sc32_nco, uint32_t, \
+		(const float *__restrict in, float *__restrict out, unsigned count, uint32_t phase, uint32_t dphase), \
+		(in, out, count, phase, dphase), count, (AVX, SSE2)) \
+	X(ic16_nco, uint32_t, \
+		(const int16_t *__restrict in, int16_t *__restrict out, unsigned count, uint32_t phase, uint32_t dphase), \
+		(in, out, count, phase, dphase), count, (AVX, SSE2)) \
+	X(sc32_nco_iq16, uint32_t, \
+		(const float *__restrict in, int16_t *__restrict out, unsigned count, float scale, uint32_t phase, uint32_t dphase), \
+		(in, out, count, scale, phase, dphase), count, (AVX, SSE2))
+
+#define XTRXDSP_DISPATCH_DECLARE(name, ret, params, args, samples, isas) \
+	typedef ret (*func_xtrxdsp_##name##_t) params; \
+	func_xtrxdsp_##name##_t resolve_xtrxdsp_##name(void);
+
+/* func_xtrxdsp_<name>_t types, resolve_xtrxdsp_<name>() returns the kernel
+ * for this CPU within the xtrxdsp_set_isa() limit
+ */
+XTRXDSP_DISPATCH_KERNELS(XTRXDSP_DISPATCH_DECLARE)
+
+#define XTRXDSP_DISPATCH_MEMBER(name, ret, params, args, samples, isas) \
+	ret (*name) params;
+
+/* Dispatch table holding the resolved kernel of every dispatched function,
+ * members are named after the functions without xtrxdsp_ prefix
+ */
+typedef struct xtrxdsp_dispatch {
+	XTRXDSP_DISPATCH_KERNELS(XTRXDSP_DISPATCH_MEMBER)
+} xtrxdsp_dispatch_t;
+
+/**
+ * @brief xtrxdsp_get_dispatch Returns the dispatch table
+ *
+ * The table is filled once on the first call and is safe to fetch from any
+ * thread. Keep the pointer and call through it to skip per-call resolution.
+ * xtrxdsp_set_isa() publishes another table instead of modifying this one,
+ * fetch it again to pick up the change; a kept pointer stays valid and keeps
+ * its kernels for the process lifetime.
+ */
+const xtrxdsp_dispatch_t* xtrxdsp_get_dispatch(void);
+
+typedef void (*xtrxdsp_kernel_t)(void);
+
+/**
+ * @brief xtrxdsp_get_candidates Lists variants of a dispatched function usable
+ *        on this CPU within the xtrxdsp_set_isa() limit, best ISA first
+ * @param func Function name, i.e. "xtrxdsp_iq16_sc32"
+ * @param fn Kernels, cast them to the function type before calling
+ * @param variant Variant suffixes as reported by xtrxdsp_get_variant()
+ * @param max Size of fn and variant arrays
+ * @return Number of variants stored, -EINVAL on unknown function
+ */
+int xtrxdsp_get_candidates(const char* func,
+						   xtrxdsp_kernel_t* fn,
+						   const char** variant,
+						   unsigned max);
+
+/**
+ * @brief xtrxdsp_dispatch_bind Points a function of a caller owned table to
+ *        the given variant
+ * @param t Table, usually a copy of xtrxdsp_get_dispatch()
+ * @param func Function name, i.e. "xtrxdsp_iq16_sc32"
+ * @param variant Variant suffix, i.e. "sse2"
+ * @return 0 on success, -EINVAL on unknown function, -ENOENT if the variant
+ *         is not usable on this CPU
+ */
+int xtrxdsp_dispatch_bind(xtrxdsp_dispatch_t* t,
+						  const char* func,
+						  const char* variant);
+
+/*
+ * Kernel counters, available when the library is built with
+ * XTRXDSP_INSTRUMENT. Every call through an exported entry point (or through
+ * a filter, NCO or DUC) is accounted to the variant it was dispatched to.
+ * Entry points aren't bound via ifunc in such builds.
+ */
+typedef struct xtrxdsp_counter {
+	const char* func;      // Function name, i.e. "xtrxdsp_iq16_sc32"
+	const char* variant;   // Variant suffix the calls went to
+	uint64_t calls;
+	uint64_t samples;      // Samples, input ones for conv64, blocks for expanders
+	uint64_t cycles;       // TSC ticks on x86, nanoseconds elsewhere
+} xtrxdsp_counter_t;
+
+/**
+ * @brief xtrxdsp_counters_snapshot Copies non zero counters
+ * @param out Counters
+ * @param max Size of out array
+ * @return Number of counters stored, -ENOTSUP if the library is built
+ *         without XTRXDSP_INSTRUMENT
+ */
+int xtrxdsp_counters_snapshot(xtrxdsp_counter_t* out, unsigned max);
 
+/**
+ * @brief xtrxdsp_counters_reset Zeroes all counters
+ */
+void xtrxdsp_counters_reset(void);
 
-typedef DECLARE_IQ16_CONV64_BASE( (*func_xtrxdsp_iq16_conv64_t) );
-func_xtrxdsp_iq16_conv64_t resolve_xtrxdsp_iq16_conv64(void);
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x2(void);
-func_xtrxdsp_bx_expand_t resolve_xtrxdsp_b4_expand_x4(void);
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* _XTRXDSP_H_ */
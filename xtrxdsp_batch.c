@@ -0,0 +1,119 @@
+/*
+ * xtrxdsp batched conversion source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxdsp_batch.h"
+
+/*
+ * Returns number of descriptors starting from desc[0] that can be converted
+ * as a single run and its total input size. Output grows by outnum / outden
+ * bytes per input byte; chunks not holding whole complex samples of elem
+ * bytes end the run as the converter would handle the leftover as a tail.
+ */
+static unsigned batch_run(const xtrxdsp_batch_desc_t* desc,
+						  unsigned count,
+						  size_t elem,
+						  size_t outnum,
+						  size_t outden,
+						  size_t* inbytes)
+{
+	size_t total = desc[0].inbytes;
+	unsigned n;
+
+	for (n = 1; n < count; n++) {
+		if (total % elem)
+			break;
+		if ((const char*)desc[0].in + total != (const char*)desc[n].in)
+			break;
+		if ((char*)desc[0].out + total / outden * outnum != (char*)desc[n].out)
+			break;
+
+		total += desc[n].inbytes;
+	}
+
+	*inbytes = total;
+	return n;
+}
+
+void xtrxdsp_iq16_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+							 unsigned count,
+							 float scale)
+{
+	size_t bytes;
+	unsigned n;
+
+	for (; count > 0; count -= n, desc += n) {
+		n = batch_run(desc, count, 2 * sizeof(int16_t), sizeof(float), sizeof(int16_t), &bytes);
+		xtrxdsp_iq16_sc32((const int16_t*)desc->in, (float*)desc->out, scale, bytes);
+	}
+}
+
+void xtrxdsp_iq8_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+							unsigned count)
+{
+	size_t bytes;
+	unsigned n;
+
+	for (; count > 0; count -= n, desc += n) {
+		n = batch_run(desc, count, 2 * sizeof(int8_t), sizeof(float), sizeof(int8_t), &bytes);
+		xtrxdsp_iq8_sc32((const int8_t*)desc->in, (float*)desc->out, bytes);
+	}
+}
+
+void xtrxdsp_sc32_iq16_batch(const xtrxdsp_batch_desc_t* desc,
+							 unsigned count,
+							 float scale)
+{
+	size_t bytes;
+	unsigned n;
+
+	for (; count > 0; count -= n, desc += n) {
+		n = batch_run(desc, count, 2 * sizeof(float), sizeof(int16_t), sizeof(float), &bytes);
+		xtrxdsp_sc32_iq16((const float*)desc->in, (int16_t*)desc->out, scale, bytes / 2);
+	}
+}
+
+uint64_t xtrxdsp_iq12_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+								 unsigned count,
+								 uint64_t prevstate)
+{
+	unsigned n;
+
+	for (; count > 0; count -= n, desc += n) {
+		/* pending bytes of a split sample shift the output of every chunk */
+		size_t pending = prevstate & 0xf;
+		size_t total = desc[0].inbytes;
+		size_t outvals = 2 * ((pending + total) / 3);
+
+		for (n = 1; n < count; n++) {
+			if ((const char*)desc[0].in + total != (const char*)desc[n].in)
+				break;
+			if ((float*)desc[0].out + outvals != (float*)desc[n].out)
+				break;
+
+			total += desc[n].inbytes;
+			outvals = 2 * ((pending + total) / 3);
+		}
+
+		prevstate = xtrxdsp_iq12_sc32(desc->in, (float*)desc->out, total, prevstate);
+		if (prevstate == (uint64_t)-1)
+			break;
+	}
+	return prevstate;
+}
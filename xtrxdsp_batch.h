@@ -0,0 +1,89 @@
+/*
+ * Public xtrxdsp batched conversion header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_BATCH_H
+#define XTRXDSP_BATCH_H
+
+#include <xtrxdsp.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Batched conversions run a converter over a list of buffers in one call.
+ * Descriptors following each other both in input and in output memory (i.e.
+ * consecutive chunks of a DMA ring) are merged, so the converter sees one
+ * long run instead of paying for tails and iq12 carry on every chunk.
+ */
+typedef struct xtrxdsp_batch_desc {
+	const void* in;   // Input buffer
+	size_t inbytes;   // Input size in bytes
+	void* out;        // Output buffer, sized for inbytes of input
+} xtrxdsp_batch_desc_t;
+
+/**
+ * @brief xtrxdsp_iq16_sc32_batch Batched xtrxdsp_iq16_sc32()
+ * @param desc Array of descriptors
+ * @param count Number of descriptors
+ * @param scale Conversion scale
+ */
+void xtrxdsp_iq16_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+							 unsigned count,
+							 float scale);
+
+/**
+ * @brief xtrxdsp_iq12_sc32_batch Batched xtrxdsp_iq12_sc32(), state is
+ *        carried across descriptors. A sample split between two buffers is
+ *        written to the output of the descriptor where it ends, so out of
+ *        each descriptor gets 2 * ((pending + inbytes) / 3) values
+ * @param desc Array of descriptors
+ * @param count Number of descriptors
+ * @param prevstate State returned by the previous call, 0 initially
+ * @return state for the next call
+ */
+uint64_t xtrxdsp_iq12_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+								 unsigned count,
+								 uint64_t prevstate);
+
+/**
+ * @brief xtrxdsp_iq8_sc32_batch Batched xtrxdsp_iq8_sc32()
+ * @param desc Array of descriptors
+ * @param count Number of descriptors
+ */
+void xtrxdsp_iq8_sc32_batch(const xtrxdsp_batch_desc_t* desc,
+							unsigned count);
+
+/**
+ * @brief xtrxdsp_sc32_iq16_batch Batched xtrxdsp_sc32_iq16(), inbytes of
+ *        every descriptor are float bytes, out gets inbytes / 2 bytes
+ * @param desc Array of descriptors
+ * @param count Number of descriptors
+ * @param scale Conversion scale
+ */
+void xtrxdsp_sc32_iq16_batch(const xtrxdsp_batch_desc_t* desc,
+							 unsigned count,
+							 float scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,6 +10,7 @@
 //#define XTRXDSP_HAS__SSE4_2__
 #define XTRXDSP_HAS__AVX__
 #define XTRXDSP_HAS__FMA__
+#define XTRXDSP_HAS__F16C__
 //#define XTRXDSP_HAS__AVX2__
 
 #endif
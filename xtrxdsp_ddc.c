@@ -0,0 +1,82 @@
+/*
+ * xtrxdsp digital down converter source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxll_port.h"
+#include "xtrxdsp_ddc.h"
+#include <stdlib.h>
+#include <string.h>
+
+int xtrxdsp_ddc_init(const float* taps,
+					 unsigned count,
+					 unsigned decim,
+					 double freq,
+					 xtrxdsp_ddc_state_t *out)
+{
+	void* mem;
+	int res;
+
+	res = xtrxdsp_nco_init(-freq, &out->nco);
+	if (res)
+		return res;
+
+	res = xtrxdsp_filter_init(taps, count, decim, 0, XTRXDSP_DDC_CHUNK, &out->filter);
+	if (res)
+		return res;
+
+	if (posix_memalign(&mem, 64, XTRXDSP_DDC_CHUNK * sizeof(float)) != 0) {
+		xtrxdsp_filter_free(&out->filter);
+		return -ENOMEM;
+	}
+
+	out->chunk = (float*)mem;
+	return 0;
+}
+
+void xtrxdsp_ddc_free(xtrxdsp_ddc_state_t *out)
+{
+	xtrxdsp_filter_free(&out->filter);
+	free(out->chunk);
+	out->chunk = NULL;
+}
+
+int xtrxdsp_ddc_set_freq(xtrxdsp_ddc_state_t* state,
+						 double freq)
+{
+	return xtrxdsp_nco_set_freq(&state->nco, -freq);
+}
+
+unsigned xtrxdsp_ddc_work(xtrxdsp_ddc_state_t* state,
+						  const float *__restrict indata,
+						  float *__restrict outdata,
+						  unsigned num_insamples)
+{
+	unsigned n, sz, produced = 0;
+
+	for (n = 0; n < num_insamples; n += sz) {
+		sz = xtrxdsp_filter_chunk(&state->filter, num_insamples - n,
+								  XTRXDSP_DDC_CHUNK);
+
+		xtrxdsp_nco_work(&state->nco, indata + n, state->chunk, sz / 2);
+		produced += xtrxdsp_filter_work(&state->filter, state->chunk,
+										outdata + produced, sz);
+	}
+
+	return produced;
+}
@@ -0,0 +1,81 @@
+/*
+ * Public xtrxdsp digital down converter header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_DDC_H
+#define XTRXDSP_DDC_H
+
+#include <xtrxdsp_filters.h>
+#include <xtrxdsp_nco.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Mixed data is staged in blocks of this size (in floats), so it never
+ * leaves L1 before filter consumes it
+ */
+#define XTRXDSP_DDC_CHUNK 4096
+
+typedef struct xtrxdsp_ddc_state {
+	xtrxdsp_nco_state_t nco;
+	xtrxdsp_filter_state_t filter;
+	float* chunk;
+} xtrxdsp_ddc_state_t;
+
+/**
+ * @brief xtrxdsp_ddc_init Initializes DDC: channel at freq is shifted to
+ *                         DC, filtered and decimated
+ * @param taps Filter taps (doesn't have to be aligned to SMID vector size)
+ * @param count Number of filter taps
+ * @param decim Decimation rate at output (2^decim)
+ * @param freq Channel frequency normalized to input sample rate
+ * @param out Structure to initialize
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_ddc_init(const float* taps,
+					 unsigned count,
+					 unsigned decim,
+					 double freq,
+					 xtrxdsp_ddc_state_t *out);
+
+void xtrxdsp_ddc_free(xtrxdsp_ddc_state_t *out);
+
+/**
+ * @brief xtrxdsp_ddc_set_freq Retunes DDC keeping NCO phase and filter history
+ */
+int xtrxdsp_ddc_set_freq(xtrxdsp_ddc_state_t* state,
+						 double freq);
+
+/**
+ * @brief xtrxdsp_ddc_work Processes block of sc32 data
+ * @param num_insamples Number of input floats, multiple of 2^(decim+1) and
+ *                      not less than filter history (same as for
+ *                      xtrxdsp_filter_work)
+ * @return number of floats written to outdata
+ */
+unsigned xtrxdsp_ddc_work(xtrxdsp_ddc_state_t* state,
+						  const float *__restrict indata,
+						  float *__restrict outdata,
+						  unsigned num_insamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * xtrxdsp digital up converter source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxll_port.h"
+#include "xtrxdsp_duc.h"
+#include <stdlib.h>
+#include <string.h>
+
+int xtrxdsp_duc_init(const float* taps,
+					 unsigned count,
+					 unsigned inter,
+					 double freq,
+					 float scale,
+					 xtrxdsp_duc_state_t *out)
+{
+	void* mem;
+	int res;
+
+	/* interpolation isn't optional here, use NCO for pure frequency shift */
+	if (inter == 0)
+		return -EINVAL;
+
+	res = xtrxdsp_nco_init(freq, &out->nco);
+	if (res)
+		return res;
+
+	res = xtrxdsp_filter_init(taps, count, 0, inter,
+							  XTRXDSP_DUC_CHUNK >> inter, &out->filter);
+	if (res)
+		return res;
+
+	if (posix_memalign(&mem, 64, XTRXDSP_DUC_CHUNK * sizeof(float)) != 0) {
+		xtrxdsp_filter_free(&out->filter);
+		return -ENOMEM;
+	}
+
+	out->func = resolve_xtrxdsp_sc32_nco_iq16();
+	out->scale = scale;
+	out->chunk = (float*)mem;
+	return 0;
+}
+
+void xtrxdsp_duc_free(xtrxdsp_duc_state_t *out)
+{
+	xtrxdsp_filter_free(&out->filter);
+	free(out->chunk);
+	out->chunk = NULL;
+}
+
+int xtrxdsp_duc_set_freq(xtrxdsp_duc_state_t* state,
+						 double freq)
+{
+	return xtrxdsp_nco_set_freq(&state->nco, freq);
+}
+
+unsigned xtrxdsp_duc_work(xtrxdsp_duc_state_t* state,
+						  const float *__restrict indata,
+						  int16_t *__restrict outdata,
+						  unsigned num_insamples)
+{
+	const unsigned max_in = XTRXDSP_DUC_CHUNK >> state->filter.inter;
+	unsigned n, sz, cnt, produced = 0;
+
+	for (n = 0; n < num_insamples; n += sz) {
+		sz = xtrxdsp_filter_chunk(&state->filter, num_insamples - n, max_in);
+
+		cnt = xtrxdsp_filter_work(&state->filter, indata + n, state->chunk, sz);
+
+		state->nco.phase = state->func(state->chunk, outdata + produced, cnt / 2,
+									   state->scale, state->nco.phase,
+									   state->nco.dphase);
+		produced += cnt;
+	}
+
+	return produced;
+}
@@ -0,0 +1,85 @@
+/*
+ * Public xtrxdsp digital up converter header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_DUC_H
+#define XTRXDSP_DUC_H
+
+#include <xtrxdsp_filters.h>
+#include <xtrxdsp_nco.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Interpolated data is staged in blocks of this size (in floats at the
+ * output rate), so it never leaves L1 before it's mixed and quantized
+ */
+#define XTRXDSP_DUC_CHUNK 4096
+
+typedef struct xtrxdsp_duc_state {
+	xtrxdsp_nco_state_t nco;
+	xtrxdsp_filter_state_t filter;
+	func_xtrxdsp_sc32_nco_iq16_t func;
+	float scale;
+	float* chunk;
+} xtrxdsp_duc_state_t;
+
+/**
+ * @brief xtrxdsp_duc_init Initializes DUC: baseband is interpolated, shifted
+ *                         to freq and quantized to iq16 wire format
+ * @param taps Filter taps (doesn't have to be aligned to SMID vector size)
+ * @param count Number of filter taps
+ * @param inter Interpolation rate (2^inter)
+ * @param freq Channel frequency normalized to output sample rate
+ * @param scale Output scale, i.e. 32767 maps 1.0 to full scale
+ * @param out Structure to initialize
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_duc_init(const float* taps,
+					 unsigned count,
+					 unsigned inter,
+					 double freq,
+					 float scale,
+					 xtrxdsp_duc_state_t *out);
+
+void xtrxdsp_duc_free(xtrxdsp_duc_state_t *out);
+
+/**
+ * @brief xtrxdsp_duc_set_freq Retunes DUC keeping NCO phase and filter history
+ */
+int xtrxdsp_duc_set_freq(xtrxdsp_duc_state_t* state,
+						 double freq);
+
+/**
+ * @brief xtrxdsp_duc_work Processes block of sc32 baseband data, output is
+ *                         saturated to int16
+ * @param num_insamples Number of input floats, not less than filter history
+ *                      (same as for xtrxdsp_filter_work)
+ * @return number of int16 values written to outdata
+ */
+unsigned xtrxdsp_duc_work(xtrxdsp_duc_state_t* state,
+						  const float *__restrict indata,
+						  int16_t *__restrict outdata,
+						  unsigned num_insamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
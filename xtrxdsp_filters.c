@@ -211,6 +211,63 @@ unsigned xtrxdsp_filter_worki(xtrxdsp_filter_state_t* state,
 	}
 }
 
+unsigned xtrxdsp_filter_chunk(const xtrxdsp_filter_state_t* state,
+							  unsigned remaining,
+							  unsigned max_chunk)
+{
+	/* whole output samples, decimation consumes 2^decim inputs per output */
+	const unsigned step_mask = (2u << state->decim) - 1;
+
+	if (remaining <= max_chunk)
+		return remaining;
+	if (remaining >= 2 * max_chunk)
+		return max_chunk;
+	return (remaining / 2) & ~step_mask;
+}
+
+unsigned xtrxdsp_filter_work_iq16(xtrxdsp_filter_state_t* state,
+								  const int16_t *__restrict indata,
+								  float *__restrict outdata,
+								  float scale,
+								  unsigned num_insamples)
+{
+	float chunk[XTRXDSP_FILTER_RAW_CHUNK] __attribute__((aligned(64)));
+	unsigned n, sz, produced = 0;
+
+	assert(state->inter == 0);
+	for (n = 0; n < num_insamples; n += sz) {
+		sz = xtrxdsp_filter_chunk(state, num_insamples - n, XTRXDSP_FILTER_RAW_CHUNK);
+
+		xtrxdsp_iq16_sc32(indata + n, chunk, scale, sz * sizeof(int16_t));
+		produced += xtrxdsp_filter_work(state, chunk, outdata + produced, sz);
+	}
+
+	return produced;
+}
+
+unsigned xtrxdsp_filter_work_iq12(xtrxdsp_filter_state_t* state,
+								  const void *__restrict indata,
+								  float *__restrict outdata,
+								  size_t inbytes)
+{
+	float chunk[XTRXDSP_FILTER_RAW_CHUNK] __attribute__((aligned(64)));
+	const uint8_t* in = (const uint8_t*)indata;
+	unsigned num_insamples = inbytes / 3 * 2;
+	unsigned n, sz, produced = 0;
+
+	assert(state->inter == 0);
+	assert(inbytes % 3 == 0);
+	for (n = 0; n < num_insamples; n += sz) {
+		sz = xtrxdsp_filter_chunk(state, num_insamples - n, XTRXDSP_FILTER_RAW_CHUNK);
+
+		/* chunks are even, so there's no partial sample to carry */
+		xtrxdsp_iq12_sc32(in + n / 2 * 3, chunk, sz / 2 * 3, 0);
+		produced += xtrxdsp_filter_work(state, chunk, outdata + produced, sz);
+	}
+
+	return produced;
+}
+
 int xtrxdsp_filter_init(const float* taps,
 						unsigned count,
 						unsigned decim,
@@ -17,10 +17,16 @@
  * License along with this library; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
+#ifndef XTRXDSP_FILTERS_H
+#define XTRXDSP_FILTERS_H
 
 #include <stdint.h>
 #include <xtrxdsp.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define FILTER_TAPS_120 120
 #define FILTER_TAPS_40  40
 
@@ -116,3 +122,58 @@ unsigned xtrxdsp_filter_worki(xtrxdsp_filter_state_t* state,
 							  const int16_t *__restrict indata,
 							  int16_t *__restrict outdata,
 							  unsigned num_insamples);
+
+/**
+ * @brief xtrxdsp_filter_chunk Size of the next piece when a long block is fed
+ *                             to xtrxdsp_filter_work() in pieces of at most
+ *                             max_chunk floats. A tail shorter than two pieces
+ *                             is split into two halves, so no piece ends up
+ *                             shorter than the filter history.
+ * @param state Filter state
+ * @param remaining Number of floats left in the block
+ * @param max_chunk Maximum piece size in floats
+ * @return number of floats to process next
+ */
+unsigned xtrxdsp_filter_chunk(const xtrxdsp_filter_state_t* state,
+							  unsigned remaining,
+							  unsigned max_chunk);
+
+/* Raw wire data is converted in blocks of this size (in floats) right before
+ * the convolution, so full rate sc32 data never hits the memory
+ */
+#define XTRXDSP_FILTER_RAW_CHUNK 2048
+
+/**
+ * @brief xtrxdsp_filter_work_iq16 Filters iq16 wire data, equivalent to
+ *                                 xtrxdsp_iq16_sc32() followed by
+ *                                 xtrxdsp_filter_work()
+ * @param state Float filter state, interpolation isn't supported
+ * @param scale Conversion scale, as in xtrxdsp_iq16_sc32()
+ * @param num_insamples Number of int16 values
+ * @return number of floats written to outdata
+ */
+unsigned xtrxdsp_filter_work_iq16(xtrxdsp_filter_state_t* state,
+								  const int16_t *__restrict indata,
+								  float *__restrict outdata,
+								  float scale,
+								  unsigned num_insamples);
+
+/**
+ * @brief xtrxdsp_filter_work_iq12 Filters packed iq12 wire data, equivalent to
+ *                                 xtrxdsp_iq12_sc32() followed by
+ *                                 xtrxdsp_filter_work()
+ * @param state Float filter state, interpolation isn't supported
+ * @param inbytes Number of input bytes, should contain whole samples only,
+ *                i.e. be multiple of 3
+ * @return number of floats written to outdata
+ */
+unsigned xtrxdsp_filter_work_iq12(xtrxdsp_filter_state_t* state,
+								  const void *__restrict indata,
+								  float *__restrict outdata,
+								  size_t inbytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
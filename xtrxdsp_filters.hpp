@@ -0,0 +1,250 @@
+/*
+ * xtrxdsp filters C++ interface
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_FILTERS_HPP
+#define XTRXDSP_FILTERS_HPP
+
+#if __cplusplus < 201703L
+#error "xtrxdsp_filters.hpp requires C++17"
+#endif
+
+#include <xtrxdsp_filters.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+/* tap loops only pay off vectorized and unrolled, -O2 doesn't do both */
+#if defined(__GNUC__) && !defined(__clang__)
+#define XTRXDSP_FIR_OPTIMIZE __attribute__((optimize("tree-vectorize", "unroll-loops")))
+#else
+#define XTRXDSP_FIR_OPTIMIZE
+#endif
+
+namespace xtrxdsp {
+
+/* Sample types the filters are implemented for, I/Q interleaved */
+template <typename T>
+inline constexpr bool is_filter_sample_v =
+		std::is_same_v<T, float> || std::is_same_v<T, int16_t>;
+
+/**
+ * Owning handle of xtrxdsp_filter_state_t, runtime configured filter with
+ * the same semantics as xtrxdsp_filter_init() / xtrxdsp_filter_work().
+ *
+ * Move only, the state is released in the destructor. Initialization errors
+ * are thrown as std::system_error carrying the errno.
+ */
+template <typename T>
+class filter_state {
+	static_assert(is_filter_sample_v<T>, "float and int16_t samples only");
+
+public:
+	filter_state(const T* taps,
+				 unsigned count,
+				 unsigned decim,
+				 unsigned inter,
+				 unsigned max_sps_block)
+	{
+		int res;
+		if constexpr (std::is_same_v<T, float>) {
+			res = xtrxdsp_filter_init(taps, count, decim, inter, max_sps_block, &m_state);
+		} else {
+			res = xtrxdsp_filter_initi(taps, count, decim, inter, max_sps_block, &m_state);
+		}
+		if (res < 0)
+			throw std::system_error(-res, std::generic_category(), "xtrxdsp_filter_init");
+	}
+
+	filter_state(const filter_state&) = delete;
+	filter_state& operator=(const filter_state&) = delete;
+
+	filter_state(filter_state&& other) noexcept
+		: m_state(other.m_state)
+	{
+		other.m_state = xtrxdsp_filter_state_t{};
+	}
+
+	filter_state& operator=(filter_state&& other) noexcept
+	{
+		if (this != &other) {
+			release();
+			m_state = other.m_state;
+			other.m_state = xtrxdsp_filter_state_t{};
+		}
+		return *this;
+	}
+
+	~filter_state() { release(); }
+
+	/* false for a moved from object */
+	explicit operator bool() const noexcept { return m_state.filter_taps != nullptr; }
+
+	xtrxdsp_filter_state_t* get() noexcept { return &m_state; }
+	const xtrxdsp_filter_state_t* get() const noexcept { return &m_state; }
+
+	/* returns number of T values written to out */
+	unsigned work(const T* __restrict in, T* __restrict out, unsigned num_insamples) noexcept
+	{
+		if constexpr (std::is_same_v<T, float>) {
+			return xtrxdsp_filter_work(&m_state, in, out, num_insamples);
+		} else {
+			return xtrxdsp_filter_worki(&m_state, in, out, num_insamples);
+		}
+	}
+
+	/* wire format input, float filters without interpolation only */
+	template <typename U = T, typename = std::enable_if_t<std::is_same_v<U, float>>>
+	unsigned work_iq16(const int16_t* __restrict in, float* __restrict out,
+					   float scale, unsigned num_insamples) noexcept
+	{
+		return xtrxdsp_filter_work_iq16(&m_state, in, out, scale, num_insamples);
+	}
+
+	template <typename U = T, typename = std::enable_if_t<std::is_same_v<U, float>>>
+	unsigned work_iq12(const void* __restrict in, float* __restrict out,
+					   size_t inbytes) noexcept
+	{
+		return xtrxdsp_filter_work_iq12(&m_state, in, out, inbytes);
+	}
+
+private:
+	void release() noexcept
+	{
+		if (m_state.filter_taps)
+			xtrxdsp_filter_free(&m_state);
+	}
+
+	xtrxdsp_filter_state_t m_state{};
+};
+
+/**
+ * Decimating FIR filter with tap count and decimation fixed at compile time,
+ * so tap loops and strides are constants and the compiler unrolls and
+ * vectorizes them for the target it's built for.
+ *
+ * This is a separate implementation, not a wrapper over the C filter, and
+ * its output timing differs from xtrxdsp_filter_work(). Conventions follow
+ * the C filter: I/Q interleaved data, counts in T values, real taps applied
+ * oldest sample first, int16_t accumulates in 64 bits and returns bits
+ * 16..31. Q15 samples with Q15 taps accumulate as Q30, so the output is Q14
+ * at half amplitude, same as iq16_conv64.
+ * The delay line holds exactly Taps samples, where the C filter always keeps
+ * 64, so a C filter with fewer than 64 taps lags by (64 - Taps) / Decim
+ * outputs.
+ *
+ *   xtrxdsp::fir<float, 32, 2> f(taps);
+ *   unsigned produced = f.work(in, out, 2 * samples);
+ */
+template <typename T, unsigned Taps, unsigned Decim = 1>
+class fir {
+	static_assert(is_filter_sample_v<T>, "float and int16_t samples only");
+	static_assert(Taps > 0, "at least one tap is required");
+	static_assert(Decim > 0 && (Decim & (Decim - 1)) == 0, "decimation must be a power of two");
+	static_assert(Taps % Decim == 0, "pad taps with zeros to a multiple of decimation");
+
+public:
+	using sample_type = T;
+	using acc_type = std::conditional_t<std::is_same_v<T, float>, float, int64_t>;
+
+	static constexpr unsigned taps = Taps;
+	static constexpr unsigned decim = Decim;
+	/* delay line length and input step between outputs, in T values */
+	static constexpr unsigned history = 2 * Taps;
+	static constexpr unsigned step = 2 * Decim;
+
+	explicit fir(const T* taps_data) noexcept
+	{
+		for (unsigned i = 0; i < Taps; i++) {
+			m_taps[2 * i + 0] = taps_data[i];
+			m_taps[2 * i + 1] = taps_data[i];
+		}
+		reset();
+	}
+
+	/* pushes zeros as history, same as a newly created filter */
+	void reset() noexcept { std::memset(m_buf, 0, sizeof(m_buf)); }
+
+	/**
+	 * num_insamples must be at least history and a multiple of step,
+	 * returns num_insamples / Decim values written to out
+	 */
+	unsigned work(const T* __restrict in, T* __restrict out, unsigned num_insamples) noexcept
+	{
+		assert(num_insamples >= history);
+		assert(num_insamples % step == 0);
+
+		/* outputs overlapping the previous call go through the delay line */
+		std::memcpy(m_buf + history, in, history * sizeof(T));
+		conv(m_buf, out, history / step);
+		conv(in, out + history / Decim, (num_insamples - history) / step);
+
+		std::memcpy(m_buf, in + num_insamples - history, history * sizeof(T));
+		return num_insamples / Decim;
+	}
+
+private:
+	/* independent partial sums per output, even so lanes keep I/Q parity;
+	 * they vectorize without reordering a single dependent sum
+	 */
+	static constexpr unsigned lanes = std::is_same_v<T, float> ? 16 : 8;
+	static constexpr unsigned body = history / lanes * lanes;
+
+	XTRXDSP_FIR_OPTIMIZE
+	void conv(const T* __restrict data, T* __restrict out, unsigned nout) const noexcept
+	{
+		for (unsigned k = 0; k < nout; k++, data += step) {
+			acc_type acc[lanes] = {};
+
+			for (unsigned m = 0; m < body; m += lanes) {
+				for (unsigned l = 0; l < lanes; l++) {
+					acc[l] += static_cast<acc_type>(data[m + l]) * m_taps[m + l];
+				}
+			}
+			for (unsigned m = body; m < history; m++) {
+				acc[m & 1] += static_cast<acc_type>(data[m]) * m_taps[m];
+			}
+
+			acc_type acc_i = 0;
+			acc_type acc_q = 0;
+			for (unsigned l = 0; l < lanes; l += 2) {
+				acc_i += acc[l];
+				acc_q += acc[l + 1];
+			}
+
+			if constexpr (std::is_same_v<T, float>) {
+				out[2 * k + 0] = acc_i;
+				out[2 * k + 1] = acc_q;
+			} else {
+				out[2 * k + 0] = static_cast<int16_t>(acc_i >> 16);
+				out[2 * k + 1] = static_cast<int16_t>(acc_q >> 16);
+			}
+		}
+	}
+
+	/* every tap twice, for I and Q */
+	alignas(64) T m_taps[history];
+	alignas(64) T m_buf[2 * history];
+};
+
+} // namespace xtrxdsp
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * xtrxdsp header-only converters
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_INLINE_H
+#define XTRXDSP_INLINE_H
+
+/* Header-only variant of the kernels for applications built for a fixed ISA.
+ *
+ * The kernel set is picked at compile time from the target flags of the
+ * including unit (-mavx, -mf16c, -msse2 ...), the same way the library builds
+ * its xtrxdsp_x86_*.c variants, and every kernel is emitted as
+ * static inline xtrxdsp_<func>_inline() with the exported function signature,
+ * e.g. xtrxdsp_iq16_sc32_inline(iq, out, scale, bytes).
+ *
+ * No runtime CPU detection is done, the binary runs only on CPUs supporting
+ * everything it was compiled for. Link to the library for anything else.
+ */
+#include "xtrxdsp.h"
+
+#if defined(__AVX__)
+
+#ifdef __F16C__
+#define XTRXDSP_INLINE_ISA "avx_f16c"
+#define XTRXDSP_TEMPLATE_F16C
+#else
+#define XTRXDSP_INLINE_ISA "avx"
+#endif
+#define UNALIGN_STORE
+#include "xtrxdsp_isa_avx.h"
+
+#elif defined(__SSE2__)
+
+#define XTRXDSP_INLINE_ISA "sse2"
+#define UNALIGN_STORE
+#include "xtrxdsp_isa_sse2.h"
+
+#else
+
+#define XTRXDSP_INLINE_ISA "generic"
+#include "xtrxdsp_isa_no.h"
+
+#endif
+
+/* there are no vectorized expanders, generic ones for every ISA */
+#define XTRXDSP_TEMPLATE_B8_EXPAND_X2
+#define XTRXDSP_TEMPLATE_B8_EXPAND_X4
+#define XTRXDSP_TEMPLATE_B4_EXPAND_X2
+#define XTRXDSP_TEMPLATE_B4_EXPAND_X4
+
+#define XTRXDSP_TEMPLATE_SC32_CONV64_NAME     _inline
+#define XTRXDSP_TEMPLATE_IQ16_CONV64_NAME     _inline
+#define XTRXDSP_TEMPLATE_B8_EXPAND_X2_NAME    _inline
+#define XTRXDSP_TEMPLATE_B8_EXPAND_X4_NAME    _inline
+#define XTRXDSP_TEMPLATE_B4_EXPAND_X2_NAME    _inline
+#define XTRXDSP_TEMPLATE_B4_EXPAND_X4_NAME    _inline
+#define XTRXDSP_TEMPLATE_SC32_NCO_NAME        _inline
+#define XTRXDSP_TEMPLATE_IC16_NCO_NAME        _inline
+#define XTRXDSP_TEMPLATE_SC32_NCO_IQ16_NAME   _inline
+
+#define XTRXDSP_TEMPLATE_LINKAGE static inline
+
+#include "xtrxdsp_templates.c"
+
+DECLARE_TEMPLATES(inline)
+
+/* don't leak the template helpers into the application */
+#undef SCALE16
+#undef SCALE8
+#undef SCALE2
+#undef UNALIGN_IQ_BUFFER
+#undef UNALIGN_STORE
+#undef XTRXDSP_TEMPLATE_F16C
+#undef IS_ALIGNED
+#undef _MM_STOREX_PS
+#undef _MM256_STOREX_PS
+#undef _MM_LOADX_SI128
+#undef likely
+#undef unlikely
+#undef FA
+#undef NCO_CHUNK
+#undef NCO_PHASE2RAD
+#undef METER_FS16
+#undef METER_FS12
+#undef METER_FS8
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * xtrxdsp IQ correction source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxdsp_iqcorr.h"
+#include <math.h>
+#include <string.h>
+
+void xtrxdsp_iqcorr_init(xtrxdsp_iqcorr_t* corr,
+						 float scale)
+{
+	corr->m_ii = scale;
+	corr->m_iq = 0;
+	corr->m_qi = 0;
+	corr->m_qq = scale;
+	corr->dc_i = 0;
+	corr->dc_q = 0;
+	corr->flags = 0;
+	corr->gain_i = 1;
+	corr->gain_q = 1;
+}
+
+int xtrxdsp_iqcorr_set(xtrxdsp_iqcorr_t* corr,
+					   float scale,
+					   float gain,
+					   float phase,
+					   float dc_i,
+					   float dc_q)
+{
+	double c = cos(phase);
+	if (!(c > 0.1) || !(gain > 0))
+		return -EINVAL;
+
+	corr->m_ii = scale;
+	corr->m_iq = 0;
+	corr->m_qi = -scale * gain * sin(phase) / c;
+	corr->m_qq = scale * gain / c;
+	corr->dc_i = dc_i;
+	corr->dc_q = dc_q;
+	corr->flags = 0;
+	corr->gain_i = 1;
+	corr->gain_q = 1;
+	return 0;
+}
+
+/* every fixup is a row operation on the correction matrix and DC */
+static void iqcorr_swap(xtrxdsp_iqcorr_t* corr)
+{
+	float t;
+	t = corr->m_ii; corr->m_ii = corr->m_qi; corr->m_qi = t;
+	t = corr->m_iq; corr->m_iq = corr->m_qq; corr->m_qq = t;
+	t = corr->dc_i; corr->dc_i = corr->dc_q; corr->dc_q = t;
+}
+
+static void iqcorr_scale(xtrxdsp_iqcorr_t* corr, double gi, double gq)
+{
+	corr->m_ii *= gi;
+	corr->m_iq *= gi;
+	corr->dc_i *= gi;
+	corr->m_qi *= gq;
+	corr->m_qq *= gq;
+	corr->dc_q *= gq;
+}
+
+static double iqcorr_gain_i(const xtrxdsp_iqcorr_t* corr)
+{
+	return (corr->flags & XTRXDSP_IQCORR_NEG_I) ? -corr->gain_i : corr->gain_i;
+}
+
+static double iqcorr_gain_q(const xtrxdsp_iqcorr_t* corr)
+{
+	return (corr->flags & XTRXDSP_IQCORR_NEG_Q) ? -corr->gain_q : corr->gain_q;
+}
+
+/* takes fixups off, leaving the plain correction */
+static void iqcorr_strip_flags(xtrxdsp_iqcorr_t* corr)
+{
+	iqcorr_scale(corr, 1 / iqcorr_gain_i(corr), 1 / iqcorr_gain_q(corr));
+	if (corr->flags & XTRXDSP_IQCORR_SWAP_IQ)
+		iqcorr_swap(corr);
+
+	corr->flags = 0;
+	corr->gain_i = 1;
+	corr->gain_q = 1;
+}
+
+int xtrxdsp_iqcorr_apply_flags(xtrxdsp_iqcorr_t* corr,
+							   unsigned flags,
+							   float gain_i,
+							   float gain_q)
+{
+	if (!(gain_i != 0) || !(gain_q != 0))
+		return -EINVAL;
+
+	iqcorr_strip_flags(corr);
+	corr->flags = flags;
+	corr->gain_i = gain_i;
+	corr->gain_q = gain_q;
+
+	if (flags & XTRXDSP_IQCORR_SWAP_IQ)
+		iqcorr_swap(corr);
+	iqcorr_scale(corr, iqcorr_gain_i(corr), iqcorr_gain_q(corr));
+	return 0;
+}
+
+static void est_reset(xtrxdsp_iqcorr_est_t* est)
+{
+	memset(&est->stat, 0, sizeof(est->stat));
+}
+
+int xtrxdsp_iqcorr_est_init(xtrxdsp_iqcorr_est_t* est,
+							double mu)
+{
+	if (!(mu > 0 && mu <= 1))
+		return -EINVAL;
+
+	est_reset(est);
+	est->mu = mu;
+	return 0;
+}
+
+void xtrxdsp_iqcorr_est_update(xtrxdsp_iqcorr_est_t* est,
+							   const float* iq,
+							   unsigned count)
+{
+	double si = 0, sq = 0, sii = 0, sqq = 0, siq = 0;
+	for (unsigned n = 0; n < count; n++) {
+		double i = iq[2*n];
+		double q = iq[2*n + 1];
+		si += i;
+		sq += q;
+		sii += i * i;
+		sqq += q * q;
+		siq += i * q;
+	}
+
+	est->stat.sum_i += si;
+	est->stat.sum_q += sq;
+	est->stat.sum_ii += sii;
+	est->stat.sum_qq += sqq;
+	est->stat.sum_iq += siq;
+	est->stat.count += count;
+}
+
+void xtrxdsp_iqcorr_est_updatei(xtrxdsp_iqcorr_est_t* est,
+								const float* i,
+								const float* q,
+								unsigned count)
+{
+	double si = 0, sq = 0, sii = 0, sqq = 0, siq = 0;
+	for (unsigned n = 0; n < count; n++) {
+		si += i[n];
+		sq += q[n];
+		sii += (double)i[n] * i[n];
+		sqq += (double)q[n] * q[n];
+		siq += (double)i[n] * q[n];
+	}
+
+	est->stat.sum_i += si;
+	est->stat.sum_q += sq;
+	est->stat.sum_ii += sii;
+	est->stat.sum_qq += sqq;
+	est->stat.sum_iq += siq;
+	est->stat.count += count;
+}
+
+int xtrxdsp_iqcorr_est_apply(xtrxdsp_iqcorr_est_t* est,
+							 xtrxdsp_iqcorr_t* corr)
+{
+	if (est->stat.count < XTRXDSP_IQCORR_MIN_SAMPLES)
+		return -EAGAIN;
+
+	const double n = est->stat.count;
+	const double mu = est->mu;
+	const double fi = iqcorr_gain_i(corr);
+	const double fq = iqcorr_gain_q(corr);
+	const int swap = (corr->flags & XTRXDSP_IQCORR_SWAP_IQ) != 0;
+	xtrxdsp_iqcorr_t c = *corr;
+	double mi, mq, pii, pqq, piq, t;
+
+	/* take output fixups off the statistics and the correction, so the
+	 * residual is estimated on plain corrected data
+	 */
+	mi = est->stat.sum_i / n / fi;
+	mq = est->stat.sum_q / n / fq;
+	pii = est->stat.sum_ii / n / (fi * fi) - mi * mi;
+	pqq = est->stat.sum_qq / n / (fq * fq) - mq * mq;
+	piq = est->stat.sum_iq / n / (fi * fq) - mi * mq;
+
+	iqcorr_strip_flags(&c);
+	if (swap) {
+		t = mi; mi = mq; mq = t;
+		t = pii; pii = pqq; pqq = t;
+	}
+
+	est_reset(est);
+
+	/*
+	 * Residual whitening: the corrected signal should have uncorrelated
+	 * I and Q of equal power, i.e. with
+	 *   a = <IQ> / <II>,  g = sqrt(<II> / (<QQ> - a<IQ>))
+	 * the matrix R = [[1, 0], [-a*g, g]] fixes the residual, then only
+	 * mu part of it is applied to smooth out the estimation noise
+	 */
+	if (!(pii > 0))
+		return -EAGAIN;
+
+	const double a = piq / pii;
+	const double d = pqq - a * piq;
+	if (!(d > 0))
+		return -EAGAIN;
+
+	const double g = sqrt(pii / d);
+	const double r10 = -mu * a * g;
+	const double r11 = 1 + mu * (g - 1);
+
+	/* x' = R_mu * (M * x + o - mu * m) */
+	const double oi = c.dc_i - mu * mi;
+	const double oq = c.dc_q - mu * mq;
+
+	c.m_qi = r10 * c.m_ii + r11 * c.m_qi;
+	c.m_qq = r10 * c.m_iq + r11 * c.m_qq;
+	c.dc_i = oi;
+	c.dc_q = r10 * oi + r11 * oq;
+
+	xtrxdsp_iqcorr_apply_flags(&c, corr->flags, corr->gain_i, corr->gain_q);
+	*corr = c;
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Public xtrxdsp IQ correction header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_IQCORR_H
+#define XTRXDSP_IQCORR_H
+
+#include <xtrxdsp.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Minimum number of complex samples needed for a meaningful estimation */
+#define XTRXDSP_IQCORR_MIN_SAMPLES 64
+
+/**
+ * @brief xtrxdsp_iqcorr_init Sets identity correction without fixups
+ * @param corr Correction to initialize
+ * @param scale Conversion scale, i.e. 1.0f/32768 for iq16 and iq12 to get
+ *              the same result as xtrxdsp_iq16_sc32(..., 1.0f/32768, ...)
+ */
+void xtrxdsp_iqcorr_init(xtrxdsp_iqcorr_t* corr,
+						 float scale);
+
+/**
+ * @brief xtrxdsp_iqcorr_set Sets static correction without fixups
+ *        I' = scale * I + dc_i
+ *        Q' = scale * gain * (Q - sin(phase) * I) / cos(phase) + dc_q
+ * @param corr Correction to fill
+ * @param scale Conversion scale
+ * @param gain Q/I gain correction
+ * @param phase Phase correction in radians
+ * @param dc_i DC offset of I to add, in output units
+ * @param dc_q DC offset of Q to add, in output units
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_iqcorr_set(xtrxdsp_iqcorr_t* corr,
+					   float scale,
+					   float gain,
+					   float phase,
+					   float dc_i,
+					   float dc_q);
+
+/**
+ * @brief xtrxdsp_iqcorr_apply_flags Sets output fixups, replacing the ones
+ *        set before. They're folded into correction, so *_corr converters
+ *        do them in the same pass, and kept in corr for
+ *        xtrxdsp_iqcorr_est_apply() and the xtrxdsp_*_fixup() passes
+ * @param corr Correction to update, i.e. from xtrxdsp_iqcorr_init()
+ * @param flags Combination of XTRXDSP_IQCORR_* flags
+ * @param gain_i Gain of the output I
+ * @param gain_q Gain of the output Q
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_iqcorr_apply_flags(xtrxdsp_iqcorr_t* corr,
+							   unsigned flags,
+							   float gain_i,
+							   float gain_q);
+
+typedef struct xtrxdsp_iqcorr_est {
+	xtrxdsp_iqcorr_stat_t stat; // Running sums of corrected output
+	double mu;      // Fraction of the estimated residual applied per update
+} xtrxdsp_iqcorr_est_t;
+
+/**
+ * @brief xtrxdsp_iqcorr_est_init Initializes streaming DC / IQ imbalance
+ *                                estimator
+ * @param est Estimator to initialize
+ * @param mu Loop gain (0, 1], 1 applies the whole residual at once
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_iqcorr_est_init(xtrxdsp_iqcorr_est_t* est,
+							double mu);
+
+/**
+ * @brief xtrxdsp_iqcorr_est_update Accumulates statistics of corrected data,
+ *        a separate pass over the output. Passing &est->stat to the *_corr
+ *        converter accumulates the same sums during conversion instead
+ * @param est Estimator
+ * @param iq Interleaved I/Q output of a *_corr converter
+ * @param count Number of complex samples
+ */
+void xtrxdsp_iqcorr_est_update(xtrxdsp_iqcorr_est_t* est,
+							   const float* iq,
+							   unsigned count);
+
+/**
+ * @brief xtrxdsp_iqcorr_est_updatei Accumulates statistics of corrected data,
+ *        deinterleaved version of xtrxdsp_iqcorr_est_update()
+ * @param est Estimator
+ * @param i I output of xtrxdsp_iq16_sc32i_corr()
+ * @param q Q output of xtrxdsp_iq16_sc32i_corr()
+ * @param count Number of complex samples
+ */
+void xtrxdsp_iqcorr_est_updatei(xtrxdsp_iqcorr_est_t* est,
+								const float* i,
+								const float* q,
+								unsigned count);
+
+/**
+ * @brief xtrxdsp_iqcorr_est_apply Folds residual DC offset and IQ imbalance
+ *                                 seen since the last call into correction
+ *                                 and restarts accumulation. Output fixups
+ *                                 of corr are kept
+ * @param est Estimator
+ * @param corr Correction used to produce data passed to the estimator
+ * @return 0 - success, -EAGAIN not enough data or no signal, correction is
+ *         left untouched in this case
+ */
+int xtrxdsp_iqcorr_est_apply(xtrxdsp_iqcorr_est_t* est,
+							 xtrxdsp_iqcorr_t* corr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
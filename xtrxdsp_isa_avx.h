@@ -0,0 +1,106 @@
+/*
+ * xtrxdsp AVX kernel set header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_ISA_AVX_H
+#define XTRXDSP_ISA_AVX_H
+
+/* Templates making up the AVX kernel set, shared by the library variant
+ * and xtrxdsp_inline.h; the includer names the conv64 and NCO kernels
+ */
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32
+#define XTRXDSP_TEMPLATE_IQ8_SC32
+#define XTRXDSP_TEMPLATE_IQ8_IC16
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32I_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32I
+#define XTRXDSP_TEMPLATE_IQ8_SC32I
+
+#define XTRXDSP_TEMPLATE_SC32_IQ16
+#define XTRXDSP_TEMPLATE_SC32I_IQ16_AVX
+
+#define XTRXDSP_TEMPLATE_IC16I_IQ16
+#define XTRXDSP_TEMPLATE_IQ16_IC16I
+
+#define XTRXDSP_TEMPLATE_IQ8_IC16I
+#define XTRXDSP_TEMPLATE_IQ8_IC8I
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32_CORR_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32_CORR
+#define XTRXDSP_TEMPLATE_IQ16_SC32I_CORR_SSE2
+#define XTRXDSP_TEMPLATE_SC32_FIXUP_SSE2
+#define XTRXDSP_TEMPLATE_IC16_FIXUP_SSE2
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32_METER_SSE2
+#define XTRXDSP_TEMPLATE_IQ16_SC32I_METER_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32_METER
+#define XTRXDSP_TEMPLATE_IQ8_SC32_METER
+#define XTRXDSP_TEMPLATE_IQ8_IC16_METER
+#define XTRXDSP_TEMPLATE_IQ16_IC16I_METER
+#define XTRXDSP_TEMPLATE_IQ12_SC32I_METER
+#define XTRXDSP_TEMPLATE_IQ8_SC32I_METER
+#define XTRXDSP_TEMPLATE_IQ8_IC16I_METER
+
+/* F16C converters are a library variant of their own, a unit built with
+ * -mf16c defines XTRXDSP_TEMPLATE_F16C to take them in
+ */
+#ifdef XTRXDSP_TEMPLATE_F16C
+#define XTRXDSP_TEMPLATE_IQ16_HC16_F16C
+#define XTRXDSP_TEMPLATE_HC16_IQ16_F16C
+#else
+#define XTRXDSP_TEMPLATE_IQ16_HC16
+#define XTRXDSP_TEMPLATE_HC16_IQ16
+#endif
+#define XTRXDSP_TEMPLATE_IQ16_BF16_SSE2
+#define XTRXDSP_TEMPLATE_BF16_IQ16_SSE2
+
+#define XTRXDSP_TEMPLATE_IQ16_SC64_AVX
+#define XTRXDSP_TEMPLATE_IQ12_SC64
+#define XTRXDSP_TEMPLATE_SC64_IQ16_AVX
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32_NT_SSE2
+#define XTRXDSP_TEMPLATE_IQ16_SC32I_NT_SSE2
+#define XTRXDSP_TEMPLATE_SC32_IQ16_NT_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32_NT_SSE2
+#define XTRXDSP_TEMPLATE_IQ8_SC32_NT_SSE2
+
+#define XTRXDSP_TEMPLATE_IQ16_IC16I_IP_SSE2
+#define XTRXDSP_TEMPLATE_IQ8_IC8I_IP
+#define XTRXDSP_TEMPLATE_IC16I_IQ16_IP_SSE2
+#define XTRXDSP_TEMPLATE_SC32_IQ16_IP_SSE2
+#define XTRXDSP_TEMPLATE_IQ16_SC32_IP_SSE2
+#define XTRXDSP_TEMPLATE_IQ8_SC32_IP
+#define XTRXDSP_TEMPLATE_IQ8_IC16_IP_SSE2
+
+#define XTRXDSP_TEMPLATE_IQ16_SC32N_SSE2
+#define XTRXDSP_TEMPLATE_IQ16_IC16N_SSE2
+#define XTRXDSP_TEMPLATE_IQ12_SC32N_SSE2
+#define XTRXDSP_TEMPLATE_IQ8_SC32N_SSE2
+#define XTRXDSP_TEMPLATE_IQ8_IC16N_SSE2
+#define XTRXDSP_TEMPLATE_SC32N_IQ16_SSE2
+#define XTRXDSP_TEMPLATE_IC16N_IQ16_SSE2
+
+#define XTRXDSP_TEMPLATE_SC32_CONV64_AVX
+#define XTRXDSP_TEMPLATE_IQ16_CONV64
+#define XTRXDSP_TEMPLATE_SC32_NCO_AVX
+#define XTRXDSP_TEMPLATE_IC16_NCO_SSE2
+#define XTRXDSP_TEMPLATE_SC32_NCO_IQ16_AVX
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * xtrxdsp NCO source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxdsp_nco.h"
+#include <math.h>
+
+static uint32_t turns_to_phase(double turns)
+{
+	turns -= floor(turns);
+	return (uint32_t)(uint64_t)llround(turns * 4294967296.0);
+}
+
+int xtrxdsp_nco_init(double freq,
+					 xtrxdsp_nco_state_t *out)
+{
+	out->phase = 0;
+	out->dphase = 0;
+	out->func = resolve_xtrxdsp_sc32_nco();
+	out->func_int = resolve_xtrxdsp_ic16_nco();
+
+	return xtrxdsp_nco_set_freq(out, freq);
+}
+
+int xtrxdsp_nco_set_freq(xtrxdsp_nco_state_t* state,
+						 double freq)
+{
+	if (!(freq >= -0.5 && freq <= 0.5))
+		return -EINVAL;
+
+	state->dphase = turns_to_phase(freq);
+	return 0;
+}
+
+void xtrxdsp_nco_set_phase(xtrxdsp_nco_state_t* state,
+						   double phase)
+{
+	state->phase = turns_to_phase(phase);
+}
+
+void xtrxdsp_nco_work(xtrxdsp_nco_state_t* state,
+					  const float *__restrict indata,
+					  float *__restrict outdata,
+					  unsigned num_insamples)
+{
+	state->phase = state->func(indata, outdata, num_insamples,
+							   state->phase, state->dphase);
+}
+
+void xtrxdsp_nco_worki(xtrxdsp_nco_state_t* state,
+					   const int16_t *__restrict indata,
+					   int16_t *__restrict outdata,
+					   unsigned num_insamples)
+{
+	state->phase = state->func_int(indata, outdata, num_insamples,
+								   state->phase, state->dphase);
+}
@@ -0,0 +1,88 @@
+/*
+ * Public xtrxdsp NCO header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_NCO_H
+#define XTRXDSP_NCO_H
+
+#include <xtrxdsp.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct xtrxdsp_nco_state {
+	uint32_t phase;  // Phase accumulator, full scale is one turn
+	uint32_t dphase; // Phase increment per sample
+	func_xtrxdsp_sc32_nco_t func;
+	func_xtrxdsp_ic16_nco_t func_int;
+} xtrxdsp_nco_state_t;
+
+/**
+ * @brief xtrxdsp_nco_init Initializes complex mixer, multiplying the stream
+ *                         by exp(j * 2 * pi * freq * n)
+ * @param freq Frequency normalized to sample rate, [-0.5, 0.5]
+ * @param out Structure to initialize
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_nco_init(double freq,
+					 xtrxdsp_nco_state_t *out);
+
+/**
+ * @brief xtrxdsp_nco_set_freq Retunes NCO keeping current phase
+ * @param state NCO state
+ * @param freq Frequency normalized to sample rate, [-0.5, 0.5]
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_nco_set_freq(xtrxdsp_nco_state_t* state,
+						 double freq);
+
+/**
+ * @brief xtrxdsp_nco_set_phase Sets phase of the next sample
+ * @param state NCO state
+ * @param phase Phase in turns, i.e. 0.25 is pi/2
+ */
+void xtrxdsp_nco_set_phase(xtrxdsp_nco_state_t* state,
+						   double phase);
+
+/**
+ * @brief xtrxdsp_nco_work Mixes block of sc32 data, phase is continuous across
+ *                         calls
+ * @param num_insamples Number of complex samples
+ */
+void xtrxdsp_nco_work(xtrxdsp_nco_state_t* state,
+					  const float *__restrict indata,
+					  float *__restrict outdata,
+					  unsigned num_insamples);
+
+/**
+ * @brief xtrxdsp_nco_worki Mixes block of ic16 data, results are rounded and
+ *                          saturated
+ * @param num_insamples Number of complex samples
+ */
+void xtrxdsp_nco_worki(xtrxdsp_nco_state_t* state,
+					   const int16_t *__restrict indata,
+					   int16_t *__restrict outdata,
+					   unsigned num_insamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
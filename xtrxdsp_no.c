@@ -20,26 +20,9 @@
 
 #include "xtrxdsp.h"
 
-#define XTRXDSP_TEMPLATE_IQ16_SC32
-#define XTRXDSP_TEMPLATE_IQ12_SC32
-#define XTRXDSP_TEMPLATE_IQ8_SC32
-#define XTRXDSP_TEMPLATE_IQ8_IC16
-
-#define XTRXDSP_TEMPLATE_IQ16_SC32I
-#define XTRXDSP_TEMPLATE_IQ12_SC32I
-#define XTRXDSP_TEMPLATE_IQ8_SC32I
-
-#define XTRXDSP_TEMPLATE_SC32_IQ16
-#define XTRXDSP_TEMPLATE_SC32I_IQ16
-
-#define XTRXDSP_TEMPLATE_IC16I_IQ16
-#define XTRXDSP_TEMPLATE_IQ16_IC16I
-
-#define XTRXDSP_TEMPLATE_IQ8_IC16I
-#define XTRXDSP_TEMPLATE_IQ8_IC8I
+#include "xtrxdsp_isa_no.h"
 
 #define XTRXDSP_TEMPLATE_SC32_CONV64_NAME _no
-#define XTRXDSP_TEMPLATE_SC32_CONV64
 
 #define XTRXDSP_TEMPLATE_B8_EXPAND_X2_NAME _no
 #define XTRXDSP_TEMPLATE_B8_EXPAND_X2
@@ -48,7 +31,6 @@
 #define XTRXDSP_TEMPLATE_B8_EXPAND_X4
 
 #define XTRXDSP_TEMPLATE_IQ16_CONV64_NAME _no
-#define XTRXDSP_TEMPLATE_IQ16_CONV64
 
 #define XTRXDSP_TEMPLATE_B4_EXPAND_X2_NAME _no
 #define XTRXDSP_TEMPLATE_B4_EXPAND_X2
@@ -56,6 +38,12 @@
 #define XTRXDSP_TEMPLATE_B4_EXPAND_X4_NAME _no
 #define XTRXDSP_TEMPLATE_B4_EXPAND_X4
 
+#define XTRXDSP_TEMPLATE_SC32_NCO_NAME _no
+
+#define XTRXDSP_TEMPLATE_IC16_NCO_NAME _no
+
+#define XTRXDSP_TEMPLATE_SC32_NCO_IQ16_NAME _no
+
 #include "xtrxdsp_templates.c"
 
 DECLARE_TEMPLATES(no)
@@ -0,0 +1,487 @@
+/*
+ * xtrxdsp kernel planner source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxdsp_plan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#ifndef XTRXDSP_VERSION
+#define XTRXDSP_VERSION "unknown"
+#endif
+
+#define WISDOM_MAGIC "xtrxdsp-wisdom 1"
+
+/* argument layouts of kernels that can be timed on synthetic buffers */
+enum plan_shape {
+	SHAPE_SCALE,        // (in, out, float scale, bytes)
+	SHAPE_SCALE64,      // (in, out, double scale, bytes)
+	SHAPE_PLAIN,        // (in, out, bytes)
+	SHAPE_STATE,        // (in, out, bytes, prevstate)
+	SHAPE_SCALE_2OUT,   // (in, outa, outb, float scale, bytes)
+	SHAPE_2OUT,         // (in, outa, outb, bytes)
+	SHAPE_2IN_SCALE,    // (ina, inb, out, float scale, bytes)
+	SHAPE_2IN,          // (ina, inb, out, bytes)
+};
+
+/* input contents, floats have to be sane to not hit denormals */
+enum plan_input {
+	IN_INT,
+	IN_F32,
+	IN_F64,
+	IN_F16,
+	IN_BF16,
+};
+
+typedef struct plan_func {
+	const char* name;
+	enum plan_shape shape;
+	enum plan_input input;
+} plan_func_t;
+
+static const plan_func_t s_plan_funcs[] = {
+	{ "xtrxdsp_iq16_sc32",     SHAPE_SCALE,      IN_INT },
+	{ "xtrxdsp_iq12_sc32",     SHAPE_STATE,      IN_INT },
+	{ "xtrxdsp_iq8_sc32",      SHAPE_PLAIN,      IN_INT },
+	{ "xtrxdsp_iq8_ic16",      SHAPE_PLAIN,      IN_INT },
+	{ "xtrxdsp_iq16_sc32i",    SHAPE_SCALE_2OUT, IN_INT },
+	{ "xtrxdsp_iq16_ic16i",    SHAPE_2OUT,       IN_INT },
+	{ "xtrxdsp_iq8_sc32i",     SHAPE_2OUT,       IN_INT },
+	{ "xtrxdsp_iq8_ic16i",     SHAPE_2OUT,       IN_INT },
+	{ "xtrxdsp_iq8_ic8i",      SHAPE_2OUT,       IN_INT },
+	{ "xtrxdsp_sc32_iq16",     SHAPE_SCALE,      IN_F32 },
+	{ "xtrxdsp_sc32i_iq16",    SHAPE_2IN_SCALE,  IN_F32 },
+	{ "xtrxdsp_ic16i_iq16",    SHAPE_2IN,        IN_INT },
+	{ "xtrxdsp_iq16_hc16",     SHAPE_SCALE,      IN_INT },
+	{ "xtrxdsp_iq16_bf16",     SHAPE_SCALE,      IN_INT },
+	{ "xtrxdsp_hc16_iq16",     SHAPE_SCALE,      IN_F16 },
+	{ "xtrxdsp_bf16_iq16",     SHAPE_SCALE,      IN_BF16 },
+	{ "xtrxdsp_iq16_sc64",     SHAPE_SCALE64,    IN_INT },
+	{ "xtrxdsp_iq12_sc64",     SHAPE_STATE,      IN_INT },
+	{ "xtrxdsp_sc64_iq16",     SHAPE_SCALE64,    IN_F64 },
+	{ "xtrxdsp_iq16_sc32_nt",  SHAPE_SCALE,      IN_INT },
+	{ "xtrxdsp_iq16_sc32i_nt", SHAPE_SCALE_2OUT, IN_INT },
+	{ "xtrxdsp_sc32_iq16_nt",  SHAPE_SCALE,      IN_F32 },
+	{ "xtrxdsp_iq12_sc32_nt",  SHAPE_STATE,      IN_INT },
+	{ "xtrxdsp_iq8_sc32_nt",   SHAPE_PLAIN,      IN_INT },
+};
+
+/* no kernel produces more than 8 output bytes per size unit */
+#define PLAN_BUF_MUL    8
+#define PLAN_TRIALS     5
+#define PLAN_TRIAL_NS   200000.0
+
+typedef struct plan_bufs {
+	void* in[2];
+	void* out[2];
+} plan_bufs_t;
+
+static const plan_func_t* plan_func_find(const char* func)
+{
+	unsigned i;
+
+	for (i = 0; i < sizeof(s_plan_funcs) / sizeof(s_plan_funcs[0]); i++) {
+		if (strcmp(s_plan_funcs[i].name, func) == 0)
+			return &s_plan_funcs[i];
+	}
+	return NULL;
+}
+
+static void plan_fill(void* buf, size_t size, enum plan_input input)
+{
+	uint32_t seed = 12345;
+	size_t i;
+
+	for (i = 0; i < size / 8; i++) {
+		seed = seed * 1103515245 + 12345;
+		switch (input) {
+		case IN_INT:  ((uint16_t*)buf)[4*i] = seed >> 16;
+					  ((uint16_t*)buf)[4*i + 1] = seed;
+					  ((uint16_t*)buf)[4*i + 2] = seed >> 8;
+					  ((uint16_t*)buf)[4*i + 3] = seed >> 3; break;
+		case IN_F32:  ((float*)buf)[2*i] = (int16_t)(seed >> 16) / 32768.0f;
+					  ((float*)buf)[2*i + 1] = (int16_t)seed / 32768.0f; break;
+		case IN_F64:  ((double*)buf)[i] = (int16_t)(seed >> 16) / 32768.0; break;
+		case IN_F16:  ((uint16_t*)buf)[4*i] = 0x3800 ^ (seed & 0x83ff);
+					  ((uint16_t*)buf)[4*i + 1] = 0x3400 ^ (seed & 0x83ff);
+					  ((uint16_t*)buf)[4*i + 2] = 0x3800 ^ (seed >> 16 & 0x83ff);
+					  ((uint16_t*)buf)[4*i + 3] = 0x3400 ^ (seed >> 16 & 0x83ff); break;
+		case IN_BF16: ((uint16_t*)buf)[4*i] = 0x3f00 ^ (seed & 0x807f);
+					  ((uint16_t*)buf)[4*i + 1] = 0x3e80 ^ (seed & 0x807f);
+					  ((uint16_t*)buf)[4*i + 2] = 0x3f00 ^ (seed >> 16 & 0x807f);
+					  ((uint16_t*)buf)[4*i + 3] = 0x3e80 ^ (seed >> 16 & 0x807f); break;
+		}
+	}
+}
+
+static void plan_call(const plan_func_t* pf,
+					  xtrxdsp_kernel_t fn,
+					  const plan_bufs_t* b,
+					  size_t bytes)
+{
+	float scale = (pf->input == IN_INT) ? 1.0f / 32768 : 32767.0f;
+
+	switch (pf->shape) {
+	case SHAPE_SCALE:
+		((void (*)(const void*, void*, float, size_t))fn)(b->in[0], b->out[0], scale, bytes);
+		break;
+	case SHAPE_SCALE64:
+		((void (*)(const void*, void*, double, size_t))fn)(b->in[0], b->out[0], scale, bytes);
+		break;
+	case SHAPE_PLAIN:
+		((void (*)(const void*, void*, size_t))fn)(b->in[0], b->out[0], bytes);
+		break;
+	case SHAPE_STATE:
+		((uint64_t (*)(const void*, void*, size_t, uint64_t))fn)(b->in[0], b->out[0], bytes, 0);
+		break;
+	case SHAPE_SCALE_2OUT:
+		((void (*)(const void*, void*, void*, float, size_t))fn)(b->in[0], b->out[0], b->out[1], scale, bytes);
+		break;
+	case SHAPE_2OUT:
+		((void (*)(const void*, void*, void*, size_t))fn)(b->in[0], b->out[0], b->out[1], bytes);
+		break;
+	case SHAPE_2IN_SCALE:
+		((void (*)(const void*, const void*, void*, float, size_t))fn)(b->in[0], b->in[1], b->out[0], scale, bytes);
+		break;
+	case SHAPE_2IN:
+		((void (*)(const void*, const void*, void*, size_t))fn)(b->in[0], b->in[1], b->out[0], bytes);
+		break;
+	}
+}
+
+static double plan_time_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* returns time per call of the best out of the trial runs */
+static double plan_measure(const plan_func_t* pf,
+						   xtrxdsp_kernel_t fn,
+						   const plan_bufs_t* b,
+						   size_t bytes,
+						   unsigned reps)
+{
+	double start;
+	unsigned i;
+
+	start = plan_time_ns();
+	for (i = 0; i < reps; i++)
+		plan_call(pf, fn, b, bytes);
+	return (plan_time_ns() - start) / reps;
+}
+
+static int plan_select(const plan_func_t* pf,
+					   size_t bytes,
+					   unsigned flags,
+					   unsigned cnt,
+					   const xtrxdsp_kernel_t* fn,
+					   unsigned* winner,
+					   double* ns)
+{
+	double best[XTRXDSP_ISA_NATIVE + 1];
+	unsigned trials = (flags & XTRXDSP_PLAN_PATIENT) ? 5 * PLAN_TRIALS : PLAN_TRIALS;
+	unsigned reps = 1;
+	size_t size = bytes * PLAN_BUF_MUL + XTRXDSP_ALIGN;
+	plan_bufs_t b = { { NULL, NULL }, { NULL, NULL } };
+	unsigned i, j;
+	double t;
+	int res = -ENOMEM;
+
+	for (i = 0; i < 2; i++) {
+		b.in[i] = xtrxdsp_aligned_alloc(size);
+		b.out[i] = xtrxdsp_aligned_alloc(size);
+		if (b.in[i] == NULL || b.out[i] == NULL)
+			goto fail;
+		plan_fill(b.in[i], size, pf->input);
+		memset(b.out[i], 0, size);
+	}
+
+	/* calibrate repetitions on the first candidate, it's warm afterwards */
+	while ((t = plan_measure(pf, fn[0], &b, bytes, reps)) * reps < PLAN_TRIAL_NS && reps < (1U << 24))
+		reps *= 2;
+
+	for (j = 0; j < cnt; j++)
+		best[j] = 1e300;
+
+	/* interleave candidates so frequency or load drift hits them alike */
+	for (i = 0; i < trials; i++) {
+		for (j = 0; j < cnt; j++) {
+			t = plan_measure(pf, fn[j], &b, bytes, reps);
+			if (t < best[j])
+				best[j] = t;
+		}
+	}
+
+	*winner = 0;
+	for (j = 1; j < cnt; j++) {
+		if (best[j] < best[*winner])
+			*winner = j;
+	}
+	*ns = best[*winner];
+	res = 0;
+
+fail:
+	for (i = 0; i < 2; i++) {
+		xtrxdsp_aligned_free(b.in[i]);
+		xtrxdsp_aligned_free(b.out[i]);
+	}
+	return res;
+}
+
+void xtrxdsp_plan_init(xtrxdsp_plan_t* plan)
+{
+	plan->k = *xtrxdsp_get_dispatch();
+	plan->count = 0;
+}
+
+const xtrxdsp_plan_entry_t* xtrxdsp_plan_find(const xtrxdsp_plan_t* plan,
+											  const char* func)
+{
+	unsigned i;
+
+	for (i = 0; i < plan->count; i++) {
+		if (strcmp(plan->entry[i].func, func) == 0)
+			return &plan->entry[i];
+	}
+	return NULL;
+}
+
+/* binds variant, one of the xtrxdsp_get_candidates() names, into the plan */
+static int plan_store(xtrxdsp_plan_t* plan,
+					  const plan_func_t* pf,
+					  size_t bytes,
+					  const char* variant,
+					  double ns)
+{
+	xtrxdsp_plan_entry_t* e;
+	int res;
+
+	e = (xtrxdsp_plan_entry_t*)xtrxdsp_plan_find(plan, pf->name);
+	if (e == NULL) {
+		if (plan->count == XTRXDSP_PLAN_MAX)
+			return -ENOSPC;
+		e = &plan->entry[plan->count];
+	}
+
+	res = xtrxdsp_dispatch_bind(&plan->k, pf->name, variant);
+	if (res)
+		return res;
+
+	if (e == &plan->entry[plan->count])
+		plan->count++;
+
+	e->func = pf->name;
+	e->variant = variant;
+	e->bytes = bytes;
+	e->ns = ns;
+	return 0;
+}
+
+int xtrxdsp_plan_func(xtrxdsp_plan_t* plan,
+					  const char* func,
+					  size_t bytes,
+					  unsigned flags)
+{
+	xtrxdsp_kernel_t fn[XTRXDSP_ISA_NATIVE + 1];
+	const char* variant[XTRXDSP_ISA_NATIVE + 1];
+	const xtrxdsp_plan_entry_t* e;
+	const plan_func_t* pf;
+	unsigned winner = 0;
+	double ns = 0;
+	int cnt, res;
+
+	cnt = xtrxdsp_get_candidates(func, fn, variant, XTRXDSP_ISA_NATIVE + 1);
+	if (cnt < 0)
+		return cnt;
+	if (bytes == 0)
+		return -EINVAL;
+
+	pf = plan_func_find(func);
+	if (pf == NULL)
+		return -ENOTSUP;
+
+	/* already measured for this size, i.e. imported from wisdom */
+	e = xtrxdsp_plan_find(plan, func);
+	if (e && e->bytes == bytes && (e->ns > 0 || (flags & XTRXDSP_PLAN_ESTIMATE)))
+		return 0;
+
+	if (!(flags & XTRXDSP_PLAN_ESTIMATE) && cnt > 1) {
+		res = plan_select(pf, bytes, flags, cnt, fn, &winner, &ns);
+		if (res)
+			return res;
+	}
+
+	return plan_store(plan, pf, bytes, variant[winner], ns);
+}
+
+/* wisdom is only valid for the CPU model and library it was measured with */
+static void wisdom_cpu(char* model, size_t size)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	unsigned regs[12];
+	unsigned i;
+
+	if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004) {
+		for (i = 0; i < 3; i++)
+			__get_cpuid(0x80000002 + i, &regs[4*i], &regs[4*i + 1],
+						&regs[4*i + 2], &regs[4*i + 3]);
+		for (i = 0; i < sizeof(regs) && i < size - 1; i++)
+			model[i] = ((const char*)regs)[i];
+		model[i] = 0;
+
+		/* brand string is padded with spaces */
+		while (i > 0 && (model[i - 1] == ' ' || model[i - 1] == 0))
+			model[--i] = 0;
+		while (model[0] == ' ')
+			memmove(model, model + 1, strlen(model));
+		if (model[0])
+			return;
+	}
+#endif
+	snprintf(model, size, "unknown");
+}
+
+int xtrxdsp_plan_export(const xtrxdsp_plan_t* plan, const char* path)
+{
+	char model[64];
+	char tmp[4096];
+	unsigned i;
+	FILE* f;
+	int fd, res = 0;
+
+	/* write aside and rename, so concurrent readers never see a partial file;
+	 * the name is unique per call, writers to the same path don't collide
+	 */
+	if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path) >= (int)sizeof(tmp))
+		return -EINVAL;
+
+	fd = mkstemp(tmp);
+	if (fd < 0)
+		return -errno;
+
+	f = fdopen(fd, "w");
+	if (f == NULL) {
+		res = -errno;
+		close(fd);
+		unlink(tmp);
+		return res;
+	}
+
+	wisdom_cpu(model, sizeof(model));
+	fprintf(f, "%s\n", WISDOM_MAGIC);
+	fprintf(f, "cpu %s\n", model);
+	fprintf(f, "version %s\n", XTRXDSP_VERSION);
+	for (i = 0; i < plan->count; i++) {
+		fprintf(f, "%s %zu %s %.1f\n", plan->entry[i].func, plan->entry[i].bytes,
+				plan->entry[i].variant, plan->entry[i].ns);
+	}
+
+	if (ferror(f))
+		res = -EIO;
+	if (fclose(f) != 0 && res == 0)
+		res = -errno;
+	if (res == 0 && rename(tmp, path) != 0)
+		res = -errno;
+	if (res)
+		unlink(tmp);
+	return res;
+}
+
+/* compares a header line against the expected value */
+static bool wisdom_header(FILE* f, const char* key, const char* value)
+{
+	char line[256];
+	size_t klen = strlen(key);
+
+	if (fgets(line, sizeof(line), f) == NULL)
+		return false;
+	line[strcspn(line, "\n")] = 0;
+
+	if (key[0] == 0)
+		return strcmp(line, value) == 0;
+	return strncmp(line, key, klen) == 0 && line[klen] == ' ' &&
+			strcmp(line + klen + 1, value) == 0;
+}
+
+int xtrxdsp_plan_import(xtrxdsp_plan_t* plan, const char* path)
+{
+	char model[64];
+	char line[256];
+	char func[64];
+	char variant[16];
+	xtrxdsp_kernel_t fn[XTRXDSP_ISA_NATIVE + 1];
+	const char* names[XTRXDSP_ISA_NATIVE + 1];
+	const plan_func_t* pf;
+	size_t bytes;
+	double ns;
+	int cnt, i, res = 0;
+	FILE* f;
+
+	f = fopen(path, "r");
+	if (f == NULL)
+		return -errno;
+
+	wisdom_cpu(model, sizeof(model));
+	if (!wisdom_header(f, "", WISDOM_MAGIC)) {
+		res = -EINVAL;
+		goto done;
+	}
+	if (!wisdom_header(f, "cpu", model) ||
+			!wisdom_header(f, "version", XTRXDSP_VERSION)) {
+		res = -ESTALE;
+		goto done;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "%63s %zu %15s %lf", func, &bytes, variant, &ns) != 4) {
+			res = -EINVAL;
+			break;
+		}
+
+		/* entries not usable under the current ISA limit keep defaults */
+		pf = plan_func_find(func);
+		if (pf == NULL)
+			continue;
+		cnt = xtrxdsp_get_candidates(func, fn, names, XTRXDSP_ISA_NATIVE + 1);
+		for (i = 0; i < cnt; i++) {
+			if (strcmp(names[i], variant) == 0)
+				break;
+		}
+		if (i >= cnt)
+			continue;
+
+		res = plan_store(plan, pf, bytes, names[i], ns);
+		if (res)
+			break;
+	}
+
+done:
+	fclose(f);
+	return res;
+}
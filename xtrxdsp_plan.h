@@ -0,0 +1,121 @@
+/*
+ * Public xtrxdsp kernel planner header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_PLAN_H
+#define XTRXDSP_PLAN_H
+
+#include <xtrxdsp.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Resolvers pick kernels by ISA preference only, which is not always the
+ * fastest choice (i.e. AVX float on low power parts) and doesn't depend on
+ * block size. A plan times every usable variant of a function on the block
+ * size it is going to be called with and binds the winner into its own
+ * dispatch table; call kernels through plan->k afterwards.
+ */
+
+#define XTRXDSP_PLAN_MAX 16
+
+enum xtrxdsp_plan_flags {
+	XTRXDSP_PLAN_MEASURE  = 0,    // Time every candidate
+	XTRXDSP_PLAN_ESTIMATE = 1,    // Don't time, take the ISA preference order
+	XTRXDSP_PLAN_PATIENT  = 2,    // Time longer for steadier results
+};
+
+typedef struct xtrxdsp_plan_entry {
+	const char* func;     // Function name, i.e. "xtrxdsp_iq16_sc32"
+	const char* variant;  // Bound variant suffix
+	size_t bytes;         // Block size the variant was selected for
+	double ns;            // Time per call of the winner, 0 if not measured
+} xtrxdsp_plan_entry_t;
+
+typedef struct xtrxdsp_plan {
+	xtrxdsp_dispatch_t k;
+	unsigned count;
+	xtrxdsp_plan_entry_t entry[XTRXDSP_PLAN_MAX];
+} xtrxdsp_plan_t;
+
+/**
+ * @brief xtrxdsp_plan_init Initializes plan with the default kernels
+ * @param plan Plan
+ */
+void xtrxdsp_plan_init(xtrxdsp_plan_t* plan);
+
+/**
+ * @brief xtrxdsp_plan_func Selects the fastest variant of a function for the
+ *        given block size, planning the same function again replaces the entry
+ *        unless it was already measured for that size (i.e. imported wisdom)
+ * @param plan Plan
+ * @param func Function name, i.e. "xtrxdsp_iq16_sc32"
+ * @param bytes Size argument the function is going to be called with
+ * @param flags Bitmask of xtrxdsp_plan_flags
+ * @return 0 on success, -EINVAL on unknown function or zero size, -ENOTSUP
+ *         if the function can't be timed standalone (stateful kernels),
+ *         -ENOSPC if the plan is full, -ENOMEM
+ */
+int xtrxdsp_plan_func(xtrxdsp_plan_t* plan,
+					  const char* func,
+					  size_t bytes,
+					  unsigned flags);
+
+/**
+ * @brief xtrxdsp_plan_find Returns plan entry of a function
+ * @param plan Plan
+ * @param func Function name
+ * @return Entry or NULL if the function wasn't planned
+ */
+const xtrxdsp_plan_entry_t* xtrxdsp_plan_find(const xtrxdsp_plan_t* plan,
+											  const char* func);
+
+/*
+ * Wisdom keeps plan entries across restarts. The file is tied to the CPU
+ * model and library version, a mismatch makes the import fail with -ESTALE
+ * and the caller should plan again and export the result.
+ */
+
+/**
+ * @brief xtrxdsp_plan_export Stores plan entries as wisdom
+ * @param plan Plan
+ * @param path Wisdom file, replaced atomically
+ * @return 0 on success, -errno on I/O error
+ */
+int xtrxdsp_plan_export(const xtrxdsp_plan_t* plan, const char* path);
+
+/**
+ * @brief xtrxdsp_plan_import Loads wisdom into plan, entries of unknown
+ *        functions or variants not usable under the current ISA limit are
+ *        skipped
+ * @param plan Plan, initialized by xtrxdsp_plan_init()
+ * @param path Wisdom file
+ * @return 0 on success, -ENOENT if there is no file, -ESTALE if it was made
+ *         on other CPU model or library version, -EINVAL on malformed file,
+ *         -ENOSPC if the plan is full
+ */
+int xtrxdsp_plan_import(xtrxdsp_plan_t* plan, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * xtrxdsp resampler source file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "xtrxdsp_resampler.h"
+#include <string.h>
+
+/* ratios outside of this range are surely configuration errors */
+#define MIN_RATIO (1.0 / 64)
+#define MAX_RATIO 64.0
+
+/*
+ * Sample positions are counted in the extended sequence
+ *   e[] = { history[0], history[1], history[2], in[0], in[1], ... }
+ * The output at position p = k + mu uses e[k-1] .. e[k+2], so the very last
+ * output we're able to produce in the block has k == num_insamples
+ */
+
+static inline void farrow_cubic(const float *__restrict e, float mu, float *__restrict out)
+{
+	/* Lagrange 3rd order interpolation in Farrow form, e points to e[k-1] */
+	float c0i = e[2];
+	float c0q = e[3];
+	float c1i = e[4] - (1.0f/3) * e[0] - 0.5f * e[2] - (1.0f/6) * e[6];
+	float c1q = e[5] - (1.0f/3) * e[1] - 0.5f * e[3] - (1.0f/6) * e[7];
+	float c2i = 0.5f * (e[0] + e[4]) - e[2];
+	float c2q = 0.5f * (e[1] + e[5]) - e[3];
+	float c3i = (1.0f/6) * (e[6] - e[0]) + 0.5f * (e[2] - e[4]);
+	float c3q = (1.0f/6) * (e[7] - e[1]) + 0.5f * (e[3] - e[5]);
+
+	out[0] = ((c3i * mu + c2i) * mu + c1i) * mu + c0i;
+	out[1] = ((c3q * mu + c2q) * mu + c1q) * mu + c0q;
+}
+
+int xtrxdsp_resampler_init(double ratio,
+						   xtrxdsp_resampler_state_t *out)
+{
+	memset(out->history, 0, sizeof(out->history));
+	out->pos = 1;
+	out->ratio = 1.0;
+
+	return xtrxdsp_resampler_set_ratio(out, ratio);
+}
+
+int xtrxdsp_resampler_set_ratio(xtrxdsp_resampler_state_t* state,
+								double ratio)
+{
+	if (!(ratio >= MIN_RATIO && ratio <= MAX_RATIO))
+		return -EINVAL;
+
+	state->ratio = ratio;
+	return 0;
+}
+
+unsigned xtrxdsp_resampler_max_out(const xtrxdsp_resampler_state_t* state,
+								   unsigned num_insamples)
+{
+	double span = (double)num_insamples + 1 - state->pos;
+	if (span <= 0)
+		return 0;
+
+	/* one extra sample covers rounding of accumulated position */
+	return (unsigned)(span / state->ratio) + 2;
+}
+
+unsigned xtrxdsp_resampler_work(xtrxdsp_resampler_state_t* state,
+								const float *__restrict indata,
+								float *__restrict outdata,
+								unsigned num_insamples)
+{
+	float stage[4 * XTRXDSP_RESAMPLER_HISTORY];
+	const double ratio = state->ratio;
+	const double end = (double)num_insamples + 1;
+	double pos = state->pos;
+	float *out = outdata;
+	unsigned k;
+
+	/* the history stitch below reads XTRXDSP_RESAMPLER_HISTORY samples */
+	if (num_insamples < XTRXDSP_RESAMPLER_HISTORY)
+		return 0;
+
+	/* stitch history with the beginning of the block */
+	memcpy(stage, state->history, sizeof(state->history));
+	memcpy(stage + 2 * XTRXDSP_RESAMPLER_HISTORY, indata,
+		   2 * XTRXDSP_RESAMPLER_HISTORY * sizeof(float));
+
+	for (; pos < 2 * XTRXDSP_RESAMPLER_HISTORY - 2; pos += ratio, out += 2) {
+		k = (unsigned)pos;
+		farrow_cubic(stage + 2 * (k - 1), (float)(pos - k), out);
+	}
+
+	/* e[k - 1] is indata[k - 4] from now on */
+	for (; pos < end; pos += ratio, out += 2) {
+		k = (unsigned)pos;
+		farrow_cubic(indata + 2 * (k - 1 - XTRXDSP_RESAMPLER_HISTORY),
+					 (float)(pos - k), out);
+	}
+
+	/* store data for the next run */
+	memcpy(state->history,
+		   indata + 2 * (num_insamples - XTRXDSP_RESAMPLER_HISTORY),
+		   sizeof(state->history));
+	state->pos = pos - num_insamples;
+
+	return (out - outdata) / 2;
+}
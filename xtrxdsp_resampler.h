@@ -0,0 +1,90 @@
+/*
+ * Public xtrxdsp resampler header file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef XTRXDSP_RESAMPLER_H
+#define XTRXDSP_RESAMPLER_H
+
+#include <xtrxdsp.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of complex samples kept between blocks by the cubic interpolator */
+#define XTRXDSP_RESAMPLER_HISTORY 3
+
+typedef struct xtrxdsp_resampler_state {
+	float history[2 * XTRXDSP_RESAMPLER_HISTORY]; // Last input samples, I/Q interleaved
+	double ratio; // Input samples consumed per output sample
+	double pos;   // Position of the next output in history + block coordinates
+} xtrxdsp_resampler_state_t;
+
+/**
+ * @brief xtrxdsp_resampler_init Initializes arbitrary ratio Farrow (cubic
+ *                               Lagrange) resampler and fills history with zeros
+ * @param ratio Input rate / output rate, i.e. 2.0 halves the rate
+ * @param out Structure to initialize
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_resampler_init(double ratio,
+						   xtrxdsp_resampler_state_t *out);
+
+/**
+ * @brief xtrxdsp_resampler_set_ratio Changes resampling ratio without touching
+ *                                    history and fractional phase, so it can be
+ *                                    called before every block to track drift
+ * @param state Resampler state
+ * @param ratio New input rate / output rate
+ * @return 0 - success, -errno on error
+ */
+int xtrxdsp_resampler_set_ratio(xtrxdsp_resampler_state_t* state,
+								double ratio);
+
+/**
+ * @brief xtrxdsp_resampler_max_out Upper bound of output samples produced by
+ *                                  the next xtrxdsp_resampler_work() call
+ * @param state Resampler state
+ * @param num_insamples Number of complex samples in the next block
+ * @return maximum number of complex output samples
+ */
+unsigned xtrxdsp_resampler_max_out(const xtrxdsp_resampler_state_t* state,
+								   unsigned num_insamples);
+
+/**
+ * @brief xtrxdsp_resampler_work Resamples block of sc32 data
+ * @param state Resampler state
+ * @param indata Interleaved I/Q input
+ * @param outdata Interleaved I/Q output, should be able to hold
+ *                xtrxdsp_resampler_max_out() samples
+ * @param num_insamples Number of complex input samples, at least
+ *                      XTRXDSP_RESAMPLER_HISTORY
+ * @return number of complex samples written to outdata; a shorter block is
+ *         not consumed and 0 is returned
+ */
+unsigned xtrxdsp_resampler_work(xtrxdsp_resampler_state_t* state,
+								const float *__restrict indata,
+								float *__restrict outdata,
+								unsigned num_insamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
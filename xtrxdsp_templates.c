@@ -26,12 +26,37 @@
 
 #define UNALIGN_IQ_BUFFER
 
+#define IS_ALIGNED(p, a) ((((uintptr_t)(p)) & ((a) - 1)) == 0)
+
+/* aligned is a loop invariant check of the output pointer, so the compiler
+ * unswitches the loop. Only legacy SSE encoding cares: movups is split into
+ * several uops on pre-Nehalem cores, VEX encoded unaligned stores run at full
+ * speed on aligned addresses.
+ */
+#if defined(UNALIGN_STORE) && !defined(__AVX__)
+#define _MM_STOREX_PS(aligned, p, v)    do { if (aligned) _mm_store_ps(p, v); else _mm_storeu_ps(p, v); } while (0)
+#elif defined(UNALIGN_STORE)
+#define _MM_STOREX_PS(aligned, p, v)    do { (void)(aligned); _mm_storeu_ps(p, v); } while (0)
+#else
+#define _MM_STOREX_PS(aligned, p, v)    do { (void)(aligned); _mm_store_ps(p, v); } while (0)
+#endif
+
 #ifdef UNALIGN_STORE
-#define _MM_STOREX_PS    _mm_storeu_ps
-#define _MM256_STOREX_PS _mm256_storeu_ps
+#define _MM256_STOREX_PS(aligned, p, v) do { (void)(aligned); _mm256_storeu_ps(p, v); } while (0)
+#else
+#define _MM256_STOREX_PS(aligned, p, v) do { (void)(aligned); _mm256_store_ps(p, v); } while (0)
+#endif
+
+/* same for loads of input that can't be aligned by a scalar prologue */
+#ifdef __AVX__
+#define _MM_LOADX_SI128(aligned, p)     ((void)(aligned), _mm_loadu_si128(p))
 #else
-#define _MM_STOREX_PS    _mm_store_ps
-#define _MM256_STOREX_PS _mm256_store_ps
+#define _MM_LOADX_SI128(aligned, p)     ((aligned) ? _mm_load_si128(p) : _mm_loadu_si128(p))
+#endif
+
+/* storage class of the generated kernels, xtrxdsp_inline.h makes them static inline */
+#ifndef XTRXDSP_TEMPLATE_LINKAGE
+#define XTRXDSP_TEMPLATE_LINKAGE
 #endif
 
 /* hints for compiler */
@@ -95,7 +120,7 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
     const int16_t *ldw = (const int16_t *)ld;
     for (;i < bytes; i += 4) {
         *(outa++) = *(ldw++) * scale;
-        if (i == bytes)
+        if (i + 2 >= bytes)
             break;
         *(outb++) = *(ldw++) * scale;
     }
@@ -149,35 +174,32 @@ uint64_t xtrxdsp_iq12_sc32_template(const void *__restrict iq,
   *  bs =  | v2  |v1|00|
   *        +-----+-----+
   */
-    switch (prevstate & 0xf) {
-    case 0:
-        v0 = *(ld++);
-        v1 = *(ld++);
-        v2 = *(ld++);
-        i += 3;
-    case 1:
-        v0 = (prevstate >> 8) & 0xff;
-        v1 = (prevstate >> 8) & 0xff;
-        v2 = *(ld++);
-        i++;
-        break;
-    case 2:
-        v0 = (prevstate >> 8) & 0xff;
-        v1 = *(ld++);
-        v2 = *(ld++);
-        i += 2;
-        break;
-    default:
+
+    /* prevstate: number of pending bytes in [3:0], the bytes from bit 8 */
+    q = prevstate & 0xf;
+    if (q > 2)
         return -1;
-    }
 
-    a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
-    b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+    if (q > 0) {
+        uint8_t v[3];
+        v[0] = (prevstate >> 8) & 0xff;
+        v[1] = (prevstate >> 16) & 0xff;
+
+        for (; q < 3 && i < inbytes; q++, i++) {
+            v[q] = *(ld++);
+        }
+        if (q < 3) {
+            return q | ((unsigned)v[0] << 8) | ((unsigned)v[1] << 16);
+        }
+
+        a = (int16_t) (((uint16_t)v[0] << 4) | ((uint16_t)v[1] << 12));
+        b = (int16_t) (((uint16_t)v[2] << 8) | (v[1] & 0xf0));
 
-    *(out++) = a * SCALE16;
-    *(out++) = b * SCALE16;
+        *(out++) = a * SCALE16;
+        *(out++) = b * SCALE16;
+    }
 
-    for (; i < inbytes - (inbytes % 3); i += 3) {
+    for (; i + 3 <= inbytes; i += 3) {
         v0 = *(ld++);
         v1 = *(ld++);
         v2 = *(ld++);
@@ -189,7 +211,7 @@ uint64_t xtrxdsp_iq12_sc32_template(const void *__restrict iq,
         *(out++) = b * SCALE16;
     }
 
-    switch (inbytes % 3) {
+    switch (inbytes - i) {
     default:
         return 0;
     case 1:
@@ -213,8 +235,33 @@ uint64_t xtrxdsp_iq12_sc32i_template(const void *__restrict iq,
     size_t i  = 0;
     uint8_t v0, v1, v2;
     float a, b;
+    unsigned q;
+
+    /* same layout and carry state as in xtrxdsp_iq12_sc32_template() */
+    q = prevstate & 0xf;
+    if (q > 2)
+        return -1;
+
+    if (q > 0) {
+        uint8_t v[3];
+        v[0] = (prevstate >> 8) & 0xff;
+        v[1] = (prevstate >> 16) & 0xff;
 
-    for (; i < inbytes - (inbytes % 3); i += 3) {
+        for (; q < 3 && i < inbytes; q++, i++) {
+            v[q] = *(ld++);
+        }
+        if (q < 3) {
+            return q | ((unsigned)v[0] << 8) | ((unsigned)v[1] << 16);
+        }
+
+        a = (int16_t) (((uint16_t)v[0] << 4) | ((uint16_t)v[1] << 12));
+        b = (int16_t) (((uint16_t)v[2] << 8) | (v[1] & 0xf0));
+
+        *(outa++) = a * SCALE16;
+        *(outb++) = b * SCALE16;
+    }
+
+    for (; i + 3 <= inbytes; i += 3) {
         v0 = *(ld++);
         v1 = *(ld++);
         v2 = *(ld++);
@@ -226,14 +273,15 @@ uint64_t xtrxdsp_iq12_sc32i_template(const void *__restrict iq,
         *(outb++) = b * SCALE16;
     }
 
-
-    uint64_t res = inbytes % 3;
-    for (; i < inbytes; ++i) {
-        res <<= 8;
-        res |= *(ld++);
+    switch (inbytes - i) {
+    default:
+        return 0;
+    case 1:
+        return 1 | ((unsigned)(*ld) << 8);
+    case 2:
+        q = (*ld++);
+        return (2 | (q << 8)) | ((unsigned)(*ld) << 16);
     }
-
-    return res;
 }
 #endif
 
@@ -318,7 +366,7 @@ void xtrxdsp_iq8_ic16i_template(const int8_t *__restrict iq,
 								 int16_t *__restrict outb,
 								 size_t bytes)
 {
-	for (; bytes > 2; bytes -= 2) {
+	for (; bytes > 1; bytes -= 2) {
 		*(outa++) = *(iq++) << 8;
 		*(outb++) = *(iq++) << 8;
 	}
@@ -332,7 +380,7 @@ void xtrxdsp_iq8_ic8i_template(const int8_t *__restrict iq,
 								 int8_t *__restrict outb,
 								 size_t bytes)
 {
-	for (; bytes > 2; bytes -= 2) {
+	for (; bytes > 1; bytes -= 2) {
 		*(outa++) = *(iq++);
 		*(outb++) = *(iq++);
 	}
@@ -361,17 +409,18 @@ void xtrxdsp_iq16_sc32_template(const int16_t *__restrict iq,
 #ifdef UNALIGN_IQ_BUFFER
   size_t unalign;
   /* Check for unalign start of IQ */
-  if (unlikely((unalign = ((uintptr_t)iq & 0x1c))) > 0) {
+  if (unlikely((unalign = ((uintptr_t)iq & 0x1e))) > 0) {
+      /* output is interleaved, so it's fine to stop in the middle of IQ pair */
       const int16_t *ldw = (const int16_t *)vp;
-      for (;unalign < 32; unalign += 4, i -= 4) {
-          if (i == 0)
+      for (;unalign < 32; unalign += 2, i -= 2) {
+          if (i < 2)
               return;
           *(out++) = *(ldw++) * inscale;
-          *(out++) = *(ldw++) * inscale;
       }
       vp = (const __m128i* )ldw;
   }
 #endif
+  const int out_aligned = IS_ALIGNED(out, 16);
 
   if (i >= 32) {
       t0 = _mm_load_si128(vp++);
@@ -392,13 +441,13 @@ void xtrxdsp_iq16_sc32_template(const int16_t *__restrict iq,
           f3 = _mm_cvtepi32_ps(d3);    // Latency 3
 
           f0 = _mm_mul_ps(f0, scale);  // Latency 5
-          _MM_STOREX_PS(out, f0); out+=4;
+          _MM_STOREX_PS(out_aligned, out, f0); out+=4;
           f1 = _mm_mul_ps(f1, scale);
-          _MM_STOREX_PS(out, f1); out+=4;
+          _MM_STOREX_PS(out_aligned, out, f1); out+=4;
           f2 = _mm_mul_ps(f2, scale);  // Latency 5
-          _MM_STOREX_PS(out, f2); out+=4;
+          _MM_STOREX_PS(out_aligned, out, f2); out+=4;
           f3 = _mm_mul_ps(f3, scale);
-          _MM_STOREX_PS(out, f3); out+=4;
+          _MM_STOREX_PS(out_aligned, out, f3); out+=4;
       }
 
       i -= 32;
@@ -419,13 +468,13 @@ void xtrxdsp_iq16_sc32_template(const int16_t *__restrict iq,
       f3 = _mm_cvtepi32_ps(d3);    // Latency 3
 
       f0 = _mm_mul_ps(f0, scale);  // Latency 5
-      _MM_STOREX_PS(out, f0); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f0); out+=4;
       f1 = _mm_mul_ps(f1, scale);
-      _MM_STOREX_PS(out, f1); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f1); out+=4;
       f2 = _mm_mul_ps(f2, scale);  // Latency 5
-      _MM_STOREX_PS(out, f2); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f2); out+=4;
       f3 = _mm_mul_ps(f3, scale);
-      _MM_STOREX_PS(out, f3); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f3); out+=4;
 
       if (i == 0)
           return;
@@ -444,24 +493,17 @@ void xtrxdsp_iq16_sc32_template(const int16_t *__restrict iq,
       f1 = _mm_cvtepi32_ps(d1);    // Latency 3
 
       f0 = _mm_mul_ps(f0, scale);  // Latency 5
-      _MM_STOREX_PS(out, f0); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f0); out+=4;
       f1 = _mm_mul_ps(f1, scale);
-      _MM_STOREX_PS(out, f1); out+=4;
+      _MM_STOREX_PS(out_aligned, out, f1); out+=4;
   }
 
   // remaining part
   if (unlikely(i > 0)) {
       const int16_t *ldw = (const int16_t *)vp;
-      //for (;i != i % 4; i -= 4) {
-      switch (i) {
-      case 8:
-          *(out++) = *(ldw++) * inscale;
-          *(out++) = *(ldw++) * inscale;
-      case 4:
-          *(out++) = *(ldw++) * inscale;
+      for (; i > 1; i -= 2) {
           *(out++) = *(ldw++) * inscale;
       }
-      //}
   }
 }
 #endif
@@ -486,39 +528,31 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
   __m128i t0;
   __m128i t1;
 
+  int in_aligned = 1;
 #ifdef UNALIGN_IQ_BUFFER
   size_t unalign;
-  /* Check for unalign start of IQ */
-  if (unlikely((unalign = ((uintptr_t)iq & 0x18))) > 0) {
+  if (unlikely((uintptr_t)iq & 0x2)) {
+      /* IQ pairs straddle 4 byte boundary, no prologue aligns them, so
+       * vector loop goes with unaligned loads from the first pair
+       */
+      in_aligned = 0;
+  } else if (unlikely((unalign = ((uintptr_t)iq & 0x1c))) > 0) {
+      /* Unalign start of IQ */
       const int16_t *ldw = (const int16_t *)vp;
-      for (;unalign < 32; unalign += 8, i-= 8) {
-          if (i == 0)
-              return;
-#if 0
-          *(outa++) = *(ldw++) * inscale;
-          *(outb++) = *(ldw++) * inscale;
+      for (;unalign < 32; unalign += 4, i -= 4) {
+          if (i < 4)
+              break;
           *(outa++) = *(ldw++) * inscale;
           *(outb++) = *(ldw++) * inscale;
-#else
-          t0 = _mm_loadl_epi64((const __m128i* )ldw); ldw += 4;
-          d0 = _mm_and_si128(t0, ands); // B3..B0
-          d1 = _mm_slli_si128(t0, 2);
-          f1 = _mm_cvtepi32_ps(d0);     // Latency 3
-          d1 = _mm_and_si128(d1, ands); // A3..A0
-          f0 = _mm_cvtepi32_ps(d1);     // Latency 3
-          z0 = _mm_mul_ps(f0, scale);   // Latency 5
-          _mm_storel_epi64(( __m128i* )outa, _mm_castps_si128(z0)); outa+=2;
-          z1 = _mm_mul_ps(f1, scale);
-          _mm_storel_epi64(( __m128i* )outb, _mm_castps_si128(z1)); outb+=2;
-#endif
       }
       vp = (const __m128i* )ldw;
   }
 #endif
+  const int out_aligned = IS_ALIGNED(outa, 16) && IS_ALIGNED(outb, 16);
 
   if (i >= 32) {
-      t0 = _mm_load_si128(vp++);
-      t1 = _mm_load_si128(vp++);
+      t0 = _MM_LOADX_SI128(in_aligned, vp++);
+      t1 = _MM_LOADX_SI128(in_aligned, vp++);
 
       for (; i >= 64; i -= 32) {
           d0 = _mm_and_si128(t0, ands); // B3..B0
@@ -526,8 +560,8 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
           d2 = _mm_and_si128(t1, ands); // B7..B4
           d3 = _mm_slli_si128(t1, 2);
 
-          t0 = _mm_load_si128(vp++);
-          t1 = _mm_load_si128(vp++);
+          t0 = _MM_LOADX_SI128(in_aligned, vp++);
+          t1 = _MM_LOADX_SI128(in_aligned, vp++);
 
           d1 = _mm_and_si128(d1, ands); // A3..A0
           f1 = _mm_cvtepi32_ps(d0);    // Latency 3
@@ -539,13 +573,13 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
           f3 = _mm_cvtepi32_ps(d2);    // Latency 3
 
           z0 = _mm_mul_ps(f0, scale);  // Latency 5
-          _MM_STOREX_PS(outa, z0); outa+=4;
+          _MM_STOREX_PS(out_aligned, outa, z0); outa+=4;
           z1 = _mm_mul_ps(f1, scale);
-          _MM_STOREX_PS(outb, z1); outb+=4;
+          _MM_STOREX_PS(out_aligned, outb, z1); outb+=4;
           z2 = _mm_mul_ps(f2, scale);  // Latency 5
-          _MM_STOREX_PS(outa, z2); outa+=4;
+          _MM_STOREX_PS(out_aligned, outa, z2); outa+=4;
           z3 = _mm_mul_ps(f3, scale);
-          _MM_STOREX_PS(outb, z3); outb+=4;
+          _MM_STOREX_PS(out_aligned, outb, z3); outb+=4;
       }
 
       i -= 32;
@@ -556,7 +590,7 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
       d3 = _mm_slli_si128(t1, 2);
 
       if (i >= 16) {
-         t0 = _mm_load_si128(vp++);
+         t0 = _MM_LOADX_SI128(in_aligned, vp++);
       }
 
       d1 = _mm_and_si128(d1, ands); // A3..A0
@@ -569,18 +603,18 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
       f3 = _mm_cvtepi32_ps(d2);    // Latency 3
 
       z0 = _mm_mul_ps(f0, scale);  // Latency 5
-      _MM_STOREX_PS(outa, z0); outa+=4;
+      _MM_STOREX_PS(out_aligned, outa, z0); outa+=4;
       z1 = _mm_mul_ps(f1, scale);
-      _MM_STOREX_PS(outb, z1); outb+=4;
+      _MM_STOREX_PS(out_aligned, outb, z1); outb+=4;
       z2 = _mm_mul_ps(f2, scale);  // Latency 5
-      _MM_STOREX_PS(outa, z2); outa+=4;
+      _MM_STOREX_PS(out_aligned, outa, z2); outa+=4;
       z3 = _mm_mul_ps(f3, scale);
-      _MM_STOREX_PS(outb, z3); outb+=4;
+      _MM_STOREX_PS(out_aligned, outb, z3); outb+=4;
 
       if (i == 0)
           return;
   } else if (i >= 16) {
-      t0 = _mm_load_si128(vp++);
+      t0 = _MM_LOADX_SI128(in_aligned, vp++);
   }
 
   if (unlikely(i >= 16)) {
@@ -597,38 +631,25 @@ void xtrxdsp_iq16_sc32i_template(const int16_t *__restrict iq,
       f0 = _mm_mul_ps(f0, scale);  // Latency 5
       f1 = _mm_mul_ps(f1, scale);
 
-      _MM_STOREX_PS(outa, f0); outa += 4;
-      _MM_STOREX_PS(outb, f1); outb += 4;
+      _MM_STOREX_PS(out_aligned, outa, f0); outa += 4;
+      _MM_STOREX_PS(out_aligned, outb, f1); outb += 4;
   }
 
-  /* remaining part unaligned part */
+  /* remaining IQ pairs, a lone I is converted the same way as in generic code */
   if (i > 0) {
       const int16_t *ldw = (const int16_t *)vp;
-      /* only 8 remaining bytes are possible here */
-      //for (;i != i % 8; i -= 8) {
-#if 0
-      *(outa++) = *(ldw++) * inscale;
-      *(outb++) = *(ldw++) * inscale;
-      *(outa++) = *(ldw++) * inscale;
-      *(outb++) = *(ldw++) * inscale;
-#else
-      t0 = _mm_loadl_epi64((const __m128i* )ldw); //ldw += 4;
-      d0 = _mm_and_si128(t0, ands); // B3..B0
-      d1 = _mm_slli_si128(t0, 2);
-      f1 = _mm_cvtepi32_ps(d0);     // Latency 3
-      d1 = _mm_and_si128(d1, ands); // A3..A0
-      f0 = _mm_cvtepi32_ps(d1);     // Latency 3
-      z0 = _mm_mul_ps(f0, scale);   // Latency 5
-      _mm_storel_epi64(( __m128i* )outa, _mm_castps_si128(z0)); //outa+=2;
-      z1 = _mm_mul_ps(f1, scale);
-      _mm_storel_epi64(( __m128i* )outb, _mm_castps_si128(z1)); //outb+=2;
-#endif
-      //}
+      for (; i > 3; i -= 4) {
+          *(outa++) = *(ldw++) * inscale;
+          *(outb++) = *(ldw++) * inscale;
+      }
+      if (i > 1)
+          *(outa++) = *(ldw++) * inscale;
   }
 }
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_B8_EXPAND_X2
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_B8_EXPAND_X2_FUNC(XTRXDSP_TEMPLATE_B8_EXPAND_X2_NAME)
 {
     unsigned n, q;
@@ -642,6 +663,7 @@ DECLARE_B8_EXPAND_X2_FUNC(XTRXDSP_TEMPLATE_B8_EXPAND_X2_NAME)
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_B8_EXPAND_X4
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_B8_EXPAND_X4_FUNC(XTRXDSP_TEMPLATE_B8_EXPAND_X4_NAME)
 {
     unsigned n, q;
@@ -655,6 +677,7 @@ DECLARE_B8_EXPAND_X4_FUNC(XTRXDSP_TEMPLATE_B8_EXPAND_X4_NAME)
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_B4_EXPAND_X2
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_B4_EXPAND_X2_FUNC(XTRXDSP_TEMPLATE_B4_EXPAND_X2_NAME)
 {
     unsigned n, q;
@@ -668,6 +691,7 @@ DECLARE_B4_EXPAND_X2_FUNC(XTRXDSP_TEMPLATE_B4_EXPAND_X2_NAME)
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_B4_EXPAND_X4
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_B4_EXPAND_X4_FUNC(XTRXDSP_TEMPLATE_B4_EXPAND_X4_NAME)
 {
     unsigned n, q;
@@ -681,6 +705,7 @@ DECLARE_B4_EXPAND_X4_FUNC(XTRXDSP_TEMPLATE_B4_EXPAND_X4_NAME)
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_SC32_CONV64
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_SC32_CONV64_FUNC(XTRXDSP_TEMPLATE_SC32_CONV64_NAME)
 {
     unsigned i, n;
@@ -701,6 +726,7 @@ DECLARE_SC32_CONV64_FUNC(XTRXDSP_TEMPLATE_SC32_CONV64_NAME)
 #endif
 
 #ifdef XTRXDSP_TEMPLATE_IQ16_CONV64
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_IQ16_CONV64_FUNC(XTRXDSP_TEMPLATE_IQ16_CONV64_NAME)
 {
     unsigned i, n;
@@ -723,7 +749,7 @@ DECLARE_IQ16_CONV64_FUNC(XTRXDSP_TEMPLATE_IQ16_CONV64_NAME)
 
 
 #ifdef XTRXDSP_TEMPLATE_SC32_CONV64_AVX
-static __m256 conv_shuffle_filter_taps_avx(__m256 fi)
+static inline __m256 conv_shuffle_filter_taps_avx(__m256 fi)
 {
     // [f0 f1 f2 f3]
     __m128 lo = _mm256_castps256_ps128(fi);
@@ -738,6 +764,7 @@ static __m256 conv_shuffle_filter_taps_avx(__m256 fi)
 }
 
 __attribute__((optimize("unroll-loops")))
+XTRXDSP_TEMPLATE_LINKAGE
 DECLARE_SC32_CONV64_FUNC(XTRXDSP_TEMPLATE_SC32_CONV64_NAME)
 {
     unsigned i, n;
@@ -915,8 +942,8 @@ void xtrxdsp_sc32i_iq16_template(const float *__restrict i,
         o0 = _mm256_or_si256(sni0, snq0);
         o1 = _mm256_or_si256(sni1, snq1);
 
-        _mm256_storeu_si256(out, o0);
-        _mm256_storeu_si256(out + 16, o1);
+        _mm256_storeu_si256((__m256i*)out, o0);
+        _mm256_storeu_si256((__m256i*)(out + 16), o1);
 #else
         sni0 = _mm256_andnot_ps(_mm256_castsi256_ps(andmask), _mm256_castsi256_ps(ni0));
         sni1 = _mm256_andnot_ps(_mm256_castsi256_ps(andmask), _mm256_castsi256_ps(ni1));
@@ -939,3 +966,2777 @@ void xtrxdsp_sc32i_iq16_template(const float *__restrict i,
 }
 #endif
 
+
+
+/*********************************************************************************************/
+/* NCO */
+
+#if defined(XTRXDSP_TEMPLATE_SC32_NCO) || defined(XTRXDSP_TEMPLATE_SC32_NCO_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_SC32_NCO_AVX) || defined(XTRXDSP_TEMPLATE_IC16_NCO) || \
+    defined(XTRXDSP_TEMPLATE_IC16_NCO_SSE2) || defined(XTRXDSP_TEMPLATE_SC32_NCO_IQ16) || \
+    defined(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_SSE2) || defined(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_AVX)
+#include <math.h>
+
+/* Phasor is recomputed from the exact phase accumulator every NCO_CHUNK
+ * samples, so the recurrence error never accumulates
+ */
+#define NCO_CHUNK      256
+#define NCO_PHASE2RAD  (2 * M_PI / 4294967296.0)
+
+static inline void nco_phasor(uint32_t phase, float* c, float* s)
+{
+    float r = (int32_t)phase * (float)NCO_PHASE2RAD;
+    *c = cosf(r);
+    *s = sinf(r);
+}
+
+/* lanes[2*k], lanes[2*k + 1] = exp(j * k * dphase), k = 0 .. cnt */
+static inline void nco_lanes(uint32_t dphase, float* lanes, unsigned cnt)
+{
+    double r = (int32_t)dphase * NCO_PHASE2RAD;
+    double c1 = cos(r), s1 = sin(r);
+    double c = 1, s = 0, t;
+    unsigned k;
+
+    for (k = 0; k <= cnt; k++) {
+        lanes[2*k + 0] = c;
+        lanes[2*k + 1] = s;
+
+        t = c * c1 - s * s1;
+        s = c * s1 + s * c1;
+        c = t;
+    }
+}
+
+static inline uint32_t nco_sc32_scalar(const float *__restrict in,
+                                       float *__restrict out,
+                                       unsigned count,
+                                       uint32_t phase,
+                                       uint32_t dphase)
+{
+    /* scalar recurrence runs 4x longer than vector ones, keep it in double */
+    double r = (int32_t)dphase * NCO_PHASE2RAD;
+    double sc = cos(r), ss = sin(r);
+    double pc, ps, t;
+    float vi, vq, c, s;
+    unsigned n, m;
+
+    for (n = 0; n < count; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : count - n;
+        nco_phasor(phase, &c, &s);
+        pc = c;
+        ps = s;
+
+        for (unsigned j = 0; j < m; j++, n++) {
+            vi = in[2*n];
+            vq = in[2*n + 1];
+            out[2*n]     = vi * pc - vq * ps;
+            out[2*n + 1] = vi * ps + vq * pc;
+
+            t  = pc * sc - ps * ss;
+            ps = pc * ss + ps * sc;
+            pc = t;
+        }
+    }
+    return phase;
+}
+
+static inline int16_t nco_sat16(float v)
+{
+    long r = lrintf(v);
+    return (r > INT16_MAX) ? INT16_MAX : (r < INT16_MIN) ? INT16_MIN : r;
+}
+
+static inline uint32_t nco_ic16_scalar(const int16_t *__restrict in,
+                                       int16_t *__restrict out,
+                                       unsigned count,
+                                       uint32_t phase,
+                                       uint32_t dphase)
+{
+    /* scalar recurrence runs 4x longer than vector ones, keep it in double */
+    double r = (int32_t)dphase * NCO_PHASE2RAD;
+    double sc = cos(r), ss = sin(r);
+    double pc, ps, t;
+    float vi, vq, c, s;
+    unsigned n, m;
+
+    for (n = 0; n < count; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : count - n;
+        nco_phasor(phase, &c, &s);
+        pc = c;
+        ps = s;
+
+        for (unsigned j = 0; j < m; j++, n++) {
+            vi = in[2*n];
+            vq = in[2*n + 1];
+            out[2*n]     = nco_sat16(vi * pc - vq * ps);
+            out[2*n + 1] = nco_sat16(vi * ps + vq * pc);
+
+            t  = pc * sc - ps * ss;
+            ps = pc * ss + ps * sc;
+            pc = t;
+        }
+    }
+    return phase;
+}
+static inline uint32_t nco_sc32_iq16_scalar(const float *__restrict in,
+                                            int16_t *__restrict out,
+                                            unsigned count,
+                                            float scale,
+                                            uint32_t phase,
+                                            uint32_t dphase)
+{
+    double r = (int32_t)dphase * NCO_PHASE2RAD;
+    double sc = cos(r), ss = sin(r);
+    double pc, ps, t;
+    float vi, vq, c, s;
+    unsigned n, m;
+
+    for (n = 0; n < count; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : count - n;
+        nco_phasor(phase, &c, &s);
+        pc = c * scale;
+        ps = s * scale;
+
+        for (unsigned j = 0; j < m; j++, n++) {
+            vi = in[2*n];
+            vq = in[2*n + 1];
+            out[2*n]     = nco_sat16(vi * pc - vq * ps);
+            out[2*n + 1] = nco_sat16(vi * ps + vq * pc);
+
+            t  = pc * sc - ps * ss;
+            ps = pc * ss + ps * sc;
+            pc = t;
+        }
+    }
+    return phase;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO_IQ16
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_IQ16_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_NAME)
+{
+    return nco_sc32_iq16_scalar(in, out, count, scale, phase, dphase);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_NAME)
+{
+    return nco_sc32_scalar(in, out, count, phase, dphase);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16_NCO
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_IC16_NCO_FUNC(XTRXDSP_TEMPLATE_IC16_NCO_NAME)
+{
+    return nco_ic16_scalar(in, out, count, phase, dphase);
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_SC32_NCO_SSE2) || defined(XTRXDSP_TEMPLATE_IC16_NCO_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_SSE2)
+/* x = [a0 b0 a1 b1], p = [c0 d0 c1 d1] */
+static inline __m128 nco_cmul_sse2(__m128 x, __m128 p)
+{
+    const __m128 sign = _mm_castsi128_ps(_mm_set_epi32(0, 0x80000000, 0, 0x80000000));
+    __m128 pr = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0)); // [c0 c0 c1 c1]
+    __m128 pi = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1)); // [d0 d0 d1 d1]
+    __m128 xs = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)); // [b0 a0 b1 a1]
+
+    // [a*c - b*d,  b*c + a*d]
+    return _mm_add_ps(_mm_mul_ps(x, pr), _mm_xor_ps(_mm_mul_ps(xs, pi), sign));
+}
+
+/* p0 = phasors for samples 0,1; p1 for 2,3; step advances both by 4 samples */
+static inline void nco_init_sse2(uint32_t phase, const float* lanes,
+                                 __m128* p0, __m128* p1)
+{
+    float pc, ps;
+    nco_phasor(phase, &pc, &ps);
+
+    __m128 b = _mm_setr_ps(pc, ps, pc, ps);
+    *p0 = nco_cmul_sse2(b, _mm_loadu_ps(lanes));
+    *p1 = nco_cmul_sse2(b, _mm_loadu_ps(lanes + 4));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO_SSE2
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_NAME)
+{
+    float lanes[10];
+    __m128 p0, p1, step, x0, x1;
+    unsigned n = 0, m;
+
+    nco_lanes(dphase, lanes, 4);
+    step = _mm_setr_ps(lanes[8], lanes[9], lanes[8], lanes[9]);
+
+    for (; count - n >= 4; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : (count - n) & ~3u;
+        nco_init_sse2(phase, lanes, &p0, &p1);
+
+        for (unsigned j = 0; j < m; j += 4, n += 4) {
+            x0 = _mm_loadu_ps(in + 2*n);
+            x1 = _mm_loadu_ps(in + 2*n + 4);
+
+            _mm_storeu_ps(out + 2*n,     nco_cmul_sse2(x0, p0));
+            _mm_storeu_ps(out + 2*n + 4, nco_cmul_sse2(x1, p1));
+
+            p0 = nco_cmul_sse2(p0, step);
+            p1 = nco_cmul_sse2(p1, step);
+        }
+    }
+
+    return nco_sc32_scalar(in + 2*n, out + 2*n, count - n, phase, dphase);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16_NCO_SSE2
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_IC16_NCO_FUNC(XTRXDSP_TEMPLATE_IC16_NCO_NAME)
+{
+    float lanes[10];
+    __m128 p0, p1, step;
+    __m128i t0, i0, i1;
+    unsigned n = 0, m;
+
+    nco_lanes(dphase, lanes, 4);
+    step = _mm_setr_ps(lanes[8], lanes[9], lanes[8], lanes[9]);
+
+    for (; count - n >= 4; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : (count - n) & ~3u;
+        nco_init_sse2(phase, lanes, &p0, &p1);
+
+        for (unsigned j = 0; j < m; j += 4, n += 4) {
+            t0 = _mm_loadu_si128((const __m128i*)(in + 2*n));
+            i0 = _mm_srai_epi32(_mm_unpacklo_epi16(t0, t0), 16);
+            i1 = _mm_srai_epi32(_mm_unpackhi_epi16(t0, t0), 16);
+
+            i0 = _mm_cvtps_epi32(nco_cmul_sse2(_mm_cvtepi32_ps(i0), p0));
+            i1 = _mm_cvtps_epi32(nco_cmul_sse2(_mm_cvtepi32_ps(i1), p1));
+
+            _mm_storeu_si128((__m128i*)(out + 2*n), _mm_packs_epi32(i0, i1));
+
+            p0 = nco_cmul_sse2(p0, step);
+            p1 = nco_cmul_sse2(p1, step);
+        }
+    }
+
+    return nco_ic16_scalar(in + 2*n, out + 2*n, count - n, phase, dphase);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO_IQ16_SSE2
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_IQ16_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_NAME)
+{
+    float lanes[10];
+    __m128 p0, p1, step, vscale;
+    __m128i i0, i1;
+    unsigned n = 0, m;
+
+    nco_lanes(dphase, lanes, 4);
+    step = _mm_setr_ps(lanes[8], lanes[9], lanes[8], lanes[9]);
+    vscale = _mm_set1_ps(scale);
+
+    for (; count - n >= 4; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : (count - n) & ~3u;
+        nco_init_sse2(phase, lanes, &p0, &p1);
+        p0 = _mm_mul_ps(p0, vscale);
+        p1 = _mm_mul_ps(p1, vscale);
+
+        for (unsigned j = 0; j < m; j += 4, n += 4) {
+            i0 = _mm_cvtps_epi32(nco_cmul_sse2(_mm_loadu_ps(in + 2*n), p0));
+            i1 = _mm_cvtps_epi32(nco_cmul_sse2(_mm_loadu_ps(in + 2*n + 4), p1));
+
+            _mm_storeu_si128((__m128i*)(out + 2*n), _mm_packs_epi32(i0, i1));
+
+            p0 = nco_cmul_sse2(p0, step);
+            p1 = nco_cmul_sse2(p1, step);
+        }
+    }
+
+    return nco_sc32_iq16_scalar(in + 2*n, out + 2*n, count - n, scale, phase, dphase);
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_SC32_NCO_AVX) || defined(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_AVX)
+/* x = [a0 b0 a1 b1 a2 b2 a3 b3], p = [c0 d0 c1 d1 c2 d2 c3 d3] */
+static inline __m256 nco_cmul_avx(__m256 x, __m256 p)
+{
+    __m256 pr = _mm256_moveldup_ps(p);
+    __m256 pi = _mm256_movehdup_ps(p);
+    __m256 xs = _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1));
+
+    return _mm256_addsub_ps(_mm256_mul_ps(x, pr), _mm256_mul_ps(xs, pi));
+}
+
+static inline void nco_init_avx(uint32_t phase, const float* lanes,
+                                __m256* p0, __m256* p1)
+{
+    float pc, ps;
+    nco_phasor(phase, &pc, &ps);
+
+    __m256 b = _mm256_setr_ps(pc, ps, pc, ps, pc, ps, pc, ps);
+    *p0 = nco_cmul_avx(b, _mm256_loadu_ps(lanes));
+    *p1 = nco_cmul_avx(b, _mm256_loadu_ps(lanes + 8));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO_AVX
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_NAME)
+{
+    float lanes[18];
+    __m256 p0, p1, step, x0, x1;
+    unsigned n = 0, m;
+
+    nco_lanes(dphase, lanes, 8);
+    step = _mm256_setr_ps(lanes[16], lanes[17], lanes[16], lanes[17],
+                          lanes[16], lanes[17], lanes[16], lanes[17]);
+
+    for (; count - n >= 8; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : (count - n) & ~7u;
+        nco_init_avx(phase, lanes, &p0, &p1);
+
+        for (unsigned j = 0; j < m; j += 8, n += 8) {
+            x0 = _mm256_loadu_ps(in + 2*n);
+            x1 = _mm256_loadu_ps(in + 2*n + 8);
+
+            _mm256_storeu_ps(out + 2*n,     nco_cmul_avx(x0, p0));
+            _mm256_storeu_ps(out + 2*n + 8, nco_cmul_avx(x1, p1));
+
+            p0 = nco_cmul_avx(p0, step);
+            p1 = nco_cmul_avx(p1, step);
+        }
+    }
+
+    return nco_sc32_scalar(in + 2*n, out + 2*n, count - n, phase, dphase);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_NCO_IQ16_AVX
+XTRXDSP_TEMPLATE_LINKAGE
+DECLARE_SC32_NCO_IQ16_FUNC(XTRXDSP_TEMPLATE_SC32_NCO_IQ16_NAME)
+{
+    float lanes[18];
+    __m256 p0, p1, step, vscale;
+    __m256i i0, i1;
+    unsigned n = 0, m;
+
+    nco_lanes(dphase, lanes, 8);
+    step = _mm256_setr_ps(lanes[16], lanes[17], lanes[16], lanes[17],
+                          lanes[16], lanes[17], lanes[16], lanes[17]);
+    vscale = _mm256_set1_ps(scale);
+
+    for (; count - n >= 8; phase += dphase * m) {
+        m = (count - n > NCO_CHUNK) ? NCO_CHUNK : (count - n) & ~7u;
+        nco_init_avx(phase, lanes, &p0, &p1);
+        p0 = _mm256_mul_ps(p0, vscale);
+        p1 = _mm256_mul_ps(p1, vscale);
+
+        for (unsigned j = 0; j < m; j += 8, n += 8) {
+            i0 = _mm256_cvtps_epi32(nco_cmul_avx(_mm256_loadu_ps(in + 2*n), p0));
+            i1 = _mm256_cvtps_epi32(nco_cmul_avx(_mm256_loadu_ps(in + 2*n + 8), p1));
+
+            /* AVX has no 256-bit integer pack, saturate by 128-bit halves */
+            _mm_storeu_si128((__m128i*)(out + 2*n),
+                             _mm_packs_epi32(_mm256_castsi256_si128(i0),
+                                             _mm256_extractf128_si256(i0, 1)));
+            _mm_storeu_si128((__m128i*)(out + 2*n + 8),
+                             _mm_packs_epi32(_mm256_castsi256_si128(i1),
+                                             _mm256_extractf128_si256(i1, 1)));
+
+            p0 = nco_cmul_avx(p0, step);
+            p1 = nco_cmul_avx(p1, step);
+        }
+    }
+
+    return nco_sc32_iq16_scalar(in + 2*n, out + 2*n, count - n, scale, phase, dphase);
+}
+#endif
+
+/*********************************************************************************************/
+/* IQ correction */
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32_CORR) || defined(XTRXDSP_TEMPLATE_IQ16_SC32I_CORR) || \
+    defined(XTRXDSP_TEMPLATE_IQ12_SC32_CORR) || defined(XTRXDSP_TEMPLATE_IQ16_SC32_CORR_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_SC32I_CORR_SSE2)
+static inline void iqcorr_scalar(const xtrxdsp_iqcorr_t *__restrict corr,
+                                 float i, float q,
+                                 float *__restrict oi,
+                                 float *__restrict oq)
+{
+    *oi = corr->m_ii * i + corr->m_iq * q + corr->dc_i;
+    *oq = corr->m_qi * i + corr->m_qq * q + corr->dc_q;
+}
+
+static inline void iqcorr_stat_add(xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                   float i, float q)
+{
+    stat->sum_i += i;
+    stat->sum_q += q;
+    stat->sum_ii += (double)i * i;
+    stat->sum_qq += (double)q * q;
+    stat->sum_iq += (double)i * q;
+    stat->count++;
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32_CORR_SSE2) || defined(XTRXDSP_TEMPLATE_IQ16_SC32I_CORR_SSE2)
+/* vector sums are kept in float for this many input bytes, i.e. 256 complex
+ * samples, and then moved to the double sums
+ */
+#define IQCORR_STAT_BLOCK 1024
+
+static inline double iqcorr_hsum(__m128 v)
+{
+    float t[4];
+    _mm_storeu_ps(t, v);
+    return ((double)t[0] + t[1]) + ((double)t[2] + t[3]);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_CORR
+static inline
+void xtrxdsp_iq16_sc32_corr_template(const int16_t *__restrict iq,
+                                     float *__restrict out,
+                                     const xtrxdsp_iqcorr_t *__restrict corr,
+                                     xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                     size_t bytes)
+{
+    for (; bytes > 3; bytes -= 4, iq += 2, out += 2) {
+        iqcorr_scalar(corr, iq[0], iq[1], &out[0], &out[1]);
+        if (stat)
+            iqcorr_stat_add(stat, out[0], out[1]);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_CORR
+static inline
+void xtrxdsp_iq16_sc32i_corr_template(const int16_t *__restrict iq,
+                                      float *__restrict outa,
+                                      float *__restrict outb,
+                                      const xtrxdsp_iqcorr_t *__restrict corr,
+                                      xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                      size_t bytes)
+{
+    for (; bytes > 3; bytes -= 4, iq += 2, outa++, outb++) {
+        iqcorr_scalar(corr, iq[0], iq[1], outa, outb);
+        if (stat)
+            iqcorr_stat_add(stat, *outa, *outb);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32_CORR
+static inline
+uint64_t xtrxdsp_iq12_sc32_corr_template(const void *__restrict iq,
+                                         float *__restrict out,
+                                         const xtrxdsp_iqcorr_t *__restrict corr,
+                                         xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                         size_t inbytes,
+                                         uint64_t prevstate)
+{
+    const uint8_t *ld = (const uint8_t *)iq;
+    size_t i  = 0;
+    uint8_t v0, v1, v2;
+    float a, b;
+    unsigned q;
+
+    /* same layout and carry state as in xtrxdsp_iq12_sc32_template() */
+    q = prevstate & 0xf;
+    if (q > 2)
+        return -1;
+
+    if (q > 0) {
+        uint8_t v[3];
+        v[0] = (prevstate >> 8) & 0xff;
+        v[1] = (prevstate >> 16) & 0xff;
+
+        for (; q < 3 && i < inbytes; q++, i++) {
+            v[q] = *(ld++);
+        }
+        if (q < 3) {
+            return q | ((unsigned)v[0] << 8) | ((unsigned)v[1] << 16);
+        }
+
+        a = (int16_t) (((uint16_t)v[0] << 4) | ((uint16_t)v[1] << 12));
+        b = (int16_t) (((uint16_t)v[2] << 8) | (v[1] & 0xf0));
+
+        iqcorr_scalar(corr, a, b, &out[0], &out[1]);
+        if (stat)
+            iqcorr_stat_add(stat, out[0], out[1]);
+        out += 2;
+    }
+
+    for (; i + 3 <= inbytes; i += 3, out += 2) {
+        v0 = *(ld++);
+        v1 = *(ld++);
+        v2 = *(ld++);
+
+        a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        iqcorr_scalar(corr, a, b, &out[0], &out[1]);
+        if (stat)
+            iqcorr_stat_add(stat, out[0], out[1]);
+    }
+
+    switch (inbytes - i) {
+    default:
+        return 0;
+    case 1:
+        return 1 | ((unsigned)(*ld) << 8);
+    case 2:
+        q = (*ld++);
+        return (2 | (q << 8)) | ((unsigned)(*ld) << 16);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_CORR_SSE2
+static inline
+void xtrxdsp_iq16_sc32_corr_template(const int16_t *__restrict iq,
+                                     float *__restrict out,
+                                     const xtrxdsp_iqcorr_t *__restrict corr,
+                                     xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                     size_t bytes)
+{
+    const __m128 ma = _mm_setr_ps(corr->m_ii, corr->m_qq, corr->m_ii, corr->m_qq);
+    const __m128 mb = _mm_setr_ps(corr->m_iq, corr->m_qi, corr->m_iq, corr->m_qi);
+    const __m128 o  = _mm_setr_ps(corr->dc_i, corr->dc_q, corr->dc_i, corr->dc_q);
+    __m128i t, d0, d1;
+    __m128 f0, f1, s0, s1;
+    __m128 vs, vss, vx;
+    const size_t total = bytes;
+    size_t blk;
+    float m[4];
+
+    while (bytes >= 16) {
+        blk = (bytes > IQCORR_STAT_BLOCK) ? IQCORR_STAT_BLOCK : (bytes & ~(size_t)15);
+        bytes -= blk;
+        vs = vss = vx = _mm_setzero_ps();
+
+        for (; blk != 0; blk -= 16, iq += 8, out += 8) {
+            t  = _mm_loadu_si128((const __m128i*)iq);
+            d0 = _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16); // I0 Q0 I1 Q1
+            d1 = _mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16); // I2 Q2 I3 Q3
+
+            f0 = _mm_cvtepi32_ps(d0);
+            f1 = _mm_cvtepi32_ps(d1);
+            s0 = _mm_shuffle_ps(f0, f0, _MM_SHUFFLE(2, 3, 0, 1));
+            s1 = _mm_shuffle_ps(f1, f1, _MM_SHUFFLE(2, 3, 0, 1));
+
+            f0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(f0, ma), _mm_mul_ps(s0, mb)), o);
+            f1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(f1, ma), _mm_mul_ps(s1, mb)), o);
+
+            _mm_storeu_ps(out, f0);
+            _mm_storeu_ps(out + 4, f1);
+
+            if (stat) {
+                /* I Q I Q sums and squares, every lane of vx is I * Q */
+                s0 = _mm_shuffle_ps(f0, f0, _MM_SHUFFLE(2, 3, 0, 1));
+                s1 = _mm_shuffle_ps(f1, f1, _MM_SHUFFLE(2, 3, 0, 1));
+                vs  = _mm_add_ps(vs, _mm_add_ps(f0, f1));
+                vss = _mm_add_ps(vss, _mm_add_ps(_mm_mul_ps(f0, f0), _mm_mul_ps(f1, f1)));
+                vx  = _mm_add_ps(vx, _mm_add_ps(_mm_mul_ps(f0, s0), _mm_mul_ps(f1, s1)));
+            }
+        }
+
+        if (stat) {
+            _mm_storeu_ps(m, vs);
+            stat->sum_i += (double)m[0] + m[2];
+            stat->sum_q += (double)m[1] + m[3];
+            _mm_storeu_ps(m, vss);
+            stat->sum_ii += (double)m[0] + m[2];
+            stat->sum_qq += (double)m[1] + m[3];
+            stat->sum_iq += iqcorr_hsum(vx) / 2;
+        }
+    }
+    if (stat)
+        stat->count += (total - bytes) / 4;
+
+    for (; bytes > 3; bytes -= 4, iq += 2, out += 2) {
+        iqcorr_scalar(corr, iq[0], iq[1], &out[0], &out[1]);
+        if (stat)
+            iqcorr_stat_add(stat, out[0], out[1]);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_CORR_SSE2
+static inline
+void xtrxdsp_iq16_sc32i_corr_template(const int16_t *__restrict iq,
+                                      float *__restrict outa,
+                                      float *__restrict outb,
+                                      const xtrxdsp_iqcorr_t *__restrict corr,
+                                      xtrxdsp_iqcorr_stat_t *__restrict stat,
+                                      size_t bytes)
+{
+    const __m128 mii = _mm_set1_ps(corr->m_ii);
+    const __m128 miq = _mm_set1_ps(corr->m_iq);
+    const __m128 mqi = _mm_set1_ps(corr->m_qi);
+    const __m128 mqq = _mm_set1_ps(corr->m_qq);
+    const __m128 oi  = _mm_set1_ps(corr->dc_i);
+    const __m128 oq  = _mm_set1_ps(corr->dc_q);
+    __m128i t;
+    __m128 fi, fq, ra, rb;
+    __m128 si, sq, sii, sqq, siq;
+    const size_t total = bytes;
+    size_t blk;
+
+    while (bytes >= 16) {
+        blk = (bytes > IQCORR_STAT_BLOCK) ? IQCORR_STAT_BLOCK : (bytes & ~(size_t)15);
+        bytes -= blk;
+        si = sq = sii = sqq = siq = _mm_setzero_ps();
+
+        for (; blk != 0; blk -= 16, iq += 8, outa += 4, outb += 4) {
+            t  = _mm_loadu_si128((const __m128i*)iq);
+            fi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(t, 16), 16));
+            fq = _mm_cvtepi32_ps(_mm_srai_epi32(t, 16));
+
+            ra = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fi, mii), _mm_mul_ps(fq, miq)), oi);
+            rb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fi, mqi), _mm_mul_ps(fq, mqq)), oq);
+            _mm_storeu_ps(outa, ra);
+            _mm_storeu_ps(outb, rb);
+
+            if (stat) {
+                si  = _mm_add_ps(si, ra);
+                sq  = _mm_add_ps(sq, rb);
+                sii = _mm_add_ps(sii, _mm_mul_ps(ra, ra));
+                sqq = _mm_add_ps(sqq, _mm_mul_ps(rb, rb));
+                siq = _mm_add_ps(siq, _mm_mul_ps(ra, rb));
+            }
+        }
+
+        if (stat) {
+            stat->sum_i += iqcorr_hsum(si);
+            stat->sum_q += iqcorr_hsum(sq);
+            stat->sum_ii += iqcorr_hsum(sii);
+            stat->sum_qq += iqcorr_hsum(sqq);
+            stat->sum_iq += iqcorr_hsum(siq);
+        }
+    }
+    if (stat)
+        stat->count += (total - bytes) / 4;
+
+    for (; bytes > 3; bytes -= 4, iq += 2, outa++, outb++) {
+        iqcorr_scalar(corr, iq[0], iq[1], outa, outb);
+        if (stat)
+            iqcorr_stat_add(stat, *outa, *outb);
+    }
+}
+#endif
+
+/*********************************************************************************************/
+/* Output fixups */
+
+#if defined(XTRXDSP_TEMPLATE_SC32_FIXUP) || defined(XTRXDSP_TEMPLATE_IC16_FIXUP) || \
+    defined(XTRXDSP_TEMPLATE_SC32_FIXUP_SSE2) || defined(XTRXDSP_TEMPLATE_IC16_FIXUP_SSE2)
+/* signed gains of the output I and Q */
+static inline void fixup_gains(const xtrxdsp_iqcorr_t *__restrict corr,
+                               float *gi, float *gq)
+{
+    *gi = (corr->flags & XTRXDSP_IQCORR_NEG_I) ? -corr->gain_i : corr->gain_i;
+    *gq = (corr->flags & XTRXDSP_IQCORR_NEG_Q) ? -corr->gain_q : corr->gain_q;
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IC16_FIXUP) || defined(XTRXDSP_TEMPLATE_IC16_FIXUP_SSE2)
+/* truncation with saturation, the same as cvttps2dq of the clamped value */
+static inline int16_t fixup_ic16(int16_t v, float g)
+{
+    float t = v * g;
+    if (t > 32767)
+        t = 32767;
+    else if (t < -32768)
+        t = -32768;
+    return (int16_t)t;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_FIXUP
+static inline
+void xtrxdsp_sc32_fixup_template(float *iq,
+                                 const xtrxdsp_iqcorr_t *__restrict corr,
+                                 size_t bytes)
+{
+    const int swap = (corr->flags & XTRXDSP_IQCORR_SWAP_IQ) != 0;
+    float gi, gq, a, b;
+
+    fixup_gains(corr, &gi, &gq);
+    for (; bytes > 7; bytes -= 8, iq += 2) {
+        a = swap ? iq[1] : iq[0];
+        b = swap ? iq[0] : iq[1];
+        iq[0] = a * gi;
+        iq[1] = b * gq;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16_FIXUP
+static inline
+void xtrxdsp_ic16_fixup_template(int16_t *iq,
+                                 const xtrxdsp_iqcorr_t *__restrict corr,
+                                 size_t bytes)
+{
+    const int swap = (corr->flags & XTRXDSP_IQCORR_SWAP_IQ) != 0;
+    float gi, gq;
+    int16_t a, b;
+
+    fixup_gains(corr, &gi, &gq);
+    for (; bytes > 3; bytes -= 4, iq += 2) {
+        a = swap ? iq[1] : iq[0];
+        b = swap ? iq[0] : iq[1];
+        iq[0] = fixup_ic16(a, gi);
+        iq[1] = fixup_ic16(b, gq);
+    }
+}
+#endif
+
+/* swap is a shuffle, unit gains skip the multiplication */
+#ifdef XTRXDSP_TEMPLATE_SC32_FIXUP_SSE2
+static inline
+void xtrxdsp_sc32_fixup_template(float *iq,
+                                 const xtrxdsp_iqcorr_t *__restrict corr,
+                                 size_t bytes)
+{
+    const int swap = (corr->flags & XTRXDSP_IQCORR_SWAP_IQ) != 0;
+    float gi, gq, a, b;
+    __m128 g, v0, v1;
+
+    fixup_gains(corr, &gi, &gq);
+    g = _mm_set_ps(gq, gi, gq, gi);
+
+    if (gi == 1.0f && gq == 1.0f) {
+        if (!swap)
+            return;
+
+        for (; bytes >= 32; bytes -= 32, iq += 8) {
+            v0 = _mm_loadu_ps(iq);
+            v1 = _mm_loadu_ps(iq + 4);
+            _mm_storeu_ps(iq,     _mm_shuffle_ps(v0, v0, _MM_SHUFFLE(2, 3, 0, 1)));
+            _mm_storeu_ps(iq + 4, _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    } else if (swap) {
+        for (; bytes >= 32; bytes -= 32, iq += 8) {
+            v0 = _mm_loadu_ps(iq);
+            v1 = _mm_loadu_ps(iq + 4);
+            _mm_storeu_ps(iq,     _mm_mul_ps(_mm_shuffle_ps(v0, v0, _MM_SHUFFLE(2, 3, 0, 1)), g));
+            _mm_storeu_ps(iq + 4, _mm_mul_ps(_mm_shuffle_ps(v1, v1, _MM_SHUFFLE(2, 3, 0, 1)), g));
+        }
+    } else {
+        for (; bytes >= 32; bytes -= 32, iq += 8) {
+            _mm_storeu_ps(iq,     _mm_mul_ps(_mm_loadu_ps(iq), g));
+            _mm_storeu_ps(iq + 4, _mm_mul_ps(_mm_loadu_ps(iq + 4), g));
+        }
+    }
+
+    for (; bytes > 7; bytes -= 8, iq += 2) {
+        a = swap ? iq[1] : iq[0];
+        b = swap ? iq[0] : iq[1];
+        iq[0] = a * gi;
+        iq[1] = b * gq;
+    }
+}
+#endif
+
+/* gains of +-1 stay in integers, negation saturates as the float path does */
+#ifdef XTRXDSP_TEMPLATE_IC16_FIXUP_SSE2
+static inline
+void xtrxdsp_ic16_fixup_template(int16_t *iq,
+                                 const xtrxdsp_iqcorr_t *__restrict corr,
+                                 size_t bytes)
+{
+    const int swap = (corr->flags & XTRXDSP_IQCORR_SWAP_IQ) != 0;
+    const __m128i zero = _mm_setzero_si128();
+    float gi, gq;
+    int16_t a, b;
+    __m128i v, neg, lo, hi;
+    __m128 g, lim_hi, lim_lo;
+
+    fixup_gains(corr, &gi, &gq);
+
+    if ((gi == 1.0f || gi == -1.0f) && (gq == 1.0f || gq == -1.0f)) {
+        neg = _mm_set_epi16(gq < 0 ? -1 : 0, gi < 0 ? -1 : 0, gq < 0 ? -1 : 0, gi < 0 ? -1 : 0,
+                            gq < 0 ? -1 : 0, gi < 0 ? -1 : 0, gq < 0 ? -1 : 0, gi < 0 ? -1 : 0);
+        if (!swap && gi > 0 && gq > 0)
+            return;
+
+        for (; bytes >= 16; bytes -= 16, iq += 8) {
+            v = _mm_loadu_si128((const __m128i*)iq);
+            if (swap)
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_or_si128(_mm_and_si128(neg, _mm_subs_epi16(zero, v)), _mm_andnot_si128(neg, v));
+            _mm_storeu_si128((__m128i*)iq, v);
+        }
+    } else {
+        g = _mm_set_ps(gq, gi, gq, gi);
+        lim_hi = _mm_set1_ps(32767);
+        lim_lo = _mm_set1_ps(-32768);
+
+        for (; bytes >= 16; bytes -= 16, iq += 8) {
+            v = _mm_loadu_si128((const __m128i*)iq);
+            if (swap)
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            lo = _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), g), lim_hi), lim_lo));
+            hi = _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), g), lim_hi), lim_lo));
+            _mm_storeu_si128((__m128i*)iq, _mm_packs_epi32(lo, hi));
+        }
+    }
+
+    for (; bytes > 3; bytes -= 4, iq += 2) {
+        a = swap ? iq[1] : iq[0];
+        b = swap ? iq[0] : iq[1];
+        iq[0] = fixup_ic16(a, gi);
+        iq[1] = fixup_ic16(b, gq);
+    }
+}
+#endif
+
+/*********************************************************************************************/
+/* Metering */
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32_METER) || defined(XTRXDSP_TEMPLATE_IQ16_SC32I_METER) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_IC16I_METER) || defined(XTRXDSP_TEMPLATE_IQ12_SC32_METER) || \
+    defined(XTRXDSP_TEMPLATE_IQ12_SC32I_METER) || defined(XTRXDSP_TEMPLATE_IQ8_SC32_METER) || \
+    defined(XTRXDSP_TEMPLATE_IQ8_IC16_METER) || defined(XTRXDSP_TEMPLATE_IQ8_SC32I_METER) || \
+    defined(XTRXDSP_TEMPLATE_IQ8_IC16I_METER) || defined(XTRXDSP_TEMPLATE_IQ16_SC32_METER_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_SC32I_METER_SSE2)
+
+/* positive full scale in int16 units, the most negative code is always a clip */
+#define METER_FS16   0x7fff
+#define METER_FS12   0x7ff0
+#define METER_FS8    0x7f00
+
+static inline void meter_add(xtrxdsp_meter_t *__restrict m, unsigned ch,
+                             int32_t v, int32_t fs)
+{
+    uint32_t a = (v < 0) ? -v : v;
+
+    m->sumsq[ch] += (uint32_t)(v * v);
+    if (a > m->peak[ch])
+        m->peak[ch] = a;
+    m->clips[ch] += (v >= fs) | (v == -32768);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_METER
+static inline
+void xtrxdsp_iq16_sc32_meter_template(const int16_t *__restrict iq,
+                                      float *__restrict out,
+                                      float scale,
+                                      xtrxdsp_meter_t *__restrict meter,
+                                      size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 4;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t a = iq[2*i];
+        int16_t b = iq[2*i + 1];
+
+        out[2*i]     = a * scale;
+        out[2*i + 1] = b * scale;
+        meter_add(&m, 0, a, METER_FS16);
+        meter_add(&m, 1, b, METER_FS16);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_METER
+static inline
+void xtrxdsp_iq16_sc32i_meter_template(const int16_t *__restrict iq,
+                                       float *__restrict outa,
+                                       float *__restrict outb,
+                                       float scale,
+                                       xtrxdsp_meter_t *__restrict meter,
+                                       size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 4;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t a = iq[2*i];
+        int16_t b = iq[2*i + 1];
+
+        outa[i] = a * scale;
+        outb[i] = b * scale;
+        meter_add(&m, 0, a, METER_FS16);
+        meter_add(&m, 1, b, METER_FS16);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_IC16I_METER
+static inline
+void xtrxdsp_iq16_ic16i_meter_template(const int16_t *__restrict iq,
+                                       int16_t *__restrict outa,
+                                       int16_t *__restrict outb,
+                                       xtrxdsp_meter_t *__restrict meter,
+                                       size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 4;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t a = iq[2*i];
+        int16_t b = iq[2*i + 1];
+
+        outa[i] = a;
+        outb[i] = b;
+        meter_add(&m, 0, a, METER_FS16);
+        meter_add(&m, 1, b, METER_FS16);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ12_SC32_METER) || defined(XTRXDSP_TEMPLATE_IQ12_SC32I_METER)
+/* same layout and carry state as in xtrxdsp_iq12_sc32_template(), outputs are
+ * written to outa[k * stride] and outb[k * stride]
+ */
+static inline
+uint64_t meter_iq12_template(const void *__restrict iq,
+                             float *__restrict outa,
+                             float *__restrict outb,
+                             unsigned stride,
+                             xtrxdsp_meter_t *__restrict meter,
+                             size_t inbytes,
+                             uint64_t prevstate)
+{
+    const uint8_t *ld = (const uint8_t *)iq;
+    xtrxdsp_meter_t m = *meter;
+    size_t i  = 0;
+    size_t k  = 0;
+    uint8_t v0, v1, v2;
+    int16_t a, b;
+    unsigned q;
+
+    q = prevstate & 0xf;
+    if (q > 2)
+        return -1;
+
+    if (q > 0) {
+        uint8_t v[3];
+        v[0] = (prevstate >> 8) & 0xff;
+        v[1] = (prevstate >> 16) & 0xff;
+
+        for (; q < 3 && i < inbytes; q++, i++) {
+            v[q] = *(ld++);
+        }
+        if (q < 3) {
+            return q | ((unsigned)v[0] << 8) | ((unsigned)v[1] << 16);
+        }
+
+        a = (int16_t) (((uint16_t)v[0] << 4) | ((uint16_t)v[1] << 12));
+        b = (int16_t) (((uint16_t)v[2] << 8) | (v[1] & 0xf0));
+
+        outa[0] = a * SCALE16;
+        outb[0] = b * SCALE16;
+        meter_add(&m, 0, a, METER_FS12);
+        meter_add(&m, 1, b, METER_FS12);
+        k++;
+    }
+
+    for (; i + 3 <= inbytes; i += 3, k++) {
+        v0 = *(ld++);
+        v1 = *(ld++);
+        v2 = *(ld++);
+
+        a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        outa[k * stride] = a * SCALE16;
+        outb[k * stride] = b * SCALE16;
+        meter_add(&m, 0, a, METER_FS12);
+        meter_add(&m, 1, b, METER_FS12);
+    }
+
+    m.count += k;
+    *meter = m;
+
+    switch (inbytes - i) {
+    default:
+        return 0;
+    case 1:
+        return 1 | ((unsigned)(*ld) << 8);
+    case 2:
+        q = (*ld++);
+        return (2 | (q << 8)) | ((unsigned)(*ld) << 16);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32_METER
+static inline
+uint64_t xtrxdsp_iq12_sc32_meter_template(const void *__restrict iq,
+                                          float *__restrict out,
+                                          xtrxdsp_meter_t *__restrict meter,
+                                          size_t inbytes,
+                                          uint64_t prevstate)
+{
+    return meter_iq12_template(iq, out, out + 1, 2, meter, inbytes, prevstate);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32I_METER
+static inline
+uint64_t xtrxdsp_iq12_sc32i_meter_template(const void *__restrict iq,
+                                           float *__restrict outa,
+                                           float *__restrict outb,
+                                           xtrxdsp_meter_t *__restrict meter,
+                                           size_t inbytes,
+                                           uint64_t prevstate)
+{
+    return meter_iq12_template(iq, outa, outb, 1, meter, inbytes, prevstate);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32_METER
+static inline
+void xtrxdsp_iq8_sc32_meter_template(const int8_t *__restrict iq,
+                                     float *__restrict out,
+                                     xtrxdsp_meter_t *__restrict meter,
+                                     size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 2;
+
+    for (size_t i = 0; i < n; i++) {
+        int8_t a = iq[2*i];
+        int8_t b = iq[2*i + 1];
+
+        out[2*i]     = a * SCALE8;
+        out[2*i + 1] = b * SCALE8;
+        meter_add(&m, 0, a * 256, METER_FS8);
+        meter_add(&m, 1, b * 256, METER_FS8);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16_METER
+static inline
+void xtrxdsp_iq8_ic16_meter_template(const int8_t *__restrict iq,
+                                     int16_t *__restrict out,
+                                     xtrxdsp_meter_t *__restrict meter,
+                                     size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 2;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t a = iq[2*i] * 256;
+        int16_t b = iq[2*i + 1] * 256;
+
+        out[2*i]     = a;
+        out[2*i + 1] = b;
+        meter_add(&m, 0, a, METER_FS8);
+        meter_add(&m, 1, b, METER_FS8);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32I_METER
+static inline
+void xtrxdsp_iq8_sc32i_meter_template(const int8_t *__restrict iq,
+                                      float *__restrict outa,
+                                      float *__restrict outb,
+                                      xtrxdsp_meter_t *__restrict meter,
+                                      size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 2;
+
+    for (size_t i = 0; i < n; i++) {
+        int8_t a = iq[2*i];
+        int8_t b = iq[2*i + 1];
+
+        outa[i] = a * SCALE8;
+        outb[i] = b * SCALE8;
+        meter_add(&m, 0, a * 256, METER_FS8);
+        meter_add(&m, 1, b * 256, METER_FS8);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16I_METER
+static inline
+void xtrxdsp_iq8_ic16i_meter_template(const int8_t *__restrict iq,
+                                      int16_t *__restrict outa,
+                                      int16_t *__restrict outb,
+                                      xtrxdsp_meter_t *__restrict meter,
+                                      size_t bytes)
+{
+    xtrxdsp_meter_t m = *meter;
+    size_t n = bytes / 2;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t a = iq[2*i] * 256;
+        int16_t b = iq[2*i + 1] * 256;
+
+        outa[i] = a;
+        outb[i] = b;
+        meter_add(&m, 0, a, METER_FS8);
+        meter_add(&m, 1, b, METER_FS8);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32_METER_SSE2) || defined(XTRXDSP_TEMPLATE_IQ16_SC32I_METER_SSE2)
+typedef struct meter_sse2 {
+    __m128i vmax;   // per int16 lane, even lanes are channel 0
+    __m128i vmin;
+    __m128i ss0;    // 2 x uint64_t
+    __m128i ss1;
+    uint32_t clips0;
+    uint32_t clips1;
+} meter_sse2_t;
+
+static inline void meter_sse2_init(meter_sse2_t* s)
+{
+    s->vmax = _mm_set1_epi16(-32768);
+    s->vmin = _mm_set1_epi16(32767);
+    s->ss0 = _mm_setzero_si128();
+    s->ss1 = _mm_setzero_si128();
+    s->clips0 = 0;
+    s->clips1 = 0;
+}
+
+/* t holds 4 complex samples as 8 x int16 */
+static inline void meter_sse2_add(meter_sse2_t* s, __m128i t)
+{
+    const __m128i z = _mm_setzero_si128();
+    __m128i e = _mm_and_si128(t, _mm_set1_epi32(0xffff));
+    __m128i o = _mm_srli_epi32(t, 16);
+    __m128i p0 = _mm_madd_epi16(e, e); // I^2, fits 31 bits
+    __m128i p1 = _mm_madd_epi16(o, o); // Q^2
+    __m128i c = _mm_or_si128(_mm_cmpeq_epi16(t, _mm_set1_epi16(0x7fff)),
+                             _mm_cmpeq_epi16(t, _mm_set1_epi16(-32768)));
+    int mask;
+
+    s->vmax = _mm_max_epi16(s->vmax, t);
+    s->vmin = _mm_min_epi16(s->vmin, t);
+
+    s->ss0 = _mm_add_epi64(s->ss0, _mm_unpacklo_epi32(p0, z));
+    s->ss0 = _mm_add_epi64(s->ss0, _mm_unpackhi_epi32(p0, z));
+    s->ss1 = _mm_add_epi64(s->ss1, _mm_unpacklo_epi32(p1, z));
+    s->ss1 = _mm_add_epi64(s->ss1, _mm_unpackhi_epi32(p1, z));
+
+    if (unlikely((mask = _mm_movemask_epi8(c)) != 0)) {
+        s->clips0 += __builtin_popcount(mask & 0x3333) / 2;
+        s->clips1 += __builtin_popcount(mask & 0xcccc) / 2;
+    }
+}
+
+static inline void meter_sse2_flush(const meter_sse2_t* s, xtrxdsp_meter_t* m)
+{
+    int16_t vmax[8], vmin[8];
+    uint64_t ss[4];
+
+    _mm_storeu_si128((__m128i*)vmax, s->vmax);
+    _mm_storeu_si128((__m128i*)vmin, s->vmin);
+    _mm_storeu_si128((__m128i*)&ss[0], s->ss0);
+    _mm_storeu_si128((__m128i*)&ss[2], s->ss1);
+
+    for (unsigned k = 0; k < 8; k++) {
+        /* negative when nothing was accumulated */
+        int32_t pk = (vmax[k] > -vmin[k]) ? vmax[k] : -(int32_t)vmin[k];
+        if (pk > (int32_t)m->peak[k & 1])
+            m->peak[k & 1] = pk;
+    }
+
+    m->sumsq[0] += ss[0] + ss[1];
+    m->sumsq[1] += ss[2] + ss[3];
+    m->clips[0] += s->clips0;
+    m->clips[1] += s->clips1;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_METER_SSE2
+static inline
+void xtrxdsp_iq16_sc32_meter_template(const int16_t *__restrict iq,
+                                      float *__restrict out,
+                                      float scale,
+                                      xtrxdsp_meter_t *__restrict meter,
+                                      size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    xtrxdsp_meter_t m = *meter;
+    meter_sse2_t s;
+    __m128i t, d0, d1;
+    size_t n = bytes / 4;
+
+    meter_sse2_init(&s);
+    for (; bytes >= 16; bytes -= 16, iq += 8, out += 8) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        d0 = _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16);
+        d1 = _mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16);
+
+        _mm_storeu_ps(out,     _mm_mul_ps(_mm_cvtepi32_ps(d0), vscale));
+        _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(d1), vscale));
+
+        meter_sse2_add(&s, t);
+    }
+    meter_sse2_flush(&s, &m);
+
+    for (; bytes > 3; bytes -= 4, iq += 2, out += 2) {
+        out[0] = iq[0] * scale;
+        out[1] = iq[1] * scale;
+        meter_add(&m, 0, iq[0], METER_FS16);
+        meter_add(&m, 1, iq[1], METER_FS16);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_METER_SSE2
+static inline
+void xtrxdsp_iq16_sc32i_meter_template(const int16_t *__restrict iq,
+                                       float *__restrict outa,
+                                       float *__restrict outb,
+                                       float scale,
+                                       xtrxdsp_meter_t *__restrict meter,
+                                       size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    xtrxdsp_meter_t m = *meter;
+    meter_sse2_t s;
+    __m128i t;
+    size_t n = bytes / 4;
+
+    meter_sse2_init(&s);
+    for (; bytes >= 16; bytes -= 16, iq += 8, outa += 4, outb += 4) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+
+        _mm_storeu_ps(outa, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(t, 16), 16)), vscale));
+        _mm_storeu_ps(outb, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(t, 16)), vscale));
+
+        meter_sse2_add(&s, t);
+    }
+    meter_sse2_flush(&s, &m);
+
+    for (; bytes > 3; bytes -= 4, iq += 2) {
+        *(outa++) = iq[0] * scale;
+        *(outb++) = iq[1] * scale;
+        meter_add(&m, 0, iq[0], METER_FS16);
+        meter_add(&m, 1, iq[1], METER_FS16);
+    }
+
+    m.count += n;
+    *meter = m;
+}
+#endif
+
+/*********************************************************************************************/
+/* Half precision */
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_HC16) || defined(XTRXDSP_TEMPLATE_HC16_IQ16) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_BF16) || defined(XTRXDSP_TEMPLATE_BF16_IQ16) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_BF16_SSE2) || defined(XTRXDSP_TEMPLATE_BF16_IQ16_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ16_HC16_F16C) || defined(XTRXDSP_TEMPLATE_HC16_IQ16_F16C)
+#include <string.h>
+#include <math.h>
+
+static inline uint32_t half_f2u(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+static inline float half_u2f(uint32_t x)
+{
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+/* round and saturate to int16, same as cvtps2dq + packssdw */
+static inline int16_t half_sat16(float v)
+{
+    if (v >= 32767.0f)
+        return 32767;
+    if (v <= -32768.0f)
+        return -32768;
+    return (int16_t)lrintf(v);
+}
+
+/* IEEE binary16, round to nearest even, gives the same result as vcvtps2ph */
+static inline uint16_t half_from_float(float f)
+{
+    uint32_t x = half_f2u(f);
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t ax = x & 0x7fffffff;
+
+    if (ax >= 0x47800000) {
+        /* |f| >= 65536, NaN stays quiet NaN */
+        return sign | ((ax > 0x7f800000) ? 0x7e00 | ((ax >> 13) & 0x3ff) : 0x7c00);
+    }
+    if (ax < 0x38800000) {
+        /* subnormal, FPU rounds the addition for us */
+        return sign | (half_f2u(half_u2f(ax) + 0.5f) - 0x3f000000);
+    }
+
+    /* rebias exponent, mantissa carry may overflow to infinity as it should */
+    ax += 0xc8000fff + ((ax >> 13) & 1);
+    return sign | (ax >> 13);
+}
+
+static inline float half_to_float(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t e = (h >> 10) & 0x1f;
+    uint32_t m = h & 0x3ff;
+
+    if (e == 0)
+        return half_u2f(sign | half_f2u(m * (1.0f / 16777216)));
+    if (e == 31)
+        return half_u2f(sign | 0x7f800000 | (m << 13));
+    return half_u2f(sign | ((e + 112) << 23) | (m << 13));
+}
+
+/* bfloat16, round to nearest even, no NaN handling as inputs come from integers */
+static inline uint16_t bf16_from_float(float f)
+{
+    uint32_t x = half_f2u(f);
+    return (x + 0x7fff + ((x >> 16) & 1)) >> 16;
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_HC16
+static inline
+void xtrxdsp_iq16_hc16_template(const int16_t *__restrict iq,
+                                uint16_t *__restrict out,
+                                float scale,
+                                size_t bytes)
+{
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = half_from_float(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_HC16_IQ16
+static inline
+void xtrxdsp_hc16_iq16_template(const uint16_t *__restrict iq,
+                                int16_t *__restrict out,
+                                float scale,
+                                size_t outbytes)
+{
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = half_sat16(half_to_float(*(iq++)) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_BF16
+static inline
+void xtrxdsp_iq16_bf16_template(const int16_t *__restrict iq,
+                                uint16_t *__restrict out,
+                                float scale,
+                                size_t bytes)
+{
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = bf16_from_float(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_BF16_IQ16
+static inline
+void xtrxdsp_bf16_iq16_template(const uint16_t *__restrict iq,
+                                int16_t *__restrict out,
+                                float scale,
+                                size_t outbytes)
+{
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = half_sat16(half_u2f((uint32_t)*(iq++) << 16) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_BF16_SSE2
+static inline
+void xtrxdsp_iq16_bf16_template(const int16_t *__restrict iq,
+                                uint16_t *__restrict out,
+                                float scale,
+                                size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128i bias = _mm_set1_epi32(0x7fff);
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i t, x0, x1;
+
+    for (; bytes >= 16; bytes -= 16, iq += 8, out += 8) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        x0 = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16)), vscale));
+        x1 = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16)), vscale));
+
+        x0 = _mm_add_epi32(x0, _mm_add_epi32(bias, _mm_and_si128(_mm_srli_epi32(x0, 16), one)));
+        x1 = _mm_add_epi32(x1, _mm_add_epi32(bias, _mm_and_si128(_mm_srli_epi32(x1, 16), one)));
+
+        /* arithmetic shift keeps values in int16 range, so packs is exact */
+        _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(_mm_srai_epi32(x0, 16), _mm_srai_epi32(x1, 16)));
+    }
+
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = bf16_from_float(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_BF16_IQ16_SSE2
+static inline
+void xtrxdsp_bf16_iq16_template(const uint16_t *__restrict iq,
+                                int16_t *__restrict out,
+                                float scale,
+                                size_t outbytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vmax = _mm_set1_ps(32767.0f);
+    const __m128 vmin = _mm_set1_ps(-32768.0f);
+    const __m128i z = _mm_setzero_si128();
+    __m128i t;
+    __m128 f0, f1;
+
+    for (; outbytes >= 16; outbytes -= 16, iq += 8, out += 8) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        f0 = _mm_mul_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(z, t)), vscale);
+        f1 = _mm_mul_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(z, t)), vscale);
+
+        f0 = _mm_max_ps(_mm_min_ps(f0, vmax), vmin);
+        f1 = _mm_max_ps(_mm_min_ps(f1, vmax), vmin);
+
+        _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(_mm_cvtps_epi32(f0), _mm_cvtps_epi32(f1)));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = half_sat16(half_u2f((uint32_t)*(iq++) << 16) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_HC16_F16C
+static inline
+void xtrxdsp_iq16_hc16_template(const int16_t *__restrict iq,
+                                uint16_t *__restrict out,
+                                float scale,
+                                size_t bytes)
+{
+    const __m256 vscale = _mm256_set1_ps(scale);
+    __m128i t0, t1;
+    __m256 f0, f1;
+
+    for (; bytes >= 32; bytes -= 32, iq += 16, out += 16) {
+        t0 = _mm_loadu_si128((const __m128i*)iq);
+        t1 = _mm_loadu_si128((const __m128i*)iq + 1);
+
+        f0 = _mm256_cvtepi32_ps(_mm256_insertf128_si256(
+                 _mm256_castsi128_si256(_mm_srai_epi32(_mm_unpacklo_epi16(t0, t0), 16)),
+                 _mm_srai_epi32(_mm_unpackhi_epi16(t0, t0), 16), 1));
+        f1 = _mm256_cvtepi32_ps(_mm256_insertf128_si256(
+                 _mm256_castsi128_si256(_mm_srai_epi32(_mm_unpacklo_epi16(t1, t1), 16)),
+                 _mm_srai_epi32(_mm_unpackhi_epi16(t1, t1), 16), 1));
+
+        _mm_storeu_si128((__m128i*)out,     _mm256_cvtps_ph(_mm256_mul_ps(f0, vscale), _MM_FROUND_TO_NEAREST_INT));
+        _mm_storeu_si128((__m128i*)out + 1, _mm256_cvtps_ph(_mm256_mul_ps(f1, vscale), _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = half_from_float(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_HC16_IQ16_F16C
+static inline
+void xtrxdsp_hc16_iq16_template(const uint16_t *__restrict iq,
+                                int16_t *__restrict out,
+                                float scale,
+                                size_t outbytes)
+{
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vmax = _mm256_set1_ps(32767.0f);
+    const __m256 vmin = _mm256_set1_ps(-32768.0f);
+    __m256 f0, f1;
+    __m256i i0, i1;
+
+    for (; outbytes >= 32; outbytes -= 32, iq += 16, out += 16) {
+        f0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)iq));
+        f1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)iq + 1));
+
+        f0 = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(f0, vscale), vmax), vmin);
+        f1 = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(f1, vscale), vmax), vmin);
+
+        i0 = _mm256_cvtps_epi32(f0);
+        i1 = _mm256_cvtps_epi32(f1);
+
+        /* no AVX2, pack by 128 bit halves */
+        _mm_storeu_si128((__m128i*)out,     _mm_packs_epi32(_mm256_castsi256_si128(i0), _mm256_extractf128_si256(i0, 1)));
+        _mm_storeu_si128((__m128i*)out + 1, _mm_packs_epi32(_mm256_castsi256_si128(i1), _mm256_extractf128_si256(i1, 1)));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = half_sat16(half_to_float(*(iq++)) * scale);
+    }
+}
+#endif
+
+/*********************************************************************************************/
+/* Complex double */
+
+#if defined(XTRXDSP_TEMPLATE_SC64_IQ16) || defined(XTRXDSP_TEMPLATE_SC64_IQ16_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_SC64_IQ16_AVX)
+#include <math.h>
+
+static inline int16_t sc64_sat16(double v)
+{
+    if (v >= 32767.0)
+        return 32767;
+    if (v <= -32768.0)
+        return -32768;
+    return (int16_t)lrint(v);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC64
+static inline
+void xtrxdsp_iq16_sc64_template(const int16_t *__restrict iq,
+                                double *__restrict out,
+                                double scale,
+                                size_t bytes)
+{
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC64
+static inline
+uint64_t xtrxdsp_iq12_sc64_template(const void *__restrict iq,
+                                    double *__restrict out,
+                                    size_t inbytes,
+                                    uint64_t prevstate)
+{
+    const uint8_t *ld = (const uint8_t *)iq;
+    size_t i  = 0;
+    uint8_t v0, v1, v2;
+    int16_t a, b;
+    unsigned q;
+
+    /* same layout and carry state as in xtrxdsp_iq12_sc32_template() */
+    q = prevstate & 0xf;
+    if (q > 2)
+        return -1;
+
+    if (q > 0) {
+        uint8_t v[3];
+        v[0] = (prevstate >> 8) & 0xff;
+        v[1] = (prevstate >> 16) & 0xff;
+
+        for (; q < 3 && i < inbytes; q++, i++) {
+            v[q] = *(ld++);
+        }
+        if (q < 3) {
+            return q | ((unsigned)v[0] << 8) | ((unsigned)v[1] << 16);
+        }
+
+        a = (int16_t) (((uint16_t)v[0] << 4) | ((uint16_t)v[1] << 12));
+        b = (int16_t) (((uint16_t)v[2] << 8) | (v[1] & 0xf0));
+
+        *(out++) = a * (1.0 / 32768);
+        *(out++) = b * (1.0 / 32768);
+    }
+
+    for (; i + 3 <= inbytes; i += 3) {
+        v0 = *(ld++);
+        v1 = *(ld++);
+        v2 = *(ld++);
+
+        a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        *(out++) = a * (1.0 / 32768);
+        *(out++) = b * (1.0 / 32768);
+    }
+
+    switch (inbytes - i) {
+    default:
+        return 0;
+    case 1:
+        return 1 | ((unsigned)(*ld) << 8);
+    case 2:
+        q = (*ld++);
+        return (2 | (q << 8)) | ((unsigned)(*ld) << 16);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC64_IQ16
+static inline
+void xtrxdsp_sc64_iq16_template(const double *__restrict iq,
+                                int16_t *__restrict out,
+                                double scale,
+                                size_t outbytes)
+{
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = sc64_sat16(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC64_SSE2
+static inline
+void xtrxdsp_iq16_sc64_template(const int16_t *__restrict iq,
+                                double *__restrict out,
+                                double scale,
+                                size_t bytes)
+{
+    const __m128d vscale = _mm_set1_pd(scale);
+    __m128i t, d0, d1;
+
+    for (; bytes >= 16; bytes -= 16, iq += 8, out += 8) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        d0 = _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16);
+        d1 = _mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16);
+
+        _mm_storeu_pd(out,     _mm_mul_pd(_mm_cvtepi32_pd(d0), vscale));
+        _mm_storeu_pd(out + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(d0, d0)), vscale));
+        _mm_storeu_pd(out + 4, _mm_mul_pd(_mm_cvtepi32_pd(d1), vscale));
+        _mm_storeu_pd(out + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(d1, d1)), vscale));
+    }
+
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC64_IQ16_SSE2
+static inline
+void xtrxdsp_sc64_iq16_template(const double *__restrict iq,
+                                int16_t *__restrict out,
+                                double scale,
+                                size_t outbytes)
+{
+    const __m128d vscale = _mm_set1_pd(scale);
+    const __m128d vmax = _mm_set1_pd(32767.0);
+    const __m128d vmin = _mm_set1_pd(-32768.0);
+    __m128d f0, f1, f2, f3;
+    __m128i i0, i1;
+
+    for (; outbytes >= 16; outbytes -= 16, iq += 8, out += 8) {
+        f0 = _mm_max_pd(_mm_min_pd(_mm_mul_pd(_mm_loadu_pd(iq),     vscale), vmax), vmin);
+        f1 = _mm_max_pd(_mm_min_pd(_mm_mul_pd(_mm_loadu_pd(iq + 2), vscale), vmax), vmin);
+        f2 = _mm_max_pd(_mm_min_pd(_mm_mul_pd(_mm_loadu_pd(iq + 4), vscale), vmax), vmin);
+        f3 = _mm_max_pd(_mm_min_pd(_mm_mul_pd(_mm_loadu_pd(iq + 6), vscale), vmax), vmin);
+
+        i0 = _mm_unpacklo_epi64(_mm_cvtpd_epi32(f0), _mm_cvtpd_epi32(f1));
+        i1 = _mm_unpacklo_epi64(_mm_cvtpd_epi32(f2), _mm_cvtpd_epi32(f3));
+
+        _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(i0, i1));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = sc64_sat16(*(iq++) * scale);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC64_AVX
+static inline
+void xtrxdsp_iq16_sc64_template(const int16_t *__restrict iq,
+                                double *__restrict out,
+                                double scale,
+                                size_t bytes)
+{
+    const __m256d vscale = _mm256_set1_pd(scale);
+    __m128i t, d0, d1;
+
+    for (; bytes >= 16; bytes -= 16, iq += 8, out += 8) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        d0 = _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16);
+        d1 = _mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16);
+
+        _mm256_storeu_pd(out,     _mm256_mul_pd(_mm256_cvtepi32_pd(d0), vscale));
+        _mm256_storeu_pd(out + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(d1), vscale));
+    }
+
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC64_IQ16_AVX
+static inline
+void xtrxdsp_sc64_iq16_template(const double *__restrict iq,
+                                int16_t *__restrict out,
+                                double scale,
+                                size_t outbytes)
+{
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256d vmax = _mm256_set1_pd(32767.0);
+    const __m256d vmin = _mm256_set1_pd(-32768.0);
+    __m256d f0, f1;
+
+    for (; outbytes >= 16; outbytes -= 16, iq += 8, out += 8) {
+        f0 = _mm256_max_pd(_mm256_min_pd(_mm256_mul_pd(_mm256_loadu_pd(iq),     vscale), vmax), vmin);
+        f1 = _mm256_max_pd(_mm256_min_pd(_mm256_mul_pd(_mm256_loadu_pd(iq + 4), vscale), vmax), vmin);
+
+        _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(_mm256_cvtpd_epi32(f0), _mm256_cvtpd_epi32(f1)));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = sc64_sat16(*(iq++) * scale);
+    }
+}
+#endif
+
+/*********************************************************************************************/
+/* Streaming stores */
+
+/* no streaming stores in generic code, same as the regular converters */
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_NT
+static inline
+void xtrxdsp_iq16_sc32_nt_template(const int16_t *__restrict iq,
+                                   float *__restrict out,
+                                   float scale,
+                                   size_t bytes)
+{
+    xtrxdsp_iq16_sc32_template(iq, out, scale, bytes);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_NT
+static inline
+void xtrxdsp_iq16_sc32i_nt_template(const int16_t *__restrict iq,
+                                    float *__restrict outa,
+                                    float *__restrict outb,
+                                    float scale,
+                                    size_t bytes)
+{
+    xtrxdsp_iq16_sc32i_template(iq, outa, outb, scale, bytes);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_IQ16_NT
+static inline
+void xtrxdsp_sc32_iq16_nt_template(const float *__restrict iq,
+                                   int16_t *__restrict out,
+                                   float scale,
+                                   size_t outbytes)
+{
+    xtrxdsp_sc32_iq16_template(iq, out, scale, outbytes);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32_NT
+static inline
+uint64_t xtrxdsp_iq12_sc32_nt_template(const void *__restrict iq,
+                                       float *__restrict out,
+                                       size_t inbytes,
+                                       uint64_t prevstate)
+{
+    return xtrxdsp_iq12_sc32_template(iq, out, inbytes, prevstate);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32_NT
+static inline
+void xtrxdsp_iq8_sc32_nt_template(const int8_t *__restrict iq,
+                                  float *__restrict out,
+                                  size_t bytes)
+{
+    xtrxdsp_iq8_sc32_template(iq, out, bytes);
+}
+#endif
+
+/* movntps/movntdq need 16 byte aligned destination, so a scalar prologue runs
+ * up to the alignment boundary; sfence at the end orders streaming stores
+ * with whatever the caller does next (e.g. handing the buffer to a writer)
+ */
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_NT_SSE2
+static inline
+void xtrxdsp_iq16_sc32_nt_template(const int16_t *__restrict iq,
+                                   float *__restrict out,
+                                   float scale,
+                                   size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i t0, t1;
+
+    for (; bytes > 1 && ((uintptr_t)out & 0xf); bytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+
+    for (; bytes >= 32; bytes -= 32, iq += 16, out += 16) {
+        t0 = _mm_loadu_si128((const __m128i*)iq);
+        t1 = _mm_loadu_si128((const __m128i*)iq + 1);
+
+        _mm_stream_ps(out,      _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(t0, t0), 16)), vscale));
+        _mm_stream_ps(out + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(t0, t0), 16)), vscale));
+        _mm_stream_ps(out + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(t1, t1), 16)), vscale));
+        _mm_stream_ps(out + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(t1, t1), 16)), vscale));
+    }
+
+    for (; bytes > 1; bytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+    _mm_sfence();
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32I_NT_SSE2
+static inline
+void xtrxdsp_iq16_sc32i_nt_template(const int16_t *__restrict iq,
+                                    float *__restrict outa,
+                                    float *__restrict outb,
+                                    float scale,
+                                    size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i t;
+    __m128 fa, fb;
+
+    for (; bytes > 3 && ((uintptr_t)outa & 0xf); bytes -= 4) {
+        *(outa++) = *(iq++) * scale;
+        *(outb++) = *(iq++) * scale;
+    }
+
+    if (((uintptr_t)outb & 0xf) == 0) {
+        for (; bytes >= 16; bytes -= 16, iq += 8, outa += 4, outb += 4) {
+            t  = _mm_loadu_si128((const __m128i*)iq);
+            fa = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(t, 16), 16)), vscale);
+            fb = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(t, 16)), vscale);
+
+            _mm_stream_ps(outa, fa);
+            _mm_stream_ps(outb, fb);
+        }
+    } else {
+        /* outputs are out of phase, stream only the first one */
+        for (; bytes >= 16; bytes -= 16, iq += 8, outa += 4, outb += 4) {
+            t  = _mm_loadu_si128((const __m128i*)iq);
+            fa = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(t, 16), 16)), vscale);
+            fb = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(t, 16)), vscale);
+
+            _mm_stream_ps(outa, fa);
+            _mm_storeu_ps(outb, fb);
+        }
+    }
+
+    for (; bytes > 3; bytes -= 4) {
+        *(outa++) = *(iq++) * scale;
+        *(outb++) = *(iq++) * scale;
+    }
+    if (bytes > 1) {
+        *(outa++) = *(iq++) * scale;
+    }
+    _mm_sfence();
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_IQ16_NT_SSE2
+static inline
+void xtrxdsp_sc32_iq16_nt_template(const float *__restrict iq,
+                                   int16_t *__restrict out,
+                                   float scale,
+                                   size_t outbytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i i0, i1;
+
+    for (; outbytes > 1 && ((uintptr_t)out & 0xf); outbytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+
+    /* truncation as in the regular converter, packssdw saturates */
+    for (; outbytes >= 16; outbytes -= 16, iq += 8, out += 8) {
+        i0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(iq),     vscale));
+        i1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(iq + 4), vscale));
+
+        _mm_stream_si128((__m128i*)out, _mm_packs_epi32(i0, i1));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+    _mm_sfence();
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32_NT_SSE2
+static inline
+void xtrxdsp_iq8_sc32_nt_template(const int8_t *__restrict iq,
+                                  float *__restrict out,
+                                  size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(SCALE8);
+    __m128i t, lo, hi;
+
+    for (; bytes > 0 && ((uintptr_t)out & 0xf); bytes--) {
+        *(out++) = *(iq++) * SCALE8;
+    }
+
+    for (; bytes >= 16; bytes -= 16, iq += 16, out += 16) {
+        t  = _mm_loadu_si128((const __m128i*)iq);
+        lo = _mm_unpacklo_epi8(t, t);
+        hi = _mm_unpackhi_epi8(t, t);
+
+        _mm_stream_ps(out,      _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 24)), vscale));
+        _mm_stream_ps(out + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 24)), vscale));
+        _mm_stream_ps(out + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 24)), vscale));
+        _mm_stream_ps(out + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 24)), vscale));
+    }
+
+    for (; bytes > 0; bytes--) {
+        *(out++) = *(iq++) * SCALE8;
+    }
+    _mm_sfence();
+}
+#endif
+
+/* iq12 has no vector decoder, so it's decoded into an L1 resident block that
+ * is then streamed out; only the streamed copy reaches memory
+ */
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32_NT_SSE2
+#define NT_IQ12_BLOCK   3072 /* input bytes, 2048 floats */
+
+static inline
+uint64_t xtrxdsp_iq12_sc32_nt_template(const void *__restrict iq,
+                                       float *__restrict out,
+                                       size_t inbytes,
+                                       uint64_t prevstate)
+{
+    float blk[2 * NT_IQ12_BLOCK / 3] __attribute__((aligned(16)));
+    const uint8_t *ld = (const uint8_t *)iq;
+    size_t sz, n, k;
+
+    /* whole samples never get 16 byte aligned if out is off by a float */
+    if (((uintptr_t)out & 0x7) || (prevstate & 0xf) > 2)
+        return xtrxdsp_iq12_sc32_template(iq, out, inbytes, prevstate);
+
+    for (; inbytes > 0; inbytes -= sz, ld += sz) {
+        sz = (inbytes > NT_IQ12_BLOCK) ? NT_IQ12_BLOCK : inbytes;
+        /* carried bytes add one sample, block boundary may carry new ones */
+        n = 2 * (((prevstate & 0xf) + sz) / 3);
+        prevstate = xtrxdsp_iq12_sc32_template(ld, blk, sz, prevstate);
+
+        for (k = 0; k < n && ((uintptr_t)out & 0xf); k++) {
+            *(out++) = blk[k];
+        }
+        for (; k + 4 <= n; k += 4, out += 4) {
+            _mm_stream_ps(out, _mm_loadu_ps(blk + k));
+        }
+        for (; k < n; k++) {
+            *(out++) = blk[k];
+        }
+    }
+    _mm_sfence();
+    return prevstate;
+}
+#endif
+
+/*********************************************************************************************/
+/* In-place conversions */
+
+#if defined(XTRXDSP_TEMPLATE_SC32_IQ16_IP) || defined(XTRXDSP_TEMPLATE_IQ16_SC32_IP) || \
+    defined(XTRXDSP_TEMPLATE_IQ8_SC32_IP) || defined(XTRXDSP_TEMPLATE_IQ8_IC16_IP) || \
+    defined(XTRXDSP_TEMPLATE_SC32_IQ16_IP_SSE2) || defined(XTRXDSP_TEMPLATE_IQ16_SC32_IP_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ8_IC16_IP_SSE2)
+/* input and output of different types share the same memory */
+typedef int8_t  __attribute__((may_alias)) ip_int8_t;
+typedef int16_t __attribute__((may_alias)) ip_int16_t;
+typedef float   __attribute__((may_alias)) ip_float_t;
+#endif
+
+/* write position never overtakes read position going forward */
+#ifdef XTRXDSP_TEMPLATE_IQ16_IC16I_IP
+static inline
+void xtrxdsp_iq16_ic16i_ip_template(int16_t *iq,
+                                    int16_t *__restrict outb,
+                                    size_t bytes)
+{
+    int16_t *outa = iq;
+    for (; bytes > 3; bytes -= 4, iq += 2) {
+        *(outa++) = iq[0];
+        *(outb++) = iq[1];
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC8I_IP
+static inline
+void xtrxdsp_iq8_ic8i_ip_template(int8_t *iq,
+                                  int8_t *__restrict outb,
+                                  size_t bytes)
+{
+    int8_t *outa = iq;
+    for (; bytes > 1; bytes -= 2, iq += 2) {
+        *(outa++) = iq[0];
+        *(outb++) = iq[1];
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32_IQ16_IP
+static inline
+void xtrxdsp_sc32_iq16_ip_template(void *buf,
+                                   float scale,
+                                   size_t outbytes)
+{
+    const ip_float_t *iq = (const ip_float_t *)buf;
+    ip_int16_t *out = (ip_int16_t *)buf;
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+}
+#endif
+
+/* expanding conversions run backward, so read position stays below write position */
+#ifdef XTRXDSP_TEMPLATE_IC16I_IQ16_IP
+static inline
+void xtrxdsp_ic16i_iq16_ip_template(int16_t *i,
+                                    const int16_t *__restrict q,
+                                    size_t outbytes)
+{
+    size_t n = outbytes / 4;
+    int16_t *out = i + 2 * n;
+    for (i += n, q += n; n > 0; n--) {
+        *(--out) = *(--q);
+        *(--out) = *(--i);
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_IP
+static inline
+void xtrxdsp_iq16_sc32_ip_template(void *buf,
+                                   float scale,
+                                   size_t inbytes)
+{
+    size_t n = inbytes / 2;
+    const ip_int16_t *iq = (const ip_int16_t *)buf + n;
+    ip_float_t *out = (ip_float_t *)buf + n;
+    for (; n > 0; n--) {
+        *(--out) = *(--iq) * scale;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32_IP
+static inline
+void xtrxdsp_iq8_sc32_ip_template(void *buf,
+                                  size_t inbytes)
+{
+    const ip_int8_t *iq = (const ip_int8_t *)buf + inbytes;
+    ip_float_t *out = (ip_float_t *)buf + inbytes;
+    for (; inbytes > 0; inbytes--) {
+        *(--out) = *(--iq) * SCALE8;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16_IP
+static inline
+void xtrxdsp_iq8_ic16_ip_template(void *buf,
+                                  size_t inbytes)
+{
+    const ip_int8_t *iq = (const ip_int8_t *)buf + inbytes;
+    ip_int16_t *out = (ip_int16_t *)buf + inbytes;
+    for (; inbytes > 0; inbytes--) {
+        *(--out) = *(--iq) << 8;
+    }
+}
+#endif
+
+/* each block is loaded before anything is stored, so blocks may overlap */
+#ifdef XTRXDSP_TEMPLATE_IQ16_IC16I_IP_SSE2
+static inline
+void xtrxdsp_iq16_ic16i_ip_template(int16_t *iq,
+                                    int16_t *__restrict outb,
+                                    size_t bytes)
+{
+    int16_t *outa = iq;
+    __m128i t0, t1;
+
+    for (; bytes >= 32; bytes -= 32, iq += 16, outa += 8, outb += 8) {
+        t0 = _mm_loadu_si128((const __m128i*)iq);
+        t1 = _mm_loadu_si128((const __m128i*)iq + 1);
+
+        _mm_storeu_si128((__m128i*)outa, _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(t0, 16), 16),
+                                                         _mm_srai_epi32(_mm_slli_epi32(t1, 16), 16)));
+        _mm_storeu_si128((__m128i*)outb, _mm_packs_epi32(_mm_srai_epi32(t0, 16),
+                                                         _mm_srai_epi32(t1, 16)));
+    }
+
+    for (; bytes > 3; bytes -= 4, iq += 2) {
+        *(outa++) = iq[0];
+        *(outb++) = iq[1];
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16I_IQ16_IP_SSE2
+static inline
+void xtrxdsp_ic16i_iq16_ip_template(int16_t *i,
+                                    const int16_t *__restrict q,
+                                    size_t outbytes)
+{
+    size_t n = outbytes / 4;
+    __m128i ti, tq;
+
+    for (; n % 8; n--) {
+        i[2 * n - 1] = q[n - 1];
+        i[2 * n - 2] = i[n - 1];
+    }
+
+    for (; n > 0; n -= 8) {
+        ti = _mm_loadu_si128((const __m128i*)(i + n - 8));
+        tq = _mm_loadu_si128((const __m128i*)(q + n - 8));
+
+        _mm_storeu_si128((__m128i*)(i + 2 * n - 16), _mm_unpacklo_epi16(ti, tq));
+        _mm_storeu_si128((__m128i*)(i + 2 * n - 8),  _mm_unpackhi_epi16(ti, tq));
+    }
+}
+#endif
+
+/* truncation as in the regular converter, packssdw saturates */
+#ifdef XTRXDSP_TEMPLATE_SC32_IQ16_IP_SSE2
+static inline
+void xtrxdsp_sc32_iq16_ip_template(void *buf,
+                                   float scale,
+                                   size_t outbytes)
+{
+    const ip_float_t *iq = (const ip_float_t *)buf;
+    ip_int16_t *out = (ip_int16_t *)buf;
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i i0, i1;
+
+    for (; outbytes >= 16; outbytes -= 16, iq += 8, out += 8) {
+        i0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps((const float*)iq),     vscale));
+        i1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps((const float*)iq + 4), vscale));
+
+        _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(i0, i1));
+    }
+
+    for (; outbytes > 1; outbytes -= 2) {
+        *(out++) = *(iq++) * scale;
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32_IP_SSE2
+static inline
+void xtrxdsp_iq16_sc32_ip_template(void *buf,
+                                   float scale,
+                                   size_t inbytes)
+{
+    size_t n = inbytes / 2;
+    const ip_int16_t *iq = (const ip_int16_t *)buf;
+    ip_float_t *out = (ip_float_t *)buf;
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i t;
+
+    for (; n % 8; n--) {
+        out[n - 1] = iq[n - 1] * scale;
+    }
+
+    for (; n > 0; n -= 8) {
+        t = _mm_loadu_si128((const __m128i*)(iq + n - 8));
+
+        _mm_storeu_ps((float*)out + n - 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16)), vscale));
+        _mm_storeu_ps((float*)out + n - 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(t, t), 16)), vscale));
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16_IP_SSE2
+static inline
+void xtrxdsp_iq8_ic16_ip_template(void *buf,
+                                  size_t inbytes)
+{
+    size_t n = inbytes;
+    const ip_int8_t *iq = (const ip_int8_t *)buf;
+    ip_int16_t *out = (ip_int16_t *)buf;
+    const __m128i zero = _mm_setzero_si128();
+    __m128i t;
+
+    for (; n % 16; n--) {
+        out[n - 1] = iq[n - 1] << 8;
+    }
+
+    for (; n > 0; n -= 16) {
+        t = _mm_loadu_si128((const __m128i*)(iq + n - 16));
+
+        _mm_storeu_si128((__m128i*)(out + n - 16), _mm_unpacklo_epi8(zero, t));
+        _mm_storeu_si128((__m128i*)(out + n - 8),  _mm_unpackhi_epi8(zero, t));
+    }
+}
+#endif
+
+/*********************************************************************************************/
+/* N-way converters */
+
+/* frame f of the stream holds sample f of every channel, 4 bytes per sample for iq16 */
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32N) || defined(XTRXDSP_TEMPLATE_IQ16_SC32N_SSE2)
+static inline
+void iq16_sc32n_scalar(const int16_t *__restrict iq,
+                       float *const *__restrict out,
+                       unsigned chans,
+                       float scale,
+                       size_t f,
+                       size_t frames)
+{
+    unsigned c;
+    for (iq += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, iq += 2) {
+            out[c][2 * f]     = iq[0] * scale;
+            out[c][2 * f + 1] = iq[1] * scale;
+        }
+    }
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ16_IC16N) || defined(XTRXDSP_TEMPLATE_IQ16_IC16N_SSE2)
+static inline
+void iq16_ic16n_scalar(const int16_t *__restrict iq,
+                       int16_t *const *__restrict out,
+                       unsigned chans,
+                       size_t f,
+                       size_t frames)
+{
+    unsigned c;
+    for (iq += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, iq += 2) {
+            out[c][2 * f]     = iq[0];
+            out[c][2 * f + 1] = iq[1];
+        }
+    }
+}
+#endif
+
+/* 3 bytes per iq12 sample, same bit layout as in xtrxdsp_iq12_sc32() */
+#if defined(XTRXDSP_TEMPLATE_IQ12_SC32N) || defined(XTRXDSP_TEMPLATE_IQ12_SC32N_SSE2)
+static inline
+void iq12_sc32n_scalar(const void *__restrict iq,
+                       float *const *__restrict out,
+                       unsigned chans,
+                       size_t f,
+                       size_t frames)
+{
+    const uint8_t *ld = (const uint8_t *)iq + 3 * chans * f;
+    unsigned c;
+    uint8_t v0, v1, v2;
+    float a, b;
+
+    for (; f < frames; f++) {
+        for (c = 0; c < chans; c++) {
+            v0 = *(ld++);
+            v1 = *(ld++);
+            v2 = *(ld++);
+
+            a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+            b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+            out[c][2 * f]     = a * SCALE16;
+            out[c][2 * f + 1] = b * SCALE16;
+        }
+    }
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ8_SC32N) || defined(XTRXDSP_TEMPLATE_IQ8_SC32N_SSE2)
+static inline
+void iq8_sc32n_scalar(const int8_t *__restrict iq,
+                      float *const *__restrict out,
+                      unsigned chans,
+                      size_t f,
+                      size_t frames)
+{
+    unsigned c;
+    for (iq += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, iq += 2) {
+            out[c][2 * f]     = iq[0] * SCALE8;
+            out[c][2 * f + 1] = iq[1] * SCALE8;
+        }
+    }
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IQ8_IC16N) || defined(XTRXDSP_TEMPLATE_IQ8_IC16N_SSE2)
+static inline
+void iq8_ic16n_scalar(const int8_t *__restrict iq,
+                      int16_t *const *__restrict out,
+                      unsigned chans,
+                      size_t f,
+                      size_t frames)
+{
+    unsigned c;
+    for (iq += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, iq += 2) {
+            out[c][2 * f]     = iq[0] << 8;
+            out[c][2 * f + 1] = iq[1] << 8;
+        }
+    }
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_SC32N_IQ16) || defined(XTRXDSP_TEMPLATE_SC32N_IQ16_SSE2)
+static inline
+void sc32n_iq16_scalar(const float *const *__restrict in,
+                       unsigned chans,
+                       int16_t *__restrict out,
+                       float scale,
+                       size_t f,
+                       size_t frames)
+{
+    unsigned c;
+    for (out += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, out += 2) {
+            out[0] = in[c][2 * f] * scale;
+            out[1] = in[c][2 * f + 1] * scale;
+        }
+    }
+}
+#endif
+
+#if defined(XTRXDSP_TEMPLATE_IC16N_IQ16) || defined(XTRXDSP_TEMPLATE_IC16N_IQ16_SSE2)
+static inline
+void ic16n_iq16_scalar(const int16_t *const *__restrict in,
+                       unsigned chans,
+                       int16_t *__restrict out,
+                       size_t f,
+                       size_t frames)
+{
+    unsigned c;
+    for (out += 2 * chans * f; f < frames; f++) {
+        for (c = 0; c < chans; c++, out += 2) {
+            out[0] = in[c][2 * f];
+            out[1] = in[c][2 * f + 1];
+        }
+    }
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32N
+static inline
+void xtrxdsp_iq16_sc32n_template(const int16_t *__restrict iq,
+                                 float *const *__restrict out,
+                                 unsigned chans,
+                                 float scale,
+                                 size_t bytes)
+{
+    if (chans == 0)
+        return;
+    iq16_sc32n_scalar(iq, out, chans, scale, 0, bytes / (4 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_IC16N
+static inline
+void xtrxdsp_iq16_ic16n_template(const int16_t *__restrict iq,
+                                 int16_t *const *__restrict out,
+                                 unsigned chans,
+                                 size_t bytes)
+{
+    if (chans == 0)
+        return;
+    iq16_ic16n_scalar(iq, out, chans, 0, bytes / (4 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32N
+static inline
+void xtrxdsp_iq12_sc32n_template(const void *__restrict iq,
+                                 float *const *__restrict out,
+                                 unsigned chans,
+                                 size_t inbytes)
+{
+    if (chans == 0)
+        return;
+    iq12_sc32n_scalar(iq, out, chans, 0, inbytes / (3 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32N
+static inline
+void xtrxdsp_iq8_sc32n_template(const int8_t *__restrict iq,
+                                float *const *__restrict out,
+                                unsigned chans,
+                                size_t bytes)
+{
+    if (chans == 0)
+        return;
+    iq8_sc32n_scalar(iq, out, chans, 0, bytes / (2 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16N
+static inline
+void xtrxdsp_iq8_ic16n_template(const int8_t *__restrict iq,
+                                int16_t *const *__restrict out,
+                                unsigned chans,
+                                size_t bytes)
+{
+    if (chans == 0)
+        return;
+    iq8_ic16n_scalar(iq, out, chans, 0, bytes / (2 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_SC32N_IQ16
+static inline
+void xtrxdsp_sc32n_iq16_template(const float *const *__restrict in,
+                                 unsigned chans,
+                                 int16_t *__restrict out,
+                                 float scale,
+                                 size_t outbytes)
+{
+    if (chans == 0)
+        return;
+    sc32n_iq16_scalar(in, chans, out, scale, 0, outbytes / (4 * chans));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16N_IQ16
+static inline
+void xtrxdsp_ic16n_iq16_template(const int16_t *const *__restrict in,
+                                 unsigned chans,
+                                 int16_t *__restrict out,
+                                 size_t outbytes)
+{
+    if (chans == 0)
+        return;
+    ic16n_iq16_scalar(in, chans, out, 0, outbytes / (4 * chans));
+}
+#endif
+
+/* iq16 sample is a 32 bit lane, so 4 frames of 4 channels are a 4x4 transpose;
+ * 8 channels are two independent 4 channel groups. Other counts go scalar.
+ * iq8 and iq12 samples are widened to the same 32 bit lanes first
+ */
+#if defined(XTRXDSP_TEMPLATE_IQ16_SC32N_SSE2) || defined(XTRXDSP_TEMPLATE_IQ16_IC16N_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ12_SC32N_SSE2) || defined(XTRXDSP_TEMPLATE_IQ8_SC32N_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_IQ8_IC16N_SSE2) || \
+    defined(XTRXDSP_TEMPLATE_SC32N_IQ16_SSE2) || defined(XTRXDSP_TEMPLATE_IC16N_IQ16_SSE2)
+static inline
+void transpose4_epi32(__m128i *r0, __m128i *r1, __m128i *r2, __m128i *r3)
+{
+    __m128i t0 = _mm_unpacklo_epi32(*r0, *r1);
+    __m128i t1 = _mm_unpacklo_epi32(*r2, *r3);
+    __m128i t2 = _mm_unpackhi_epi32(*r0, *r1);
+    __m128i t3 = _mm_unpackhi_epi32(*r2, *r3);
+
+    *r0 = _mm_unpacklo_epi64(t0, t1);
+    *r1 = _mm_unpackhi_epi64(t0, t1);
+    *r2 = _mm_unpacklo_epi64(t2, t3);
+    *r3 = _mm_unpackhi_epi64(t2, t3);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_SC32N_SSE2
+static inline
+void xtrxdsp_iq16_sc32n_template(const int16_t *__restrict iq,
+                                 float *const *__restrict out,
+                                 unsigned chans,
+                                 float scale,
+                                 size_t bytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = bytes / (4 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_loadu_si128((const __m128i*)(iq + 2 * (chans * (f + k) + g)));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++) {
+                    _mm_storeu_ps(out[g + k] + 2 * f,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(r[k], r[k]), 16)), vscale));
+                    _mm_storeu_ps(out[g + k] + 2 * f + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(r[k], r[k]), 16)), vscale));
+                }
+            }
+        }
+    }
+
+    iq16_sc32n_scalar(iq, out, chans, scale, f, frames);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ16_IC16N_SSE2
+static inline
+void xtrxdsp_iq16_ic16n_template(const int16_t *__restrict iq,
+                                 int16_t *const *__restrict out,
+                                 unsigned chans,
+                                 size_t bytes)
+{
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = bytes / (4 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_loadu_si128((const __m128i*)(iq + 2 * (chans * (f + k) + g)));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++)
+                    _mm_storeu_si128((__m128i*)(out[g + k] + 2 * f), r[k]);
+            }
+        }
+    }
+
+    iq16_ic16n_scalar(iq, out, chans, f, frames);
+}
+#endif
+
+/* 4 iq12 samples at ld, one 32 bit load each; a lane gets I in the low and
+ * Q in the high 16 bits, both scaled to iq16. Reads one byte past the last
+ * sample
+ */
+#if defined(XTRXDSP_TEMPLATE_IQ12_SC32N_SSE2)
+#include <string.h>
+
+static inline
+__m128i iq12_load4(const uint8_t *ld)
+{
+    uint32_t u0, u1, u2, u3;
+    __m128i u;
+
+    memcpy(&u0, ld,     4);
+    memcpy(&u1, ld + 3, 4);
+    memcpy(&u2, ld + 6, 4);
+    memcpy(&u3, ld + 9, 4);
+    u = _mm_set_epi32(u3, u2, u1, u0);
+
+    return _mm_or_si128(_mm_and_si128(_mm_slli_epi32(u, 4), _mm_set1_epi32(0x0000fff0)),
+                        _mm_and_si128(_mm_slli_epi32(u, 8), _mm_set1_epi32(0xfff00000)));
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ12_SC32N_SSE2
+static inline
+void xtrxdsp_iq12_sc32n_template(const void *__restrict iq,
+                                 float *const *__restrict out,
+                                 unsigned chans,
+                                 size_t inbytes)
+{
+    const uint8_t *ld = (const uint8_t *)iq;
+    const __m128 vscale = _mm_set1_ps(SCALE16);
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = inbytes / (3 * chans);
+    if (chans == 4 || chans == 8) {
+        /* the frame after the block covers the extra byte of the last load */
+        for (; f + 4 < frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = iq12_load4(ld + 3 * (chans * (f + k) + g));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++) {
+                    _mm_storeu_ps(out[g + k] + 2 * f,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(r[k], r[k]), 16)), vscale));
+                    _mm_storeu_ps(out[g + k] + 2 * f + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(r[k], r[k]), 16)), vscale));
+                }
+            }
+        }
+    }
+
+    iq12_sc32n_scalar(iq, out, chans, f, frames);
+}
+#endif
+
+/* iq8 bytes go to the high half of 16 bit words, i.e. the iq16 scale */
+#ifdef XTRXDSP_TEMPLATE_IQ8_SC32N_SSE2
+static inline
+void xtrxdsp_iq8_sc32n_template(const int8_t *__restrict iq,
+                                float *const *__restrict out,
+                                unsigned chans,
+                                size_t bytes)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 vscale = _mm_set1_ps(SCALE16);
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = bytes / (2 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_unpacklo_epi8(zero, _mm_loadl_epi64((const __m128i*)(iq + 2 * (chans * (f + k) + g))));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++) {
+                    _mm_storeu_ps(out[g + k] + 2 * f,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(r[k], r[k]), 16)), vscale));
+                    _mm_storeu_ps(out[g + k] + 2 * f + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(r[k], r[k]), 16)), vscale));
+                }
+            }
+        }
+    }
+
+    iq8_sc32n_scalar(iq, out, chans, f, frames);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IQ8_IC16N_SSE2
+static inline
+void xtrxdsp_iq8_ic16n_template(const int8_t *__restrict iq,
+                                int16_t *const *__restrict out,
+                                unsigned chans,
+                                size_t bytes)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = bytes / (2 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_unpacklo_epi8(zero, _mm_loadl_epi64((const __m128i*)(iq + 2 * (chans * (f + k) + g))));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++)
+                    _mm_storeu_si128((__m128i*)(out[g + k] + 2 * f), r[k]);
+            }
+        }
+    }
+
+    iq8_ic16n_scalar(iq, out, chans, f, frames);
+}
+#endif
+
+/* truncation as in the regular converter, packssdw saturates */
+#ifdef XTRXDSP_TEMPLATE_SC32N_IQ16_SSE2
+static inline
+void xtrxdsp_sc32n_iq16_template(const float *const *__restrict in,
+                                 unsigned chans,
+                                 int16_t *__restrict out,
+                                 float scale,
+                                 size_t outbytes)
+{
+    const __m128 vscale = _mm_set1_ps(scale);
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = outbytes / (4 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(in[g + k] + 2 * f),     vscale)),
+                                           _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(in[g + k] + 2 * f + 4), vscale)));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++)
+                    _mm_storeu_si128((__m128i*)(out + 2 * (chans * (f + k) + g)), r[k]);
+            }
+        }
+    }
+
+    sc32n_iq16_scalar(in, chans, out, scale, f, frames);
+}
+#endif
+
+#ifdef XTRXDSP_TEMPLATE_IC16N_IQ16_SSE2
+static inline
+void xtrxdsp_ic16n_iq16_template(const int16_t *const *__restrict in,
+                                 unsigned chans,
+                                 int16_t *__restrict out,
+                                 size_t outbytes)
+{
+    __m128i r[4];
+    size_t f = 0, frames;
+    unsigned g, k;
+
+    if (chans == 0)
+        return;
+
+    frames = outbytes / (4 * chans);
+    if (chans == 4 || chans == 8) {
+        for (; f + 4 <= frames; f += 4) {
+            for (g = 0; g < chans; g += 4) {
+                for (k = 0; k < 4; k++)
+                    r[k] = _mm_loadu_si128((const __m128i*)(in[g + k] + 2 * f));
+
+                transpose4_epi32(&r[0], &r[1], &r[2], &r[3]);
+
+                for (k = 0; k < 4; k++)
+                    _mm_storeu_si128((__m128i*)(out + 2 * (chans * (f + k) + g)), r[k]);
+            }
+        }
+    }
+
+    ic16n_iq16_scalar(in, chans, out, f, frames);
+}
+#endif
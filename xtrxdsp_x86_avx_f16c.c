@@ -0,0 +1,34 @@
+/*
+ * xtrxdsp avx_f16c optimization functions file
+ * Copyright (c) 2017 Sergey Kostanbaev <sergey.kostanbaev@fairwaves.co>
+ * For more information, please visit: http://xtrx.io
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "xtrxdsp.h"
+
+#if defined(__AVX__) && defined(__F16C__)
+
+#define UNALIGN_STORE
+
+#define XTRXDSP_TEMPLATE_IQ16_HC16_F16C
+#define XTRXDSP_TEMPLATE_HC16_IQ16_F16C
+
+#include "xtrxdsp_templates.c"
+
+DECLARE_IQ16_HC16_FUNC_TEMPLATE(avx_f16c)
+DECLARE_HC16_IQ16_FUNC_TEMPLATE(avx_f16c)
+
+#endif